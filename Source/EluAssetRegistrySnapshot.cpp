@@ -0,0 +1,204 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluAssetRegistrySnapshot.h"
+#include "EluProcessor.h"
+
+#include "PackageTools.h"
+#include "AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "Misc/CoreDelegates.h"
+
+
+FEluAssetRegistrySnapshot& FEluAssetRegistrySnapshot::Get()
+{
+	static FEluAssetRegistrySnapshot AssetRegistrySnapshot;
+	return AssetRegistrySnapshot;
+}
+
+FEluAssetRegistrySnapshot::FEluAssetRegistrySnapshot()
+{
+	EditorDir_Textures = UEluProcessor::EditorDir_Textures;
+	EditorDir_SimpleMaterials = UEluProcessor::EditorDir_SimpleMaterials;
+	EditorDir_HumanSkinMaterials = UEluProcessor::EditorDir_HumanSkinMaterials;
+	EditorDir_MaterialInstances = UEluProcessor::EditorDir_MaterialInstances;
+	bBuilt = false;
+
+	// Outlives every processor. Unsubscribes while the asset registry module is still loaded
+	FCoreDelegates::OnPreExit.AddRaw(this, &FEluAssetRegistrySnapshot::Reset);
+}
+
+void FEluAssetRegistrySnapshot::Build()
+{
+	if (bBuilt)
+	{
+		return;
+	}
+
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+
+	AddAssetsByPath(EditorDir_SimpleMaterials, AssetDataMap_SimpleMaterials);
+	AddAssetsByPath(EditorDir_HumanSkinMaterials, AssetDataMap_HumanSkinMaterials);
+	AddAssetsByPath(EditorDir_Textures, AssetDataMap_Textures);
+	AddAssetsByPath(EditorDir_MaterialInstances, AssetDataMap_MaterialInstances);
+
+	AssetAddedHandle = AssetRegistryModule.Get().OnAssetAdded().AddRaw(this, &FEluAssetRegistrySnapshot::OnAssetAdded);
+	AssetRemovedHandle = AssetRegistryModule.Get().OnAssetRemoved().AddRaw(this, &FEluAssetRegistrySnapshot::OnAssetRemoved);
+	AssetRenamedHandle = AssetRegistryModule.Get().OnAssetRenamed().AddRaw(this, &FEluAssetRegistrySnapshot::OnAssetRenamed);
+
+	bBuilt = true;
+
+	FString LogMessage = FString::Printf(TEXT("Asset registry snapshot built: %d textures, %d simple materials, %d human skin materials, %d material instances"),
+										 AssetDataMap_Textures.Num(), AssetDataMap_SimpleMaterials.Num(), AssetDataMap_HumanSkinMaterials.Num(), AssetDataMap_MaterialInstances.Num());
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+}
+
+void FEluAssetRegistrySnapshot::Reset()
+{
+	if (FModuleManager::Get().IsModuleLoaded("AssetRegistry"))
+	{
+		FAssetRegistryModule& AssetRegistryModule = FModuleManager::GetModuleChecked<FAssetRegistryModule>("AssetRegistry");
+		AssetRegistryModule.Get().OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistryModule.Get().OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistryModule.Get().OnAssetRenamed().Remove(AssetRenamedHandle);
+	}
+
+	AssetAddedHandle.Reset();
+	AssetRemovedHandle.Reset();
+	AssetRenamedHandle.Reset();
+
+	AssetDataMap_Textures.Empty();
+	AssetDataMap_SimpleMaterials.Empty();
+	AssetDataMap_HumanSkinMaterials.Empty();
+	AssetDataMap_MaterialInstances.Empty();
+
+	bBuilt = false;
+}
+
+bool FEluAssetRegistrySnapshot::IsBuilt() const
+{
+	return bBuilt;
+}
+
+const TMap<FName, FAssetData>& FEluAssetRegistrySnapshot::GetTextures() const
+{
+	return AssetDataMap_Textures;
+}
+
+const TMap<FName, FAssetData>& FEluAssetRegistrySnapshot::GetSimpleMaterials() const
+{
+	return AssetDataMap_SimpleMaterials;
+}
+
+const TMap<FName, FAssetData>& FEluAssetRegistrySnapshot::GetHumanSkinMaterials() const
+{
+	return AssetDataMap_HumanSkinMaterials;
+}
+
+const TMap<FName, FAssetData>& FEluAssetRegistrySnapshot::GetMaterialInstances() const
+{
+	return AssetDataMap_MaterialInstances;
+}
+
+const FAssetData* FEluAssetRegistrySnapshot::FindTexture(FName TextureName) const
+{
+	return AssetDataMap_Textures.Find(TextureName);
+}
+
+const FAssetData* FEluAssetRegistrySnapshot::FindParentMaterial(FName ParentMatName) const
+{
+	const FAssetData* AssetData = AssetDataMap_SimpleMaterials.Find(ParentMatName);
+	return AssetData ? AssetData : AssetDataMap_HumanSkinMaterials.Find(ParentMatName);
+}
+
+const FAssetData* FEluAssetRegistrySnapshot::FindMaterialInstance(FName MIConstantName) const
+{
+	return AssetDataMap_MaterialInstances.Find(MIConstantName);
+}
+
+TMap<FName, FAssetData>* FEluAssetRegistrySnapshot::FindAssetDataMap(FName PackagePath)
+{
+	FString PackagePathString = PackagePath.ToString();
+
+	auto IsUnderDir = [&PackagePathString](const FString& EditorDir)
+	{
+		return PackagePathString == EditorDir || PackagePathString.StartsWith(EditorDir + FString("/"));
+	};
+
+	if (IsUnderDir(EditorDir_Textures))
+	{
+		return &AssetDataMap_Textures;
+	}
+	else if (IsUnderDir(EditorDir_SimpleMaterials))
+	{
+		return &AssetDataMap_SimpleMaterials;
+	}
+	else if (IsUnderDir(EditorDir_HumanSkinMaterials))
+	{
+		return &AssetDataMap_HumanSkinMaterials;
+	}
+	else if (IsUnderDir(EditorDir_MaterialInstances))
+	{
+		return &AssetDataMap_MaterialInstances;
+	}
+
+	return nullptr;
+}
+
+void FEluAssetRegistrySnapshot::AddAssetsByPath(const FString& EditorDir, TMap<FName, FAssetData>& AssetDataMap)
+{
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+
+	TArray<FAssetData> AssetData_Temp;
+	FName EditorPathToAssets = FName(*PackageTools::SanitizePackageName(EditorDir));
+	AssetRegistryModule.Get().GetAssetsByPath(EditorPathToAssets, AssetData_Temp, true);
+
+	AssetDataMap.Reserve(AssetDataMap.Num() + AssetData_Temp.Num());
+	for (FAssetData& AssetData : AssetData_Temp)
+	{
+		FName AssetName = AssetData.AssetName;
+		AssetDataMap.Add(AssetName, MoveTemp(AssetData));
+	}
+}
+
+void FEluAssetRegistrySnapshot::OnAssetAdded(const FAssetData& AssetData)
+{
+	TMap<FName, FAssetData>* AssetDataMap = FindAssetDataMap(AssetData.PackagePath);
+	if (AssetDataMap)
+	{
+		AssetDataMap->Add(AssetData.AssetName, AssetData);
+	}
+}
+
+void FEluAssetRegistrySnapshot::OnAssetRemoved(const FAssetData& AssetData)
+{
+	TMap<FName, FAssetData>* AssetDataMap = FindAssetDataMap(AssetData.PackagePath);
+	if (!AssetDataMap)
+	{
+		return;
+	}
+
+	// Another asset with the same name may live in a different sub directory
+	const FAssetData* ExistingAssetData = AssetDataMap->Find(AssetData.AssetName);
+	if (ExistingAssetData && ExistingAssetData->ObjectPath == AssetData.ObjectPath)
+	{
+		AssetDataMap->Remove(AssetData.AssetName);
+	}
+}
+
+void FEluAssetRegistrySnapshot::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	FName OldPackagePath = FName(*FPackageName::GetLongPackagePath(FPackageName::ObjectPathToPackageName(OldObjectPath)));
+	FName OldAssetName = FName(*FPackageName::ObjectPathToObjectName(OldObjectPath));
+
+	TMap<FName, FAssetData>* OldAssetDataMap = FindAssetDataMap(OldPackagePath);
+	if (OldAssetDataMap)
+	{
+		const FAssetData* ExistingAssetData = OldAssetDataMap->Find(OldAssetName);
+		if (ExistingAssetData && ExistingAssetData->ObjectPath == FName(*OldObjectPath))
+		{
+			OldAssetDataMap->Remove(OldAssetName);
+		}
+	}
+
+	OnAssetAdded(AssetData);
+}
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetData.h"
+
+
+/**
+ * Asset data of textures, parent materials and material instances, keyed by asset name.
+ * Built once from the asset registry and kept current through its added/removed/renamed events, so it outlives batches and processors. Reset on engine pre exit.
+ */
+class RAIDERZASSETS_API FEluAssetRegistrySnapshot
+{
+public:
+
+	static FEluAssetRegistrySnapshot& Get();
+
+	/** Editor directories the snapshot is built from. Default to those of UEluProcessor, the benchmark points them at its synthetic content. Must be set before Build */
+	FString EditorDir_Textures;
+
+	FString EditorDir_SimpleMaterials;
+
+	FString EditorDir_HumanSkinMaterials;
+
+	FString EditorDir_MaterialInstances;
+
+	FEluAssetRegistrySnapshot();
+
+	/** Queries the asset registry on the first call only. Later calls return immediately */
+	void Build();
+
+	/** Unsubscribes from the asset registry and drops all asset data. The next Build queries the asset registry again, e.g., after the editor directories changed */
+	void Reset();
+
+	bool IsBuilt() const;
+
+	const TMap<FName, FAssetData>& GetTextures() const;
+
+	const TMap<FName, FAssetData>& GetSimpleMaterials() const;
+
+	const TMap<FName, FAssetData>& GetHumanSkinMaterials() const;
+
+	const TMap<FName, FAssetData>& GetMaterialInstances() const;
+
+	const FAssetData* FindTexture(FName TextureName) const;
+
+	/** Looks up simple materials first, then human skin materials */
+	const FAssetData* FindParentMaterial(FName ParentMatName) const;
+
+	const FAssetData* FindMaterialInstance(FName MIConstantName) const;
+
+private:
+
+	TMap<FName, FAssetData> AssetDataMap_Textures;
+
+	TMap<FName, FAssetData> AssetDataMap_SimpleMaterials;
+
+	TMap<FName, FAssetData> AssetDataMap_HumanSkinMaterials;
+
+	TMap<FName, FAssetData> AssetDataMap_MaterialInstances;
+
+	FDelegateHandle AssetAddedHandle;
+
+	FDelegateHandle AssetRemovedHandle;
+
+	FDelegateHandle AssetRenamedHandle;
+
+	bool bBuilt;
+
+	/** Returns the map that assets under PackagePath belong to, or nullptr if the path isn't tracked */
+	TMap<FName, FAssetData>* FindAssetDataMap(FName PackagePath);
+
+	void AddAssetsByPath(const FString& EditorDir, TMap<FName, FAssetData>& AssetDataMap);
+
+	void OnAssetAdded(const FAssetData& AssetData);
+
+	void OnAssetRemoved(const FAssetData& AssetData);
+
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+};
@@ -0,0 +1,238 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluBenchmarkCommandlet.h"
+#include "EluProcessor.h"
+#include "EluSyntheticCorpus.h"
+#include "EluErrorJournal.h"
+#include "EluPackageSaveQueue.h"
+#include "EluImportReport.h"
+#include "EluAssetRegistrySnapshot.h"
+
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMemory.h"
+#include "UObject/UObjectIterator.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+
+UEluBenchmarkCommandlet::UEluBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UEluBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString LogMessage;
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamsMap;
+	UCommandlet::ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+	FEluSyntheticCorpusSettings Settings;
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	FParse::Value(*Params, TEXT("Objects="), Settings.NumObjects);
+	FParse::Value(*Params, TEXT("Meshes="), Settings.NumMeshesPerObject);
+	FParse::Value(*Params, TEXT("Materials="), Settings.NumMaterialsPerObject);
+	FParse::Value(*Params, TEXT("Layers="), Settings.NumTextureLayers);
+	FParse::Value(*Params, TEXT("Textures="), Settings.NumTexturesPerLayer);
+	FParse::Value(*Params, TEXT("LODs="), Settings.NumLODs);
+	FParse::Value(*Params, TEXT("Animations="), Settings.NumAnimationsPerObject);
+	FParse::Value(*Params, TEXT("Resolution="), Settings.MeshResolution);
+
+	FString DirPath_Corpus = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir()) + UEluProcessor::DirName_SyntheticCorpus;
+	FParse::Value(*Params, TEXT("CorpusDir="), DirPath_Corpus);
+	FPaths::NormalizeDirectoryName(DirPath_Corpus);
+
+	FString DirPath_SyntheticModels = DirPath_Corpus + FString("/Model");
+
+	TArray<TPair<FString, double>> PhaseTimes;
+	double PhaseStartTime = FPlatformTime::Seconds();
+
+	FEluSyntheticCorpus Corpus(Settings);
+	TArray<FString> Paths_EluXml;
+	if (!Corpus.Generate(DirPath_SyntheticModels, Paths_EluXml))
+	{
+		return 1;
+	}
+
+	PhaseTimes.Emplace(FString("generate"), FPlatformTime::Seconds() - PhaseStartTime);
+	PhaseStartTime = FPlatformTime::Seconds();
+
+	// Textures and parent materials are looked up in the synthetic content only, so that the real content is neither used nor written
+	FEluAssetRegistrySnapshot& AssetRegistrySnapshot = FEluAssetRegistrySnapshot::Get();
+	AssetRegistrySnapshot.Reset();
+	AssetRegistrySnapshot.EditorDir_Textures = UEluProcessor::EditorDir_SyntheticTextures;
+	AssetRegistrySnapshot.EditorDir_SimpleMaterials = UEluProcessor::EditorDir_SyntheticSimpleMaterials;
+	AssetRegistrySnapshot.EditorDir_HumanSkinMaterials = UEluProcessor::EditorDir_SyntheticHumanSkinMaterials;
+	AssetRegistrySnapshot.EditorDir_MaterialInstances = UEluProcessor::EditorDir_SyntheticMaterialInstances;
+
+	Corpus.CreatePlaceholderAssets(Paths_EluXml);
+
+	PhaseTimes.Emplace(FString("placeholders"), FPlatformTime::Seconds() - PhaseStartTime);
+
+	// A fresh editor directory makes every mesh and animation import for real. Earlier runs aren't needed anymore
+	FString EditorDir_Models = UEluProcessor::EditorDir_SyntheticModels + FString("/Warm");
+	if (!Switches.Contains(TEXT("Warm")))
+	{
+		FString DirPath_EditorModels = FPackageName::LongPackageNameToFilename(UEluProcessor::EditorDir_SyntheticModels + FString("/"));
+		IFileManager::Get().DeleteDirectory(*DirPath_EditorModels, false, true);
+
+		EditorDir_Models = UEluProcessor::EditorDir_SyntheticModels + FString("/Run_") + FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
+	}
+
+	UEluProcessor* EluProcessor = NewObject<UEluProcessor>();
+	EluProcessor->AddToRoot();
+	EluProcessor->bUnattended = true;
+	EluProcessor->DefaultErrorPolicy = EEluErrorPolicy::Skip;
+	EluProcessor->bPersistentCaches = false;
+	FParse::Value(*Params, TEXT("MemoryBudgetMB="), EluProcessor->MemoryBudgetMB);
+	EluProcessor->bApplyFbxImportPresets = !Switches.Contains(TEXT("NoFbxPresets"));
+	EluProcessor->bGenerateSkeletalLODs = Switches.Contains(TEXT("SkeletalLODs"));
+	EluProcessor->DirPath_ModelsRoot = DirPath_SyntheticModels;
+	EluProcessor->EditorDir_ModelsRoot = EditorDir_Models;
+	EluProcessor->EditorDir_MIs = UEluProcessor::EditorDir_SyntheticMaterialInstances;
+	EluProcessor->FilePath_ErrorJournal = DirPath_Corpus + FString("/benchmark_errors.txt");
+	EluProcessor->FilePath_ImportReport = DirPath_Corpus + FString("/benchmark_import_report.json");
+	EluProcessor->FilePath_Checkpoint = DirPath_Corpus + FString("/benchmark_checkpoint.txt");
+
+	PhaseStartTime = FPlatformTime::Seconds();
+
+	EluProcessor->Initialize();
+
+	PhaseTimes.Emplace(FString("initialize"), FPlatformTime::Seconds() - PhaseStartTime);
+	PhaseStartTime = FPlatformTime::Seconds();
+
+	TArray<FString> Paths_EluXmlFilesLoaded;
+	EluProcessor->ImportEluModels(Paths_EluXml, Paths_EluXmlFilesLoaded);
+
+	double ImportTime = FPlatformTime::Seconds() - PhaseStartTime;
+	PhaseTimes.Emplace(FString("import"), ImportTime);
+	PhaseStartTime = FPlatformTime::Seconds();
+
+	UEluBenchmarkCommandlet::SaveImportedPackages(EditorDir_Models);
+
+	PhaseTimes.Emplace(FString("save"), FPlatformTime::Seconds() - PhaseStartTime);
+	PhaseStartTime = FPlatformTime::Seconds();
+
+	EluProcessor->Uninitialize();
+
+	PhaseTimes.Emplace(FString("uninitialize"), FPlatformTime::Seconds() - PhaseStartTime);
+
+	const FString* ReportFilePath = ParamsMap.Find(TEXT("Report"));
+	FString FilePath_Report = ReportFilePath ? *ReportFilePath : DirPath_Corpus + FString("/benchmark_report.json");
+	UEluBenchmarkCommandlet::WriteReport(FilePath_Report, Corpus, EluProcessor, Paths_EluXml.Num(), Paths_EluXmlFilesLoaded.Num(), PhaseTimes);
+
+	LogMessage = FString::Printf(TEXT("Imported %d of %d synthetic elu objects, %d meshes and %d animations in %.2f seconds: %.2f objects/sec, %.2f meshes/sec"),
+		Paths_EluXmlFilesLoaded.Num(), Paths_EluXml.Num(), EluProcessor->NumMeshesImported, EluProcessor->NumAnimationsImported, ImportTime,
+		ImportTime > 0.0 ? Paths_EluXmlFilesLoaded.Num() / ImportTime : 0.0, ImportTime > 0.0 ? EluProcessor->NumMeshesImported / ImportTime : 0.0);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	for (const TPair<FString, double>& PhaseTime : PhaseTimes)
+	{
+		LogMessage = FString::Printf(TEXT("    %-14s %8.3f seconds"), *PhaseTime.Key, PhaseTime.Value);
+		UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+	}
+
+	EluProcessor->RemoveFromRoot();
+
+	return Paths_EluXmlFilesLoaded.Num() == Paths_EluXml.Num() ? 0 : 1;
+}
+
+int32 UEluBenchmarkCommandlet::SaveImportedPackages(const FString& EditorDir)
+{
+	FEluPackageSaveQueue SaveQueue;
+
+	FString PackagePathPrefix = EditorDir + FString("/");
+	for (TObjectIterator<UPackage> PackageIt; PackageIt; ++PackageIt)
+	{
+		UPackage* Package = *PackageIt;
+		if (Package->IsDirty() && Package->GetName().StartsWith(PackagePathPrefix))
+		{
+			SaveQueue.Enqueue(Package);
+		}
+	}
+
+	return SaveQueue.Flush();
+}
+
+bool UEluBenchmarkCommandlet::WriteReport(const FString& FilePath_Report, const FEluSyntheticCorpus& Corpus, UEluProcessor* EluProcessor,
+										  int32 NumObjects, int32 NumObjectsLoaded, const TArray<TPair<FString, double>>& PhaseTimes)
+{
+	FString LogMessage;
+
+	double ImportTime = 0.0;
+	for (const TPair<FString, double>& PhaseTime : PhaseTimes)
+	{
+		if (PhaseTime.Key == FString("import"))
+		{
+			ImportTime = PhaseTime.Value;
+		}
+	}
+
+	FString ReportJson;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&ReportJson);
+
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteValue(TEXT("corpus"), Corpus.Settings.ToString());
+	JsonWriter->WriteValue(TEXT("editor_dir"), EluProcessor->EditorDir_ModelsRoot);
+	JsonWriter->WriteValue(TEXT("num_objects"), NumObjects);
+	JsonWriter->WriteValue(TEXT("num_objects_loaded"), NumObjectsLoaded);
+	JsonWriter->WriteValue(TEXT("num_meshes_imported"), EluProcessor->NumMeshesImported);
+	JsonWriter->WriteValue(TEXT("num_animations_imported"), EluProcessor->NumAnimationsImported);
+	JsonWriter->WriteValue(TEXT("objects_per_second"), ImportTime > 0.0 ? NumObjectsLoaded / ImportTime : 0.0);
+	JsonWriter->WriteValue(TEXT("meshes_per_second"), ImportTime > 0.0 ? EluProcessor->NumMeshesImported / ImportTime : 0.0);
+	JsonWriter->WriteValue(TEXT("memory_budget_mb"), EluProcessor->MemoryBudgetMB);
+	JsonWriter->WriteValue(TEXT("fbx_import_presets"), EluProcessor->bApplyFbxImportPresets);
+	JsonWriter->WriteValue(TEXT("skeletal_lods"), EluProcessor->bGenerateSkeletalLODs);
+	JsonWriter->WriteValue(TEXT("peak_used_physical_mb"), (double)(FPlatformMemory::GetStats().PeakUsedPhysical / (1024 * 1024)));
+
+	JsonWriter->WriteObjectStart(TEXT("phase_seconds"));
+	for (const TPair<FString, double>& PhaseTime : PhaseTimes)
+	{
+		JsonWriter->WriteValue(PhaseTime.Key, PhaseTime.Value);
+	}
+	JsonWriter->WriteObjectEnd();
+
+	// Where the import phase itself spent its time, see FEluImportReport
+	FEluObjectImportRecord ImportTotals = FEluImportReport::Get().GetTotals();
+	JsonWriter->WriteObjectStart(TEXT("import_phase_seconds"));
+	for (int32 PhaseIndex = 0; PhaseIndex < (int32)EEluImportPhase::Num; PhaseIndex++)
+	{
+		JsonWriter->WriteValue(FEluImportReport::GetPhaseName((EEluImportPhase)PhaseIndex), ImportTotals.PhaseSeconds[PhaseIndex]);
+	}
+	JsonWriter->WriteValue(TEXT("untracked"), ImportTotals.GetUntrackedSeconds());
+	JsonWriter->WriteObjectEnd();
+
+	int32 NumMeshes = ImportTotals.Counts[(int32)EEluImportCounter::Meshes];
+	JsonWriter->WriteValue(TEXT("fbx_import_seconds_per_mesh"), NumMeshes > 0 ? ImportTotals.PhaseSeconds[(int32)EEluImportPhase::FbxImport] / NumMeshes : 0.0);
+
+	JsonWriter->WriteObjectStart(TEXT("errors"));
+	for (const TPair<EEluErrorKind, int32>& ErrorCountPair : EluProcessor->ErrorCounts)
+	{
+		JsonWriter->WriteValue(FEluErrorRecord::GetErrorKindName(ErrorCountPair.Key), ErrorCountPair.Value);
+	}
+	JsonWriter->WriteObjectEnd();
+
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+
+	bool bResult = FFileHelper::SaveStringToFile(ReportJson, *FilePath_Report);
+	if (!bResult)
+	{
+		LogMessage = FString("Unable to write benchmark report: ") + FilePath_Report;
+		UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+	}
+
+	return bResult;
+}
@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "EluBenchmarkCommandlet.generated.h"
+
+
+/**
+ * Generates a synthetic elu corpus and imports it end to end, to measure import throughput without the real model tree:
+ *
+ * UE4Editor-Cmd.exe RaiderZAssets.uproject -run=EluBenchmark [-Seed=1] [-Objects=20] [-Meshes=2] [-Materials=4] [-Layers=3]
+ *     [-Textures=16] [-LODs=3] [-Animations=3] [-Resolution=16] [-MemoryBudgetMB=<MB>] [-NoFbxPresets] [-SkeletalLODs] [-Warm] [-CorpusDir=<dir>] [-Report=<file>]
+ *
+ * The corpus, and the reports unless -Report is given, are written to -CorpusDir, which defaults to Saved/EluBenchmark of the project.
+ * Every run imports into a new editor directory, unless -Warm is given, in which case runs share one directory and every run
+ * after the first measures the up-to-date checks. Placeholder textures, parent materials and material instances are created under
+ * /Game/EluSynthetic as well, never next to the real content, and are kept between runs either way.
+ * -NoFbxPresets imports with the default options of the fbx factories instead of UEluProcessor::FbxImportPresets,
+ * the difference in fbx import seconds per mesh between two runs is the work the presets save.
+ * Logs and writes a json report of objects/sec, meshes/sec and the time spent in each phase.
+ */
+UCLASS()
+class RAIDERZASSETS_API UEluBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UEluBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer);
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	/** Saves the dirty packages under EditorDir, the way the editor would once the import is done. Returns the number of packages saved */
+	static int32 SaveImportedPackages(const FString& EditorDir);
+
+	static bool WriteReport(const FString& FilePath_Report, const class FEluSyntheticCorpus& Corpus, class UEluProcessor* EluProcessor,
+							int32 NumObjects, int32 NumObjectsLoaded, const TArray<TPair<FString, double>>& PhaseTimes);
+
+};
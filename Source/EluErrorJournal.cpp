@@ -0,0 +1,221 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluErrorJournal.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+
+
+FEluErrorRecord::FEluErrorRecord()
+{
+	ErrorKind = EEluErrorKind::Unknown;
+}
+
+FString FEluErrorRecord::ToLine() const
+{
+	// Tabs and line breaks inside fields would break the line format
+	auto SanitizeField = [](const FString& Field)
+	{
+		return Field.Replace(TEXT("\t"), TEXT(" ")).Replace(TEXT("\r"), TEXT(" ")).Replace(TEXT("\n"), TEXT(" "));
+	};
+
+	return FString(FEluErrorRecord::GetErrorKindName(ErrorKind)) + FString("\t") +
+		SanitizeField(FilePath_EluXml) + FString("\t") +
+		SanitizeField(MeshName) + FString("\t") +
+		SanitizeField(MaterialName) + FString("\t") +
+		SanitizeField(ErrorMessage);
+}
+
+const TCHAR* FEluErrorRecord::GetErrorKindName(EEluErrorKind ErrorKind)
+{
+	switch (ErrorKind)
+	{
+	case EEluErrorKind::MeshCastFailed:
+		return TEXT("MeshCastFailed");
+	case EEluErrorKind::MaterialSlotUnresolved:
+		return TEXT("MaterialSlotUnresolved");
+	case EEluErrorKind::MaterialSlotAmbiguous:
+		return TEXT("MaterialSlotAmbiguous");
+	case EEluErrorKind::MaterialInstanceMissing:
+		return TEXT("MaterialInstanceMissing");
+	case EEluErrorKind::ParentMaterialMissing:
+		return TEXT("ParentMaterialMissing");
+	case EEluErrorKind::MaterialParametersFailed:
+		return TEXT("MaterialParametersFailed");
+	case EEluErrorKind::HumanMeshNotSkeletal:
+		return TEXT("HumanMeshNotSkeletal");
+	case EEluErrorKind::UnsupportedModelType:
+		return TEXT("UnsupportedModelType");
+	case EEluErrorKind::TextureMissing:
+		return TEXT("TextureMissing");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+FEluErrorJournal& FEluErrorJournal::Get()
+{
+	static FEluErrorJournal ErrorJournal;
+	return ErrorJournal;
+}
+
+FEluErrorJournal::FEluErrorJournal()
+{
+	FlushIntervalEntries = 64;
+	FlushIntervalSeconds = 5.0;
+	LastFlushTime = 0.0;
+}
+
+FEluErrorJournal::~FEluErrorJournal()
+{
+	Close();
+}
+
+void FEluErrorJournal::Open(const FString& InFilePath_Journal)
+{
+	FScopeLock Lock(&CriticalSection);
+	OpenInternal(InFilePath_Journal);
+}
+
+void FEluErrorJournal::Close()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	FlushInternal();
+	Writer.Reset();
+	KnownEntries.Empty();
+}
+
+bool FEluErrorJournal::Add(const FEluErrorRecord& ErrorRecord)
+{
+	FString Line = ErrorRecord.ToLine();
+
+	FScopeLock Lock(&CriticalSection);
+
+	if (!Writer)
+	{
+		OpenInternal(FilePath_Journal.IsEmpty() ? UEluProcessor::FilePath_ErrorFile : FilePath_Journal);
+	}
+
+	bool bAlreadyInSet = false;
+	KnownEntries.Add(Line, &bAlreadyInSet);
+	if (bAlreadyInSet)
+	{
+		return false;
+	}
+
+	PendingEntries.Add(Line);
+
+	if (PendingEntries.Num() >= FlushIntervalEntries || FPlatformTime::Seconds() - LastFlushTime >= FlushIntervalSeconds)
+	{
+		FlushInternal();
+	}
+
+	return true;
+}
+
+void FEluErrorJournal::Flush()
+{
+	FScopeLock Lock(&CriticalSection);
+	FlushInternal();
+}
+
+int32 FEluErrorJournal::Num() const
+{
+	FScopeLock Lock(&CriticalSection);
+	return KnownEntries.Num();
+}
+
+int32 FEluErrorJournal::Merge(const FString& FilePath_OtherJournal)
+{
+	TArray<FString> OtherEntries;
+	if (!FFileHelper::LoadFileToStringArray(OtherEntries, *FilePath_OtherJournal))
+	{
+		return 0;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+
+	if (!Writer)
+	{
+		OpenInternal(FilePath_Journal.IsEmpty() ? UEluProcessor::FilePath_ErrorFile : FilePath_Journal);
+	}
+
+	int32 NumAdded = 0;
+	for (const FString& OtherEntry : OtherEntries)
+	{
+		bool bAlreadyInSet = false;
+		KnownEntries.Add(OtherEntry, &bAlreadyInSet);
+		if (!bAlreadyInSet && !OtherEntry.IsEmpty())
+		{
+			PendingEntries.Add(OtherEntry);
+			NumAdded++;
+		}
+	}
+
+	FlushInternal();
+
+	return NumAdded;
+}
+
+void FEluErrorJournal::OpenInternal(const FString& InFilePath_Journal)
+{
+	FString LogMessage;
+
+	FlushInternal();
+	Writer.Reset();
+	KnownEntries.Empty();
+
+	FilePath_Journal = InFilePath_Journal;
+	LastFlushTime = FPlatformTime::Seconds();
+
+	// Existing entries are read once, so that errors recorded by previous runs are not duplicated
+	TArray<uint8> FileData;
+	if (FFileHelper::LoadFileToArray(FileData, *FilePath_Journal, FILEREAD_Silent) && FileData.Num() > 0)
+	{
+		FString FileContent;
+		FFileHelper::BufferToString(FileContent, FileData.GetData(), FileData.Num());
+
+		TArray<FString> ExistingEntries;
+		FileContent.ParseIntoArrayLines(ExistingEntries);
+		KnownEntries.Append(ExistingEntries);
+
+		// Older error files may have been saved as UTF-16, which can't be appended to as UTF-8
+		bool bUtf16 = FileData.Num() >= 2 && ((FileData[0] == 0xFF && FileData[1] == 0xFE) || (FileData[0] == 0xFE && FileData[1] == 0xFF));
+		if (bUtf16)
+		{
+			FFileHelper::SaveStringArrayToFile(ExistingEntries, *FilePath_Journal, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+		}
+	}
+
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*FilePath_Journal, FILEWRITE_Append | FILEWRITE_AllowRead));
+	if (!Writer)
+	{
+		LogMessage = FString("Unable to open error journal: ") + FilePath_Journal;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+	}
+}
+
+void FEluErrorJournal::FlushInternal()
+{
+	LastFlushTime = FPlatformTime::Seconds();
+
+	if (!Writer || PendingEntries.Num() == 0)
+	{
+		return;
+	}
+
+	FString PendingText;
+	for (const FString& PendingEntry : PendingEntries)
+	{
+		PendingText += PendingEntry;
+		PendingText += LINE_TERMINATOR;
+	}
+	PendingEntries.Empty();
+
+	FTCHARToUTF8 PendingTextUtf8(*PendingText);
+	Writer->Serialize(const_cast<ANSICHAR*>(PendingTextUtf8.Get()), PendingTextUtf8.Length());
+	Writer->Flush();
+}
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EluProcessor.h"
+#include "HAL/CriticalSection.h"
+
+
+struct RAIDERZASSETS_API FEluErrorRecord
+{
+	EEluErrorKind ErrorKind;
+
+	FString FilePath_EluXml;
+
+	FString MeshName;
+
+	FString MaterialName;
+
+	FString ErrorMessage;
+
+	FEluErrorRecord();
+
+	/** Tab separated line: kind, elu.xml, mesh, material, message */
+	FString ToLine() const;
+
+	static const TCHAR* GetErrorKindName(EEluErrorKind ErrorKind);
+};
+
+
+/**
+ * Append-only error log shared by the whole import. Entries are de-duplicated in memory and written through a buffered file writer.
+ * Safe to call from any thread.
+ */
+class RAIDERZASSETS_API FEluErrorJournal
+{
+public:
+
+	/** Pending entries are written to disk once there are this many of them... */
+	int32 FlushIntervalEntries;
+
+	/** ...or once this many seconds passed since the last flush */
+	double FlushIntervalSeconds;
+
+	static FEluErrorJournal& Get();
+
+	FEluErrorJournal();
+
+	~FEluErrorJournal();
+
+	void Open(const FString& InFilePath_Journal);
+
+	void Close();
+
+	/** Returns false if the same entry was already recorded */
+	bool Add(const FEluErrorRecord& ErrorRecord);
+
+	void Flush();
+
+	/** Adds the entries of another journal file that aren't recorded yet, e.g., the journal of an import worker. Returns the number of entries added */
+	int32 Merge(const FString& FilePath_OtherJournal);
+
+	int32 Num() const;
+
+private:
+
+	mutable FCriticalSection CriticalSection;
+
+	FString FilePath_Journal;
+
+	TSet<FString> KnownEntries;
+
+	TArray<FString> PendingEntries;
+
+	TUniquePtr<FArchive> Writer;
+
+	double LastFlushTime;
+
+	void OpenInternal(const FString& InFilePath_Journal);
+
+	void FlushInternal();
+
+};
@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluFbxImportPreset.h"
+#include "EluProcessor.h"
+
+#include "Animation/Skeleton.h"
+#include "Factories/FbxImportUI.h"
+#include "Factories/FbxStaticMeshImportData.h"
+#include "Factories/FbxSkeletalMeshImportData.h"
+
+
+FEluSkeletalLODSettings::FEluSkeletalLODSettings()
+{
+	TrianglePercentage = 1.0f;
+	NumLeafBoneLevelsToRemove = 0;
+	ScreenSize = 0.5f;
+}
+
+FEluSkeletalLODSettings::FEluSkeletalLODSettings(float InTrianglePercentage, int32 InNumLeafBoneLevelsToRemove, float InScreenSize)
+{
+	TrianglePercentage = InTrianglePercentage;
+	NumLeafBoneLevelsToRemove = InNumLeafBoneLevelsToRemove;
+	ScreenSize = InScreenSize;
+}
+
+FEluFbxImportPreset::FEluFbxImportPreset()
+{
+	NormalImportMethod = FBXNIM_ImportNormalsAndTangents;
+	bGenerateLightmapUVs = false;
+	bAutoGenerateCollision = false;
+	bBuildAdjacencyBuffer = false;
+	bBuildReversedIndexBuffer = false;
+	bReuseSkeleton = true;
+	bCreatePhysicsAsset = false;
+	bImportMorphTargets = false;
+}
+
+float FEluFbxImportPreset::GetLODScreenSize(int32 LODIndex) const
+{
+	if (LODIndex <= 0 || LODScreenSizes.Num() == 0)
+	{
+		return 1.0f;
+	}
+
+	int32 LastIndex = LODScreenSizes.Num() - 1;
+	return LODScreenSizes[FMath::Min(LODIndex - 1, LastIndex)] * FMath::Pow(0.5f, (float)FMath::Max(LODIndex - 1 - LastIndex, 0));
+}
+
+void FEluFbxImportPreset::ApplyToStaticMesh(UFbxImportUI* ImportUI) const
+{
+	check(ImportUI);
+
+	ImportUI->bImportMaterials = false;
+	ImportUI->bImportTextures = false;
+
+	UFbxStaticMeshImportData* StaticMeshImportData = ImportUI->StaticMeshImportData;
+	StaticMeshImportData->NormalImportMethod = NormalImportMethod;
+	StaticMeshImportData->NormalGenerationMethod = EFBXNormalGenerationMethod::MikkTSpace;
+	StaticMeshImportData->bGenerateLightmapUVs = bGenerateLightmapUVs;
+	StaticMeshImportData->bAutoGenerateCollision = bAutoGenerateCollision;
+	StaticMeshImportData->bBuildAdjacencyBuffer = bBuildAdjacencyBuffer;
+	StaticMeshImportData->bBuildReversedIndexBuffer = bBuildReversedIndexBuffer;
+	StaticMeshImportData->bRemoveDegenerates = true;
+}
+
+void FEluFbxImportPreset::ApplyToSkeletalMesh(UFbxImportUI* ImportUI, USkeleton* Skeleton) const
+{
+	check(ImportUI);
+
+	ImportUI->bImportMaterials = false;
+	ImportUI->bImportTextures = false;
+	ImportUI->Skeleton = bReuseSkeleton ? Skeleton : nullptr;
+	ImportUI->bCreatePhysicsAsset = bCreatePhysicsAsset;
+	ImportUI->PhysicsAsset = nullptr;
+
+	UFbxSkeletalMeshImportData* SkeletalMeshImportData = ImportUI->SkeletalMeshImportData;
+	SkeletalMeshImportData->NormalImportMethod = NormalImportMethod;
+	SkeletalMeshImportData->NormalGenerationMethod = EFBXNormalGenerationMethod::MikkTSpace;
+	SkeletalMeshImportData->bImportMorphTargets = bImportMorphTargets;
+}
+
+FString FEluFbxImportPreset::ToString() const
+{
+	const TCHAR* NormalImportMethodName = TEXT("ComputeNormals");
+	if (NormalImportMethod == FBXNIM_ImportNormals)
+	{
+		NormalImportMethodName = TEXT("ImportNormals");
+	}
+	else if (NormalImportMethod == FBXNIM_ImportNormalsAndTangents)
+	{
+		NormalImportMethodName = TEXT("ImportNormalsAndTangents");
+	}
+
+	FString LODScreenSizesString = LODScreenSizes.Num() > 0 ? FString() : FString("Auto");
+	for (float LODScreenSize : LODScreenSizes)
+	{
+		LODScreenSizesString += FString::Printf(TEXT("%s%.3f"), LODScreenSizesString.IsEmpty() ? TEXT("") : TEXT(","), LODScreenSize);
+	}
+
+	FString SkeletalLODsString = SkeletalLODs.Num() > 0 ? FString() : FString("None");
+	for (const FEluSkeletalLODSettings& SkeletalLOD : SkeletalLODs)
+	{
+		SkeletalLODsString += FString::Printf(TEXT("%s%.0f%%/-%d/%.3f"), SkeletalLODsString.IsEmpty() ? TEXT("") : TEXT(","),
+			SkeletalLOD.TrianglePercentage * 100.0f, SkeletalLOD.NumLeafBoneLevelsToRemove, SkeletalLOD.ScreenSize);
+	}
+
+	return FString::Printf(TEXT("Normals=%s LightmapUVs=%d Collision=%d Adjacency=%d ReversedIndices=%d ReuseSkeleton=%d PhysicsAsset=%d MorphTargets=%d LODScreenSizes=%s SkeletalLODs=%s"),
+		NormalImportMethodName, bGenerateLightmapUVs, bAutoGenerateCollision, bBuildAdjacencyBuffer, bBuildReversedIndexBuffer,
+		bReuseSkeleton, bCreatePhysicsAsset, bImportMorphTargets, *LODScreenSizesString, *SkeletalLODsString);
+}
+
+void FEluFbxImportPreset::GetDefaultPresets(TMap<EEluModelType, FEluFbxImportPreset>& OutPresets)
+{
+	OutPresets.Empty();
+
+	// Placed in levels: statically lit, collidable and possibly mirrored
+	FEluFbxImportPreset MapObjectPreset;
+	MapObjectPreset.bGenerateLightmapUVs = true;
+	MapObjectPreset.bAutoGenerateCollision = true;
+	MapObjectPreset.bBuildReversedIndexBuffer = true;
+	MapObjectPreset.LODScreenSizes.Add(0.5f);
+	MapObjectPreset.LODScreenSizes.Add(0.25f);
+	MapObjectPreset.LODScreenSizes.Add(0.1f);
+	OutPresets.Add(EEluModelType::MapObject, MapObjectPreset);
+
+	// Never lit by lightmaps, never collided with
+	FEluFbxImportPreset SkyPreset;
+	SkyPreset.NormalImportMethod = FBXNIM_ImportNormals;
+	OutPresets.Add(EEluModelType::Sky, SkyPreset);
+
+	FEluFbxImportPreset WeaponPreset;
+	OutPresets.Add(EEluModelType::Weapon, WeaponPreset);
+
+	// Creatures get a physics asset for hit detection and ragdolls. Their parts share one skeleton.
+	// They are seen from far away in numbers, so they get the deepest LOD chain
+	FEluFbxImportPreset CreaturePreset;
+	CreaturePreset.bCreatePhysicsAsset = true;
+	CreaturePreset.SkeletalLODs.Add(FEluSkeletalLODSettings(0.5f, 0, 0.5f));
+	CreaturePreset.SkeletalLODs.Add(FEluSkeletalLODSettings(0.25f, 1, 0.25f));
+	CreaturePreset.SkeletalLODs.Add(FEluSkeletalLODSettings(0.1f, 2, 0.1f));
+	OutPresets.Add(EEluModelType::Monster, CreaturePreset);
+	OutPresets.Add(EEluModelType::NPC, CreaturePreset);
+	OutPresets.Add(EEluModelType::Ride, CreaturePreset);
+
+	// Every armor part of a human model is a mesh of its own, rendered on the body's skeleton. A physics asset per part is wasted
+	FEluFbxImportPreset HumanPreset;
+	OutPresets.Add(EEluModelType::Female, HumanPreset);
+	OutPresets.Add(EEluModelType::Male, HumanPreset);
+}
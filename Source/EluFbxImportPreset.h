@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Factories/FbxMeshImportData.h"
+
+
+enum class EEluModelType : uint8;
+
+
+/** One generated LOD of a skeletal mesh, see UEluProcessor::GenerateSkeletalMeshLODs */
+struct RAIDERZASSETS_API FEluSkeletalLODSettings
+{
+	/** Share of the LOD0 triangles the LOD keeps, 0 to 1 */
+	float TrianglePercentage;
+
+	/** Levels of bones removed from the tips of the bone hierarchy, e.g., 1 removes every leaf bone. Bones with sockets are kept */
+	int32 NumLeafBoneLevelsToRemove;
+
+	float ScreenSize;
+
+	FEluSkeletalLODSettings();
+
+	FEluSkeletalLODSettings(float InTrianglePercentage, int32 InNumLeafBoneLevelsToRemove, float InScreenSize);
+};
+
+
+/**
+ * Fbx import options of one elu model type, applied to the fbx factories before each mesh import.
+ * Materials and textures are never imported, CreateAndApply*MeshMaterials replaces every slot with a material instance anyway.
+ * In the editor the preset only fills in the defaults of the options dialog.
+ */
+struct RAIDERZASSETS_API FEluFbxImportPreset
+{
+	/** Import normals and tangents when the fbx files have them, instead of computing them again. Missing tangents are still computed */
+	EFBXNormalImportMethod NormalImportMethod;
+
+	/** Static meshes only */
+	bool bGenerateLightmapUVs;
+
+	bool bAutoGenerateCollision;
+
+	/** Only needed by tessellated materials */
+	bool bBuildAdjacencyBuffer;
+
+	/** Only needed by mirrored instances, i.e., placed map objects */
+	bool bBuildReversedIndexBuffer;
+
+	/** Skeletal meshes only. Binds every skeletal mesh of an elu object to the first skeleton found for it instead of creating one per mesh */
+	bool bReuseSkeleton;
+
+	bool bCreatePhysicsAsset;
+
+	bool bImportMorphTargets;
+
+	/** Screen sizes of static mesh LOD 1 and up. Further LODs halve the last one. Empty lets the engine compute them */
+	TArray<float> LODScreenSizes;
+
+	FEluFbxImportPreset();
+
+	float GetLODScreenSize(int32 LODIndex) const;
+
+	/** LOD 1 and up generated for skeletal meshes, if UEluProcessor::bGenerateSkeletalLODs is set */
+	TArray<FEluSkeletalLODSettings> SkeletalLODs;
+
+	void ApplyToStaticMesh(class UFbxImportUI* ImportUI) const;
+
+	/** Skeleton is the one to reuse, nullptr creates a new one */
+	void ApplyToSkeletalMesh(class UFbxImportUI* ImportUI, class USkeleton* Skeleton) const;
+
+	/** Printable form of the preset, for the import log */
+	FString ToString() const;
+
+	static void GetDefaultPresets(TMap<EEluModelType, FEluFbxImportPreset>& OutPresets);
+};
@@ -0,0 +1,337 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluFbxPrefilter.h"
+
+#include "FbxImporter.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+const uint32 FEluFbxPrefilter::CacheFileMagic = 0x454C4650;	// 'ELFP'
+// Version 1 caches may hold Invalid verdicts, which aren't cached anymore. Version 3 adds the animation stacks, version 4 the bones of every file
+const int32 FEluFbxPrefilter::CacheFileVersion = 4;
+
+
+FEluFbxSceneInfo::FEluFbxSceneInfo()
+{
+	SceneKind = EEluFbxSceneKind::Invalid;
+	NumNodes = 0;
+	NumMeshes = 0;
+	NumSkinnedMeshes = 0;
+	NumVertices = 0;
+	NumAnimStacks = 0;
+	bAnimationsRead = false;
+	NumAnimKeys = 0;
+}
+
+bool FEluFbxSceneInfo::HasMesh() const
+{
+	return SceneKind == EEluFbxSceneKind::StaticMesh || SceneKind == EEluFbxSceneKind::SkinnedMesh;
+}
+
+bool FEluFbxSceneInfo::IsKnownToHaveNoMesh() const
+{
+	return SceneKind == EEluFbxSceneKind::Empty || SceneKind == EEluFbxSceneKind::AnimationOnly;
+}
+
+FArchive& operator<<(FArchive& Ar, FEluFbxSceneInfo& SceneInfo)
+{
+	uint8 SceneKind = (uint8)SceneInfo.SceneKind;
+	Ar << SceneKind;
+	SceneInfo.SceneKind = (EEluFbxSceneKind)SceneKind;
+
+	Ar << SceneInfo.NumNodes;
+	Ar << SceneInfo.NumMeshes;
+	Ar << SceneInfo.NumSkinnedMeshes;
+	Ar << SceneInfo.NumVertices;
+	Ar << SceneInfo.NumAnimStacks;
+	Ar << SceneInfo.bAnimationsRead;
+	Ar << SceneInfo.NumAnimKeys;
+	Ar << SceneInfo.RootBoneName;
+	Ar << SceneInfo.BoneNames;
+	Ar << SceneInfo.BoneParentNames;
+	return Ar;
+}
+
+FEluFbxPrefilter::FEluFbxPrefilter()
+{
+	bDirty = false;
+}
+
+bool FEluFbxPrefilter::LoadFromFile(const FString& FilePath_Cache)
+{
+	FString LogMessage;
+	Empty();
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *FilePath_Cache, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Ar(FileData);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Ar << Magic;
+	Ar << Version;
+
+	if (Magic != CacheFileMagic || Version != CacheFileVersion)
+	{
+		LogMessage = FString("Discarding outdated fbx prefilter cache: ") + FilePath_Cache;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		return false;
+	}
+
+	Ar << SceneInfos;
+
+	if (Ar.IsError())
+	{
+		LogMessage = FString("Fbx prefilter cache is corrupted: ") + FilePath_Cache;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		Empty();
+		return false;
+	}
+
+	return true;
+}
+
+bool FEluFbxPrefilter::SaveToFile(const FString& FilePath_Cache)
+{
+	if (!bDirty)
+	{
+		return true;
+	}
+
+	TArray<uint8> FileData;
+	FMemoryWriter Ar(FileData);
+
+	uint32 Magic = CacheFileMagic;
+	int32 Version = CacheFileVersion;
+	Ar << Magic;
+	Ar << Version;
+	Ar << SceneInfos;
+
+	bool bResult = FFileHelper::SaveArrayToFile(FileData, *FilePath_Cache);
+	if (bResult)
+	{
+		bDirty = false;
+	}
+
+	return bResult;
+}
+
+void FEluFbxPrefilter::Empty()
+{
+	SceneInfos.Empty();
+	bDirty = false;
+}
+
+void FEluFbxPrefilter::ClassifyFiles(const TArray<FString>& FilePaths_Fbx, const TMap<FString, FMD5Hash>& FileHashes, bool bReadAnimations)
+{
+	FString LogMessage;
+
+	// Files with identical content share one verdict, so each distinct hash is inspected once
+	TArray<FString> FilePathsToInspect;
+	TArray<FString> HashKeysToInspect;
+	for (const FString& FilePath_Fbx : FilePaths_Fbx)
+	{
+		const FMD5Hash* FileHash = FileHashes.Find(FilePath_Fbx);
+		if (!FileHash || !FileHash->IsValid())
+		{
+			continue;
+		}
+
+		FString HashKey = LexToString(*FileHash);
+		const FEluFbxSceneInfo* CachedSceneInfo = SceneInfos.Find(HashKey);
+		if ((!CachedSceneInfo || (bReadAnimations && !CachedSceneInfo->bAnimationsRead)) && !HashKeysToInspect.Contains(HashKey))
+		{
+			FilePathsToInspect.Add(FilePath_Fbx);
+			HashKeysToInspect.Add(HashKey);
+		}
+	}
+
+	if (FilePathsToInspect.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FEluFbxSceneInfo> InspectedSceneInfos;
+	InspectedSceneInfos.SetNum(FilePathsToInspect.Num());
+	ParallelFor(FilePathsToInspect.Num(), [&FilePathsToInspect, &InspectedSceneInfos, bReadAnimations](int32 Index)
+	{
+		InspectedSceneInfos[Index] = FEluFbxPrefilter::InspectFbxFile(FilePathsToInspect[Index], bReadAnimations);
+	});
+
+	int32 NumUnimportable = 0;
+	int32 NumInvalid = 0;
+	for (int32 Index = 0; Index < FilePathsToInspect.Num(); Index++)
+	{
+		const FEluFbxSceneInfo& SceneInfo = InspectedSceneInfos[Index];
+		if (SceneInfo.SceneKind == EEluFbxSceneKind::Invalid)
+		{
+			// The fbx sdk may have failed for reasons that don't last, e.g., the file being written or memory running short
+			NumInvalid++;
+			continue;
+		}
+
+		if (!SceneInfo.HasMesh())
+		{
+			NumUnimportable++;
+		}
+
+		SceneInfos.Add(HashKeysToInspect[Index], SceneInfo);
+		bDirty = true;
+	}
+
+	LogMessage = FString::Printf(TEXT("Fbx prefilter inspected %d files, %d of them contain no mesh, %d couldn't be read"), FilePathsToInspect.Num(), NumUnimportable, NumInvalid);
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+}
+
+const FEluFbxSceneInfo* FEluFbxPrefilter::FindSceneInfo(const FMD5Hash& FileHash) const
+{
+	if (!FileHash.IsValid())
+	{
+		return nullptr;
+	}
+
+	return SceneInfos.Find(LexToString(FileHash));
+}
+
+FEluFbxSceneInfo FEluFbxPrefilter::InspectFbxFile(const FString& FilePath_Fbx, bool bReadAnimations)
+{
+	FEluFbxSceneInfo SceneInfo;
+
+	// An FbxManager must not be shared between threads, so every call creates its own
+	FbxManager* SdkManager = FbxManager::Create();
+	if (!SdkManager)
+	{
+		return SceneInfo;
+	}
+
+	// Only the scene graph and, if asked for, the animation curves are read. Materials and textures are left alone
+	FbxIOSettings* IOSettings = FbxIOSettings::Create(SdkManager, IOSROOT);
+	IOSettings->SetBoolProp(IMP_FBX_MATERIAL, false);
+	IOSettings->SetBoolProp(IMP_FBX_TEXTURE, false);
+	IOSettings->SetBoolProp(IMP_FBX_ANIMATION, bReadAnimations);
+	SdkManager->SetIOSettings(IOSettings);
+
+	FbxImporter* Importer = FbxImporter::Create(SdkManager, "");
+	if (Importer->Initialize(TCHAR_TO_UTF8(*FilePath_Fbx), -1, IOSettings))
+	{
+		// Animation stacks are listed in the file header, they don't have to be imported to be counted
+		SceneInfo.NumAnimStacks = Importer->GetAnimStackCount();
+
+		FbxScene* Scene = FbxScene::Create(SdkManager, "");
+		if (Importer->Import(Scene))
+		{
+			SceneInfo.NumNodes = Scene->GetNodeCount();
+
+			for (int32 MeshIndex = 0; MeshIndex < Scene->GetSrcObjectCount<FbxMesh>(); MeshIndex++)
+			{
+				FbxMesh* Mesh = Scene->GetSrcObject<FbxMesh>(MeshIndex);
+				if (!Mesh || Mesh->GetNodeCount() == 0 || Mesh->GetControlPointsCount() == 0)
+				{
+					continue;
+				}
+
+				SceneInfo.NumMeshes++;
+				SceneInfo.NumVertices += Mesh->GetControlPointsCount();
+				if (Mesh->GetDeformerCount(FbxDeformer::eSkin) > 0)
+				{
+					SceneInfo.NumSkinnedMeshes++;
+				}
+			}
+
+			// Bones tell whether a skinned mesh fits the skeleton of another mesh, and which skeleton an animation is meant for
+			for (int32 NodeIndex = 0; NodeIndex < Scene->GetNodeCount(); NodeIndex++)
+			{
+				FbxNode* Node = Scene->GetNode(NodeIndex);
+				if (!Node->GetSkeleton())
+				{
+					continue;
+				}
+
+				FName BoneName = FName(UTF8_TO_TCHAR(Node->GetName()));
+				bool bRootBone = !Node->GetParent() || !Node->GetParent()->GetSkeleton();
+				SceneInfo.BoneNames.Add(BoneName);
+				SceneInfo.BoneParentNames.Add(bRootBone ? NAME_None : FName(UTF8_TO_TCHAR(Node->GetParent()->GetName())));
+				if (SceneInfo.RootBoneName.IsNone() && bRootBone)
+				{
+					SceneInfo.RootBoneName = BoneName;
+				}
+			}
+
+			if (bReadAnimations)
+			{
+				for (int32 StackIndex = 0; StackIndex < Scene->GetSrcObjectCount<FbxAnimStack>(); StackIndex++)
+				{
+					FbxAnimStack* AnimStack = Scene->GetSrcObject<FbxAnimStack>(StackIndex);
+					for (int32 LayerIndex = 0; LayerIndex < AnimStack->GetMemberCount<FbxAnimLayer>(); LayerIndex++)
+					{
+						FbxAnimLayer* AnimLayer = AnimStack->GetMember<FbxAnimLayer>(LayerIndex);
+						for (int32 NodeIndex = 0; NodeIndex < Scene->GetNodeCount(); NodeIndex++)
+						{
+							FbxNode* Node = Scene->GetNode(NodeIndex);
+							FbxPropertyT<FbxDouble3>* Properties[] = { &Node->LclTranslation, &Node->LclRotation, &Node->LclScaling };
+							for (FbxPropertyT<FbxDouble3>* Property : Properties)
+							{
+								const char* Components[] = { FBXSDK_CURVENODE_COMPONENT_X, FBXSDK_CURVENODE_COMPONENT_Y, FBXSDK_CURVENODE_COMPONENT_Z };
+								for (const char* Component : Components)
+								{
+									FbxAnimCurve* AnimCurve = Property->GetCurve(AnimLayer, Component);
+									SceneInfo.NumAnimKeys += AnimCurve ? AnimCurve->KeyGetCount() : 0;
+								}
+							}
+						}
+					}
+				}
+
+				SceneInfo.bAnimationsRead = true;
+			}
+
+			if (SceneInfo.NumSkinnedMeshes > 0)
+			{
+				SceneInfo.SceneKind = EEluFbxSceneKind::SkinnedMesh;
+			}
+			else if (SceneInfo.NumMeshes > 0)
+			{
+				SceneInfo.SceneKind = EEluFbxSceneKind::StaticMesh;
+			}
+			else if (SceneInfo.NumAnimStacks > 0)
+			{
+				SceneInfo.SceneKind = EEluFbxSceneKind::AnimationOnly;
+			}
+			else
+			{
+				SceneInfo.SceneKind = EEluFbxSceneKind::Empty;
+			}
+		}
+	}
+
+	Importer->Destroy();
+	SdkManager->Destroy();
+
+	return SceneInfo;
+}
+
+const TCHAR* FEluFbxPrefilter::GetSceneKindName(EEluFbxSceneKind SceneKind)
+{
+	switch (SceneKind)
+	{
+	case EEluFbxSceneKind::Invalid:
+		return TEXT("Invalid");
+	case EEluFbxSceneKind::Empty:
+		return TEXT("Empty");
+	case EEluFbxSceneKind::StaticMesh:
+		return TEXT("StaticMesh");
+	case EEluFbxSceneKind::SkinnedMesh:
+		return TEXT("SkinnedMesh");
+	case EEluFbxSceneKind::AnimationOnly:
+		return TEXT("AnimationOnly");
+	default:
+		return TEXT("Unknown");
+	}
+}
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+
+
+enum class EEluFbxSceneKind : uint8
+{
+	/** The fbx sdk couldn't open or read the file */
+	Invalid,
+	/** No mesh with vertices and no animation */
+	Empty,
+	StaticMesh,
+	SkinnedMesh,
+	/** No mesh with vertices, but at least one animation stack */
+	AnimationOnly,
+};
+
+
+struct RAIDERZASSETS_API FEluFbxSceneInfo
+{
+	EEluFbxSceneKind SceneKind;
+
+	int32 NumNodes;
+
+	int32 NumMeshes;
+
+	int32 NumSkinnedMeshes;
+
+	int32 NumVertices;
+
+	int32 NumAnimStacks;
+
+	/** Whether the animation stacks were read, i.e., whether NumAnimKeys is filled. Only animation files are read that way */
+	bool bAnimationsRead;
+
+	/** Keys on the translation, rotation and scale curves of every animation stack */
+	int32 NumAnimKeys;
+
+	/** First skeleton node whose parent isn't one. Read for every file */
+	FName RootBoneName;
+
+	/** Skeleton nodes of the scene, i.e., the bones of a skinned mesh or those the animations are meant for */
+	TArray<FName> BoneNames;
+
+	/** Parent of each of BoneNames, None for bones whose parent isn't a skeleton node */
+	TArray<FName> BoneParentNames;
+
+	FEluFbxSceneInfo();
+
+	/** Returns true if the file can produce a mesh asset. Rigid meshes can be imported as skeletal meshes as well, so skinning isn't required */
+	bool HasMesh() const;
+
+	/** Returns true if the file was read and holds no mesh. Files the fbx sdk couldn't read are left to the fbx factories, the failure may not last */
+	bool IsKnownToHaveNoMesh() const;
+
+	friend FArchive& operator<<(FArchive& Ar, FEluFbxSceneInfo& SceneInfo);
+};
+
+
+/**
+ * Classifies fbx files (empty, static, skinned, animation only) on worker threads ahead of the import, so that the game thread
+ * never creates packages for files that can't produce an asset, and reads the bones animation files are meant for. Verdicts are cached by the hash of the file content.
+ */
+class RAIDERZASSETS_API FEluFbxPrefilter
+{
+public:
+
+	FEluFbxPrefilter();
+
+	bool LoadFromFile(const FString& FilePath_Cache);
+
+	bool SaveToFile(const FString& FilePath_Cache);
+
+	void Empty();
+
+	/**
+	 * Inspects, in parallel, every file whose hash has no cached verdict yet. FileHashes must contain the hash of every file in FilePaths_Fbx.
+	 * Invalid verdicts aren't cached, so files that couldn't be read are inspected again by the next batch.
+	 * With bReadAnimations, the animation stacks and bones are read as well, and verdicts cached without them are inspected again
+	 */
+	void ClassifyFiles(const TArray<FString>& FilePaths_Fbx, const TMap<FString, FMD5Hash>& FileHashes, bool bReadAnimations = false);
+
+	/** Returns the cached verdict for a file with the given content hash, or nullptr if it hasn't been classified */
+	const FEluFbxSceneInfo* FindSceneInfo(const FMD5Hash& FileHash) const;
+
+	/** Opens the fbx file with its own fbx sdk manager. Safe to call from any thread */
+	static FEluFbxSceneInfo InspectFbxFile(const FString& FilePath_Fbx, bool bReadAnimations = false);
+
+	static const TCHAR* GetSceneKindName(EEluFbxSceneKind SceneKind);
+
+private:
+
+	static const uint32 CacheFileMagic;
+
+	static const int32 CacheFileVersion;
+
+	/** Hex encoded file hash -> scene info */
+	TMap<FString, FEluFbxSceneInfo> SceneInfos;
+
+	bool bDirty;
+
+};
@@ -0,0 +1,362 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluFileIndex.h"
+
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+const uint32 FEluFileIndex::IndexFileMagic = 0x454C5849;	// 'ELXI'
+const int32 FEluFileIndex::IndexFileVersion = 1;
+
+
+FEluIndexedFile::FEluIndexedFile()
+{
+	FileSize = 0;
+}
+
+FArchive& operator<<(FArchive& Ar, FEluIndexedFile& IndexedFile)
+{
+	Ar << IndexedFile.FileName;
+	Ar << IndexedFile.FileSize;
+	Ar << IndexedFile.TimeStamp;
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FEluIndexedDirectory& IndexedDirectory)
+{
+	Ar << IndexedDirectory.TimeStamp;
+	Ar << IndexedDirectory.SubDirNames;
+	Ar << IndexedDirectory.Files;
+	return Ar;
+}
+
+FEluFileIndex::FEluFileIndex()
+{
+	bDirty = false;
+}
+
+bool FEluFileIndex::LoadFromFile(const FString& FilePath_Index)
+{
+	FString LogMessage;
+	Empty();
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *FilePath_Index, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Ar(FileData);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Ar << Magic;
+	Ar << Version;
+
+	if (Magic != IndexFileMagic || Version != IndexFileVersion)
+	{
+		LogMessage = FString("Discarding outdated elu file index: ") + FilePath_Index;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		return false;
+	}
+
+	Ar << DirPath_Root;
+	Ar << Directories;
+
+	if (Ar.IsError())
+	{
+		LogMessage = FString("Elu file index is corrupted: ") + FilePath_Index;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		Empty();
+		return false;
+	}
+
+	return true;
+}
+
+bool FEluFileIndex::SaveToFile(const FString& FilePath_Index)
+{
+	if (!bDirty)
+	{
+		return true;
+	}
+
+	TArray<uint8> FileData;
+	FMemoryWriter Ar(FileData);
+
+	uint32 Magic = IndexFileMagic;
+	int32 Version = IndexFileVersion;
+	Ar << Magic;
+	Ar << Version;
+	Ar << DirPath_Root;
+	Ar << Directories;
+
+	bool bResult = FFileHelper::SaveArrayToFile(FileData, *FilePath_Index);
+	if (bResult)
+	{
+		bDirty = false;
+	}
+
+	return bResult;
+}
+
+void FEluFileIndex::Refresh(const FString& InDirPath_Root)
+{
+	FString LogMessage;
+	IFileManager& FileManager = IFileManager::Get();
+
+	FString NewDirPath_Root = FEluFileIndex::NormalizeDirPath(InDirPath_Root);
+	if (NewDirPath_Root != DirPath_Root)
+	{
+		Directories.Empty();
+		DirPath_Root = NewDirPath_Root;
+		bDirty = true;
+	}
+
+	int32 NumDirsScanned = 0;
+	int32 NumDirsReused = 0;
+
+	TMap<FString, FEluIndexedDirectory> RefreshedDirectories;
+	RefreshedDirectories.Reserve(Directories.Num());
+	DirPaths_Unstatted.Empty();
+
+	TArray<FString> PendingDirPaths;
+	PendingDirPaths.Add(DirPath_Root);
+
+	while (PendingDirPaths.Num() > 0)
+	{
+		FString DirPath = PendingDirPaths.Pop(false);
+
+		FFileStatData DirStatData = FileManager.GetStatData(*DirPath);
+		if (!DirStatData.bIsValid || !DirStatData.bIsDirectory)
+		{
+			continue;
+		}
+
+		FEluIndexedDirectory& IndexedDirectory = RefreshedDirectories.Add(DirPath);
+		FEluIndexedDirectory* CachedDirectory = Directories.Find(DirPath);
+
+		// A directory's mtime only changes when entries are added, removed or renamed inside it,
+		// so an unchanged mtime means the cached list of entries is still valid. The sizes and mtimes of the files are not, see RestatDirectories.
+		if (CachedDirectory && CachedDirectory->TimeStamp == DirStatData.ModificationTime)
+		{
+			IndexedDirectory = MoveTemp(*CachedDirectory);
+			DirPaths_Unstatted.Add(DirPath);
+			NumDirsReused++;
+		}
+		else
+		{
+			FEluFileIndex::ScanDirectory(DirPath, IndexedDirectory);
+			IndexedDirectory.TimeStamp = DirStatData.ModificationTime;
+			NumDirsScanned++;
+		}
+
+		for (const FString& SubDirName : IndexedDirectory.SubDirNames)
+		{
+			PendingDirPaths.Add(DirPath + FString("/") + SubDirName);
+		}
+	}
+
+	if (NumDirsScanned > 0 || RefreshedDirectories.Num() != Directories.Num())
+	{
+		bDirty = true;
+	}
+
+	Directories = MoveTemp(RefreshedDirectories);
+
+	LogMessage = FString::Printf(TEXT("Elu file index refreshed for %s. Directories scanned: %d, directories reused: %d"),
+								 *DirPath_Root, NumDirsScanned, NumDirsReused);
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+}
+
+void FEluFileIndex::RestatDirectories(const TArray<FString>& DirPaths)
+{
+	for (const FString& DirPath : DirPaths)
+	{
+		FString NormalizedDirPath = FEluFileIndex::NormalizeDirPath(DirPath);
+		if (DirPaths_Unstatted.Remove(NormalizedDirPath) == 0)
+		{
+			continue;
+		}
+
+		FEluIndexedDirectory* IndexedDirectory = Directories.Find(NormalizedDirPath);
+		if (IndexedDirectory && FEluFileIndex::RestatFiles(NormalizedDirPath, *IndexedDirectory))
+		{
+			bDirty = true;
+		}
+	}
+}
+
+void FEluFileIndex::Empty()
+{
+	DirPath_Root.Empty();
+	Directories.Empty();
+	DirPaths_Unstatted.Empty();
+	bDirty = false;
+}
+
+bool FEluFileIndex::IsEmpty() const
+{
+	return Directories.Num() == 0;
+}
+
+bool FEluFileIndex::IsIndexedPath(const FString& DirPath) const
+{
+	if (DirPath_Root.IsEmpty())
+	{
+		return false;
+	}
+
+	FString NormalizedDirPath = FEluFileIndex::NormalizeDirPath(DirPath);
+	return NormalizedDirPath == DirPath_Root || NormalizedDirPath.StartsWith(DirPath_Root + FString("/"));
+}
+
+const FEluIndexedDirectory* FEluFileIndex::FindDirectory(const FString& DirPath) const
+{
+	return Directories.Find(FEluFileIndex::NormalizeDirPath(DirPath));
+}
+
+const FEluIndexedFile* FEluFileIndex::FindFile(const FString& FilePath) const
+{
+	FString NormalizedFilePath = FilePath;
+	FPaths::NormalizeFilename(NormalizedFilePath);
+
+	const FEluIndexedDirectory* IndexedDirectory = FindDirectory(FPaths::GetPath(NormalizedFilePath));
+	if (!IndexedDirectory)
+	{
+		return nullptr;
+	}
+
+	FString FileName = FPaths::GetCleanFilename(NormalizedFilePath);
+	return IndexedDirectory->Files.FindByPredicate([&FileName](const FEluIndexedFile& IndexedFile)
+	{
+		return IndexedFile.FileName == FileName;
+	});
+}
+
+bool FEluFileIndex::FindFiles(TArray<FString>& OutFileNames, const FString& DirPath, const FString& Extension) const
+{
+	if (!IsIndexedPath(DirPath))
+	{
+		return false;
+	}
+
+	// A missing directory inside the indexed tree simply has no files
+	const FEluIndexedDirectory* IndexedDirectory = FindDirectory(DirPath);
+	if (IndexedDirectory)
+	{
+		for (const FEluIndexedFile& IndexedFile : IndexedDirectory->Files)
+		{
+			if (FPaths::GetExtension(IndexedFile.FileName) == Extension)
+			{
+				OutFileNames.Add(IndexedFile.FileName);
+			}
+		}
+	}
+
+	return true;
+}
+
+void FEluFileIndex::FindFilesRecursively(TArray<FString>& OutFilePaths, const FString& Suffix) const
+{
+	for (const TPair<FString, FEluIndexedDirectory>& DirectoryPair : Directories)
+	{
+		for (const FEluIndexedFile& IndexedFile : DirectoryPair.Value.Files)
+		{
+			if (IndexedFile.FileName.EndsWith(Suffix))
+			{
+				OutFilePaths.Add(DirectoryPair.Key + FString("/") + IndexedFile.FileName);
+			}
+		}
+	}
+}
+
+FString FEluFileIndex::NormalizeDirPath(const FString& DirPath)
+{
+	FString NormalizedDirPath = DirPath;
+	FPaths::NormalizeDirectoryName(NormalizedDirPath);
+	return NormalizedDirPath;
+}
+
+void FEluFileIndex::ScanDirectory(const FString& DirPath, FEluIndexedDirectory& OutIndexedDirectory)
+{
+	struct FIndexingVisitor : public IPlatformFile::FDirectoryStatVisitor
+	{
+		FEluIndexedDirectory& IndexedDirectory;
+
+		FIndexingVisitor(FEluIndexedDirectory& InIndexedDirectory) : IndexedDirectory(InIndexedDirectory)
+		{
+		}
+
+		virtual bool Visit(const TCHAR* FilenameOrDirectory, const FFileStatData& StatData) override
+		{
+			FString EntryName = FPaths::GetCleanFilename(FilenameOrDirectory);
+
+			if (StatData.bIsDirectory)
+			{
+				IndexedDirectory.SubDirNames.Add(EntryName);
+			}
+			else
+			{
+				FEluIndexedFile IndexedFile;
+				IndexedFile.FileName = EntryName;
+				IndexedFile.FileSize = StatData.FileSize;
+				IndexedFile.TimeStamp = StatData.ModificationTime;
+				IndexedDirectory.Files.Add(IndexedFile);
+			}
+
+			return true;
+		}
+	};
+
+	OutIndexedDirectory.SubDirNames.Empty();
+	OutIndexedDirectory.Files.Empty();
+
+	FIndexingVisitor Visitor(OutIndexedDirectory);
+	IFileManager::Get().IterateDirectoryStat(*DirPath, Visitor);
+}
+
+bool FEluFileIndex::RestatFiles(const FString& DirPath, FEluIndexedDirectory& InOutIndexedDirectory)
+{
+	struct FRestatVisitor : public IPlatformFile::FDirectoryStatVisitor
+	{
+		TMap<FString, FEluIndexedFile*> FilesByName;
+
+		bool bChanged;
+
+		FRestatVisitor(FEluIndexedDirectory& InIndexedDirectory) : bChanged(false)
+		{
+			FilesByName.Reserve(InIndexedDirectory.Files.Num());
+			for (FEluIndexedFile& IndexedFile : InIndexedDirectory.Files)
+			{
+				FilesByName.Add(IndexedFile.FileName, &IndexedFile);
+			}
+		}
+
+		virtual bool Visit(const TCHAR* FilenameOrDirectory, const FFileStatData& StatData) override
+		{
+			if (StatData.bIsDirectory)
+			{
+				return true;
+			}
+
+			FEluIndexedFile** IndexedFile = FilesByName.Find(FPaths::GetCleanFilename(FilenameOrDirectory));
+			if (IndexedFile && ((*IndexedFile)->FileSize != StatData.FileSize || (*IndexedFile)->TimeStamp != StatData.ModificationTime))
+			{
+				(*IndexedFile)->FileSize = StatData.FileSize;
+				(*IndexedFile)->TimeStamp = StatData.ModificationTime;
+				bChanged = true;
+			}
+
+			return true;
+		}
+	};
+
+	FRestatVisitor Visitor(InOutIndexedDirectory);
+	IFileManager::Get().IterateDirectoryStat(*DirPath, Visitor);
+	return Visitor.bChanged;
+}
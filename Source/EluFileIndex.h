@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+struct RAIDERZASSETS_API FEluIndexedFile
+{
+	FString FileName;
+
+	int64 FileSize;
+
+	FDateTime TimeStamp;
+
+	FEluIndexedFile();
+
+	friend FArchive& operator<<(FArchive& Ar, FEluIndexedFile& IndexedFile);
+};
+
+
+struct RAIDERZASSETS_API FEluIndexedDirectory
+{
+	/** Modification time of the directory itself, used to detect added/removed/renamed entries */
+	FDateTime TimeStamp;
+
+	TArray<FString> SubDirNames;
+
+	TArray<FEluIndexedFile> Files;
+
+	friend FArchive& operator<<(FArchive& Ar, FEluIndexedDirectory& IndexedDirectory);
+};
+
+
+/**
+ * On-disk index of the RaiderZ model tree (directory -> files with sizes and mtimes).
+ * Built with one walk over the tree, and refreshed by re-listing only those directories whose mtime changed.
+ * Rewriting a file in place does not touch its directory's mtime, so the files of unchanged directories must be re-stat'ed
+ * with RestatDirectories before their sizes and mtimes are trusted. Only the directories a batch actually reads are.
+ */
+class RAIDERZASSETS_API FEluFileIndex
+{
+public:
+
+	FEluFileIndex();
+
+	bool LoadFromFile(const FString& FilePath_Index);
+
+	bool SaveToFile(const FString& FilePath_Index);
+
+	void Refresh(const FString& InDirPath_Root);
+
+	/** Updates the sizes and mtimes of the files of the given directories, unless they were listed or re-stat'ed since the last Refresh */
+	void RestatDirectories(const TArray<FString>& DirPaths);
+
+	void Empty();
+
+	bool IsEmpty() const;
+
+	/** Returns true if DirPath lies inside the indexed tree, i.e., if the index is authoritative for DirPath. */
+	bool IsIndexedPath(const FString& DirPath) const;
+
+	const FEluIndexedDirectory* FindDirectory(const FString& DirPath) const;
+
+	const FEluIndexedFile* FindFile(const FString& FilePath) const;
+
+	/**
+	 * Fills OutFileNames with the names of files inside DirPath that have the given extension.
+	 * Returns false if DirPath is not covered by the index, in which case the caller should query the file system itself.
+	 */
+	bool FindFiles(TArray<FString>& OutFileNames, const FString& DirPath, const FString& Extension) const;
+
+	/** Fills OutFilePaths with the full paths of all indexed files whose name ends with Suffix, e.g., ".elu.xml" */
+	void FindFilesRecursively(TArray<FString>& OutFilePaths, const FString& Suffix) const;
+
+private:
+
+	static const uint32 IndexFileMagic;
+
+	static const int32 IndexFileVersion;
+
+	FString DirPath_Root;
+
+	TMap<FString, FEluIndexedDirectory> Directories;
+
+	/** Directories Refresh reused without listing them, whose file sizes and mtimes may be outdated */
+	TSet<FString> DirPaths_Unstatted;
+
+	bool bDirty;
+
+	static FString NormalizeDirPath(const FString& DirPath);
+
+	static void ScanDirectory(const FString& DirPath, FEluIndexedDirectory& OutIndexedDirectory);
+
+	/** Updates the sizes and mtimes of the already listed files of a directory. Returns true if any of them changed. */
+	static bool RestatFiles(const FString& DirPath, FEluIndexedDirectory& InOutIndexedDirectory);
+
+};
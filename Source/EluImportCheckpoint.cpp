@@ -0,0 +1,253 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluImportCheckpoint.h"
+#include "EluProcessor.h"
+#include "EluFileIndex.h"
+
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Misc/SecureHash.h"
+#include "HAL/FileManager.h"
+#include "UObject/Package.h"
+
+
+FEluCheckpointEntry::FEluCheckpointEntry()
+{
+	Status = EEluCheckpointStatus::Skipped;
+}
+
+FEluImportCheckpoint::FEluImportCheckpoint()
+{
+}
+
+FEluImportCheckpoint::~FEluImportCheckpoint()
+{
+	Close();
+}
+
+bool FEluImportCheckpoint::Open(const FString& InFilePath_Checkpoint, bool bResume)
+{
+	FString LogMessage;
+
+	Close();
+	FilePath_Checkpoint = InFilePath_Checkpoint;
+
+	FString CheckpointText;
+	bool bTornLastLine = false;
+	if (bResume && FFileHelper::LoadFileToString(CheckpointText, *FilePath_Checkpoint))
+	{
+		TArray<FString> Lines;
+		CheckpointText.ParseIntoArrayLines(Lines);
+
+		// The last line is torn if the previous run died while writing it. It is dropped, since even a well formed one may have lost the end of its path
+		bTornLastLine = !CheckpointText.IsEmpty() && !CheckpointText.EndsWith(TEXT("\n"));
+		if (bTornLastLine && Lines.Num() > 0)
+		{
+			Lines.Pop();
+		}
+
+		for (const FString& Line : Lines)
+		{
+			TArray<FString> Fields;
+			Line.ParseIntoArray(Fields, TEXT("\t"), false);
+
+			FEluCheckpointEntry Entry;
+			if (Fields.Num() != 3 || !FEluImportCheckpoint::ParseStatusName(Fields[0], Entry.Status) || Fields[1].Len() != 32)
+			{
+				continue;
+			}
+
+			Entry.Fingerprint = Fields[1];
+			Entries.Add(Fields[2], Entry);
+		}
+
+		LogMessage = FString::Printf(TEXT("Resuming from import checkpoint with %d elu objects: "), Entries.Num()) + FilePath_Checkpoint;
+		UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+	}
+
+	uint32 WriteFlags = bResume ? (FILEWRITE_Append | FILEWRITE_AllowRead) : FILEWRITE_AllowRead;
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*FilePath_Checkpoint, WriteFlags));
+	if (!Writer)
+	{
+		LogMessage = FString("Unable to open import checkpoint: ") + FilePath_Checkpoint;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		return false;
+	}
+
+	// Otherwise the first line appended would be glued to the torn one, and both would be lost
+	if (bTornLastLine)
+	{
+		FTCHARToUTF8 LineTerminatorUtf8(LINE_TERMINATOR);
+		Writer->Serialize(const_cast<ANSICHAR*>(LineTerminatorUtf8.Get()), LineTerminatorUtf8.Length());
+		Writer->Flush();
+	}
+
+	return true;
+}
+
+void FEluImportCheckpoint::Close()
+{
+	FString LogMessage;
+
+	FlushSaved();
+	if (PendingEntries.Num() > 0)
+	{
+		LogMessage = FString::Printf(TEXT("%d imported elu objects were never saved and are left out of the import checkpoint"), PendingEntries.Num());
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+	}
+
+	Writer.Reset();
+	Entries.Empty();
+	PendingEntries.Empty();
+}
+
+bool FEluImportCheckpoint::IsOpen() const
+{
+	return Writer.IsValid();
+}
+
+void FEluImportCheckpoint::Record(const FString& FilePath_EluXml, EEluCheckpointStatus Status, const FString& Fingerprint)
+{
+	FEluCheckpointEntry Entry;
+	Entry.Status = Status;
+	Entry.Fingerprint = Fingerprint;
+	Entries.Add(FilePath_EluXml, Entry);
+
+	if (!Writer || Fingerprint.IsEmpty())
+	{
+		return;
+	}
+
+	FString Line = FString(FEluImportCheckpoint::GetStatusName(Status)) + FString("\t") + Fingerprint + FString("\t") + FilePath_EluXml + LINE_TERMINATOR;
+
+	// Flushed per elu object, the whole point is to survive a crash in the next one
+	FTCHARToUTF8 LineUtf8(*Line);
+	Writer->Serialize(const_cast<ANSICHAR*>(LineUtf8.Get()), LineUtf8.Length());
+	Writer->Flush();
+}
+
+void FEluImportCheckpoint::RecordWhenSaved(const FString& FilePath_EluXml, EEluCheckpointStatus Status, const FString& Fingerprint, const TArray<TWeakObjectPtr<UPackage>>& Packages)
+{
+	if (FEluImportCheckpoint::AreAllPackagesSaved(Packages))
+	{
+		Record(FilePath_EluXml, Status, Fingerprint);
+		return;
+	}
+
+	FEluPendingCheckpointEntry PendingEntry;
+	PendingEntry.FilePath_EluXml = FilePath_EluXml;
+	PendingEntry.Entry.Status = Status;
+	PendingEntry.Entry.Fingerprint = Fingerprint;
+	PendingEntry.Packages = Packages;
+	PendingEntries.Add(PendingEntry);
+}
+
+int32 FEluImportCheckpoint::FlushSaved()
+{
+	int32 NumRecorded = 0;
+	for (int32 Index = 0; Index < PendingEntries.Num(); )
+	{
+		const FEluPendingCheckpointEntry& PendingEntry = PendingEntries[Index];
+		if (!FEluImportCheckpoint::AreAllPackagesSaved(PendingEntry.Packages))
+		{
+			Index++;
+			continue;
+		}
+
+		Record(PendingEntry.FilePath_EluXml, PendingEntry.Entry.Status, PendingEntry.Entry.Fingerprint);
+		PendingEntries.RemoveAt(Index);
+		NumRecorded++;
+	}
+
+	return NumRecorded;
+}
+
+bool FEluImportCheckpoint::IsCompleted(const FString& FilePath_EluXml, const FString& Fingerprint) const
+{
+	const FEluCheckpointEntry* Entry = Entries.Find(FilePath_EluXml);
+	if (!Entry || Fingerprint.IsEmpty() || Entry->Fingerprint != Fingerprint)
+	{
+		return false;
+	}
+
+	return Entry->Status == EEluCheckpointStatus::Loaded || Entry->Status == EEluCheckpointStatus::Skipped;
+}
+
+int32 FEluImportCheckpoint::Num() const
+{
+	return Entries.Num();
+}
+
+FString FEluImportCheckpoint::ComputeFingerprint(const FEluFileIndex& FileIndex, const FString& FilePath_EluXml)
+{
+	const FEluIndexedFile* IndexedEluXml = FileIndex.FindFile(FilePath_EluXml);
+	if (!IndexedEluXml)
+	{
+		return FString();
+	}
+
+	FString FingerprintSource = FString::Printf(TEXT("%s:%lld:%lld;"), *IndexedEluXml->FileName, IndexedEluXml->FileSize, IndexedEluXml->TimeStamp.GetTicks());
+
+	// Same layout as FEluImportFilesInfo: the elu object directory is the parent of the elu.xml directory
+	FString DirPath_EluObject = FPaths::GetPath(FPaths::GetPath(FilePath_EluXml));
+	const FString DirNames_Source[] = { UEluProcessor::DirName_EluModels, UEluProcessor::DirName_EluAnimations };
+	for (const FString& DirName_Source : DirNames_Source)
+	{
+		const FEluIndexedDirectory* IndexedDirectory = FileIndex.FindDirectory(DirPath_EluObject + FString("/") + DirName_Source);
+		if (!IndexedDirectory)
+		{
+			continue;
+		}
+
+		FingerprintSource += DirName_Source + FString("/");
+		for (const FEluIndexedFile& IndexedFile : IndexedDirectory->Files)
+		{
+			FingerprintSource += FString::Printf(TEXT("%s:%lld:%lld;"), *IndexedFile.FileName, IndexedFile.FileSize, IndexedFile.TimeStamp.GetTicks());
+		}
+	}
+
+	return FMD5::HashAnsiString(*FingerprintSource);
+}
+
+const TCHAR* FEluImportCheckpoint::GetStatusName(EEluCheckpointStatus Status)
+{
+	switch (Status)
+	{
+	case EEluCheckpointStatus::Loaded:
+		return TEXT("Loaded");
+	case EEluCheckpointStatus::MaterialError:
+		return TEXT("MaterialError");
+	case EEluCheckpointStatus::Skipped:
+	default:
+		return TEXT("Skipped");
+	}
+}
+
+bool FEluImportCheckpoint::AreAllPackagesSaved(const TArray<TWeakObjectPtr<UPackage>>& Packages)
+{
+	for (const TWeakObjectPtr<UPackage>& WeakPackage : Packages)
+	{
+		UPackage* Package = WeakPackage.Get();
+		if (Package && Package->IsDirty())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FEluImportCheckpoint::ParseStatusName(const FString& StatusName, EEluCheckpointStatus& OutStatus)
+{
+	const EEluCheckpointStatus Statuses[] = { EEluCheckpointStatus::Loaded, EEluCheckpointStatus::MaterialError, EEluCheckpointStatus::Skipped };
+	for (EEluCheckpointStatus Status : Statuses)
+	{
+		if (StatusName == FEluImportCheckpoint::GetStatusName(Status))
+		{
+			OutStatus = Status;
+			return true;
+		}
+	}
+
+	return false;
+}
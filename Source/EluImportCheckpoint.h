@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+
+enum class EEluCheckpointStatus : uint8
+{
+	/** Imported, materials included */
+	Loaded,
+	/** Meshes were imported, but some of their materials couldn't be created or applied */
+	MaterialError,
+	/** The model type isn't supported, nothing was imported. Resumed runs don't retry it either */
+	Skipped,
+};
+
+
+struct RAIDERZASSETS_API FEluCheckpointEntry
+{
+	EEluCheckpointStatus Status;
+
+	/** Sizes and timestamps of the source files at the time the elu object was imported */
+	FString Fingerprint;
+
+	FEluCheckpointEntry();
+};
+
+
+struct RAIDERZASSETS_API FEluPendingCheckpointEntry
+{
+	FString FilePath_EluXml;
+
+	FEluCheckpointEntry Entry;
+
+	TArray<TWeakObjectPtr<UPackage>> Packages;
+};
+
+
+/**
+ * Durable record of the elu objects an import batch has finished, one line per elu object, flushed to disk right away.
+ * A batch that was interrupted by a crash or a cancel can be resumed from it: loaded and skipped elu objects whose source files didn't change
+ * are passed over without loading any of their packages. Elu objects with material errors are imported again.
+ */
+class RAIDERZASSETS_API FEluImportCheckpoint
+{
+public:
+
+	FEluImportCheckpoint();
+
+	~FEluImportCheckpoint();
+
+	/** With bResume, the entries written by earlier runs are kept and new ones are appended. Otherwise the file starts over */
+	bool Open(const FString& InFilePath_Checkpoint, bool bResume);
+
+	void Close();
+
+	bool IsOpen() const;
+
+	void Record(const FString& FilePath_EluXml, EEluCheckpointStatus Status, const FString& Fingerprint);
+
+	/** Records the elu object once all of its packages are saved, so that a resumed run never passes over imports that only lived in memory */
+	void RecordWhenSaved(const FString& FilePath_EluXml, EEluCheckpointStatus Status, const FString& Fingerprint, const TArray<TWeakObjectPtr<UPackage>>& Packages);
+
+	/** Records the pending elu objects whose packages have been saved since. Returns the number of elu objects recorded */
+	int32 FlushSaved();
+
+	/** True if an earlier run loaded or skipped the elu object, and its source files still have the same fingerprint */
+	bool IsCompleted(const FString& FilePath_EluXml, const FString& Fingerprint) const;
+
+	int32 Num() const;
+
+	/** Fingerprint of the elu.xml file and the model and animation files of its elu object, from the file index. Empty if the elu.xml file isn't indexed */
+	static FString ComputeFingerprint(const class FEluFileIndex& FileIndex, const FString& FilePath_EluXml);
+
+	static const TCHAR* GetStatusName(EEluCheckpointStatus Status);
+
+private:
+
+	FString FilePath_Checkpoint;
+
+	/** Latest entry of every elu object */
+	TMap<FString, FEluCheckpointEntry> Entries;
+
+	TArray<FEluPendingCheckpointEntry> PendingEntries;
+
+	TUniquePtr<FArchive> Writer;
+
+	static bool ParseStatusName(const FString& StatusName, EEluCheckpointStatus& OutStatus);
+
+	/** Packages that were unloaded count as saved, finished packages are only ever unloaded once they are saved */
+	static bool AreAllPackagesSaved(const TArray<TWeakObjectPtr<UPackage>>& Packages);
+
+};
@@ -0,0 +1,314 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluImportCommandlet.h"
+#include "EluErrorJournal.h"
+#include "EluImportPlan.h"
+
+#include "Misc/Parse.h"
+#include "Misc/FileHelper.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMemory.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+
+namespace
+{
+	template<typename EnumType>
+	bool ParseEnumValue(const TCHAR* EnumName, const FString& ValueName, EnumType& OutValue)
+	{
+		UEnum* Enum = FindObject<UEnum>(ANY_PACKAGE, EnumName, true);
+		if (!Enum)
+		{
+			return false;
+		}
+
+		int64 Value = Enum->GetValueByNameString(ValueName.TrimStartAndEnd());
+		if (Value == INDEX_NONE)
+		{
+			return false;
+		}
+
+		OutValue = (EnumType)Value;
+		return true;
+	}
+}
+
+
+UEluImportCommandlet::UEluImportCommandlet(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UEluImportCommandlet::Main(const FString& Params)
+{
+	FString LogMessage;
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamsMap;
+	UCommandlet::ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+	UEluProcessor* EluProcessor = NewObject<UEluProcessor>();
+	EluProcessor->AddToRoot();
+	EluProcessor->bUnattended = true;
+	EluProcessor->DefaultErrorPolicy = EEluErrorPolicy::Skip;
+
+	const FString* DefaultErrorPolicyString = ParamsMap.Find(TEXT("DefaultErrorPolicy"));
+	if (DefaultErrorPolicyString && !ParseEnumValue(TEXT("EEluErrorPolicy"), *DefaultErrorPolicyString, EluProcessor->DefaultErrorPolicy))
+	{
+		LogMessage = FString("Unknown default error policy: ") + *DefaultErrorPolicyString;
+		UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+		EluProcessor->RemoveFromRoot();
+		return 1;
+	}
+
+	const FString* ErrorPoliciesString = ParamsMap.Find(TEXT("ErrorPolicy"));
+	if (ErrorPoliciesString && !UEluImportCommandlet::ParseErrorPolicies(*ErrorPoliciesString, EluProcessor->ErrorPolicies))
+	{
+		EluProcessor->RemoveFromRoot();
+		return 1;
+	}
+
+	const FString* ErrorJournalFilePath = ParamsMap.Find(TEXT("ErrorJournal"));
+	if (ErrorJournalFilePath)
+	{
+		EluProcessor->FilePath_ErrorJournal = *ErrorJournalFilePath;
+	}
+
+	// Large batches would otherwise keep every imported model loaded until the worker exits
+	FParse::Value(*Params, TEXT("MemoryBudgetMB="), EluProcessor->MemoryBudgetMB);
+
+	const FString* ImportReportFilePath = ParamsMap.Find(TEXT("ImportReport"));
+	if (ImportReportFilePath)
+	{
+		EluProcessor->FilePath_ImportReport = *ImportReportFilePath;
+	}
+
+	// -Resume passes over the elu objects a crashed or cancelled run already finished
+	const FString* CheckpointFilePath = ParamsMap.Find(TEXT("Checkpoint"));
+	if (CheckpointFilePath)
+	{
+		EluProcessor->FilePath_Checkpoint = *CheckpointFilePath;
+	}
+	EluProcessor->bResume = Switches.Contains(TEXT("Resume"));
+	EluProcessor->bGenerateSkeletalLODs = Switches.Contains(TEXT("SkeletalLODs"));
+	EluProcessor->bSaveEachObject = true;
+
+	// Import workers run side by side, so they must neither write the shared caches nor create the same material instance packages
+	EluProcessor->bReadOnlyCaches = Switches.Contains(TEXT("ReadOnlyCaches"));
+
+	const FString* MIDir = ParamsMap.Find(TEXT("MIDir"));
+	if (MIDir)
+	{
+		EluProcessor->EditorDir_MIs = *MIDir;
+	}
+
+	const FString* MIStoreFilePath = ParamsMap.Find(TEXT("MIStore"));
+	if (MIStoreFilePath)
+	{
+		EluProcessor->FilePath_ExportedMIStore = *MIStoreFilePath;
+	}
+
+	// The import coordinator reads the progress file to find the elu object a crashed worker was importing
+	const FString* ProgressFilePath = ParamsMap.Find(TEXT("Progress"));
+	if (ProgressFilePath)
+	{
+		FString FilePath_Progress = *ProgressFilePath;
+		EluProcessor->OnEluXmlImportStarted.BindLambda([FilePath_Progress](const FString& FilePath_EluXml)
+		{
+			FFileHelper::SaveStringToFile(FilePath_EluXml, *FilePath_Progress);
+		});
+	}
+
+	EluProcessor->Initialize();
+
+	TArray<FString> Paths_EluXmlFilesToLoad;
+	if (!UEluImportCommandlet::GatherEluXmlFiles(Switches, ParamsMap, EluProcessor->FileIndex, Paths_EluXmlFilesToLoad))
+	{
+		EluProcessor->Uninitialize();
+		EluProcessor->RemoveFromRoot();
+		return 1;
+	}
+
+	// -Plan only reports what the import would do
+	const FString* PlanFilePath = ParamsMap.Find(TEXT("Plan"));
+	if (PlanFilePath || Switches.Contains(TEXT("Plan")))
+	{
+		FEluImportPlan ImportPlan;
+		EluProcessor->PlanEluModels(Paths_EluXmlFilesToLoad, ImportPlan);
+		ImportPlan.LogSummary();
+		bool bResult = ImportPlan.WriteJson(PlanFilePath ? *PlanFilePath : UEluProcessor::FilePath_ImportPlan);
+
+		EluProcessor->Uninitialize();
+		EluProcessor->RemoveFromRoot();
+		return bResult ? 0 : 1;
+	}
+
+	LogMessage = FString::Printf(TEXT("Importing %d elu xml files unattended"), Paths_EluXmlFilesToLoad.Num());
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	double StartTime = FPlatformTime::Seconds();
+
+	TArray<FString> Paths_EluXmlFilesLoaded;
+	EImportResult ImportResult = EluProcessor->ImportEluModels(Paths_EluXmlFilesToLoad, Paths_EluXmlFilesLoaded);
+
+	// Commandlets never save dirty packages on their own. Whatever a cancelled batch left unsaved is saved here
+	int32 NumPackagesSaved = EluProcessor->SaveFinishedPackages();
+
+	LogMessage = FString::Printf(TEXT("Saved %d model and animation packages"), NumPackagesSaved);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	double ImportTime = FPlatformTime::Seconds() - StartTime;
+
+	const FString* SummaryFilePath = ParamsMap.Find(TEXT("Summary"));
+	FString FilePath_Summary = SummaryFilePath ? *SummaryFilePath : UEluProcessor::FilePath_ImportSummary;
+	UEluImportCommandlet::WriteSummary(FilePath_Summary, EluProcessor, ImportResult, ImportTime, Paths_EluXmlFilesToLoad, Paths_EluXmlFilesLoaded);
+
+	EluProcessor->Uninitialize();
+	EluProcessor->RemoveFromRoot();
+
+	LogMessage = FString::Printf(TEXT("Imported %d of %d elu xml files in %.1f seconds"), Paths_EluXmlFilesLoaded.Num(), Paths_EluXmlFilesToLoad.Num(), ImportTime);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	if (ImportResult != EImportResult::Success || Paths_EluXmlFilesLoaded.Num() != Paths_EluXmlFilesToLoad.Num())
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+bool UEluImportCommandlet::GatherEluXmlFiles(const TArray<FString>& Switches, const TMap<FString, FString>& ParamsMap, const FEluFileIndex& FileIndex, TArray<FString>& OutPaths_EluXml)
+{
+	FString LogMessage;
+
+	if (Switches.Contains(TEXT("All")))
+	{
+		FileIndex.FindFilesRecursively(OutPaths_EluXml, FString(".elu.xml"));
+	}
+
+	const FString* EluXmlListFilePath = ParamsMap.Find(TEXT("EluXmlList"));
+	if (EluXmlListFilePath)
+	{
+		TArray<FString> ListedFilePaths;
+		if (!FFileHelper::LoadFileToStringArray(ListedFilePaths, **EluXmlListFilePath))
+		{
+			LogMessage = FString("Unable to read elu xml list file: ") + *EluXmlListFilePath;
+			UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+			return false;
+		}
+
+		for (const FString& ListedFilePath : ListedFilePaths)
+		{
+			FString FilePath_EluXml = ListedFilePath.TrimStartAndEnd();
+			if (!FilePath_EluXml.IsEmpty())
+			{
+				OutPaths_EluXml.AddUnique(FilePath_EluXml);
+			}
+		}
+	}
+
+	const FString* EluXmlFilePaths = ParamsMap.Find(TEXT("EluXml"));
+	if (EluXmlFilePaths)
+	{
+		TArray<FString> FilePaths_EluXml;
+		EluXmlFilePaths->ParseIntoArray(FilePaths_EluXml, TEXT("+"));
+		for (const FString& FilePath_EluXml : FilePaths_EluXml)
+		{
+			OutPaths_EluXml.AddUnique(FilePath_EluXml);
+		}
+	}
+
+	return true;
+}
+
+bool UEluImportCommandlet::ParseErrorPolicies(const FString& ErrorPoliciesString, TMap<EEluErrorKind, EEluErrorPolicy>& OutErrorPolicies)
+{
+	FString LogMessage;
+
+	TArray<FString> ErrorPolicyPairs;
+	ErrorPoliciesString.ParseIntoArray(ErrorPolicyPairs, TEXT(","));
+
+	for (const FString& ErrorPolicyPair : ErrorPolicyPairs)
+	{
+		FString ErrorKindName;
+		FString ErrorPolicyName;
+		EEluErrorKind ErrorKind;
+		EEluErrorPolicy ErrorPolicy;
+
+		if (!ErrorPolicyPair.Split(TEXT(":"), &ErrorKindName, &ErrorPolicyName) ||
+			!ParseEnumValue(TEXT("EEluErrorKind"), ErrorKindName, ErrorKind) ||
+			!ParseEnumValue(TEXT("EEluErrorPolicy"), ErrorPolicyName, ErrorPolicy))
+		{
+			LogMessage = FString("Invalid error policy: ") + ErrorPolicyPair + FString(". Expected <ErrorKind>:<Ask|Skip|Retry|Abort>");
+			UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+			return false;
+		}
+
+		OutErrorPolicies.Add(ErrorKind, ErrorPolicy);
+	}
+
+	return true;
+}
+
+bool UEluImportCommandlet::WriteSummary(const FString& FilePath_Summary, UEluProcessor* EluProcessor, EImportResult ImportResult, double ImportTime,
+										const TArray<FString>& Paths_EluXmlFilesToLoad, const TArray<FString>& Paths_EluXmlFilesLoaded)
+{
+	FString LogMessage;
+
+	UEnum* ImportResultEnum = FindObject<UEnum>(ANY_PACKAGE, TEXT("EImportResult"), true);
+
+	FString SummaryJson;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&SummaryJson);
+
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteValue(TEXT("result"), ImportResultEnum ? ImportResultEnum->GetNameStringByValue((int64)ImportResult) : FString());
+	JsonWriter->WriteValue(TEXT("import_time_seconds"), ImportTime);
+	JsonWriter->WriteValue(TEXT("num_requested"), Paths_EluXmlFilesToLoad.Num());
+	JsonWriter->WriteValue(TEXT("num_loaded"), Paths_EluXmlFilesLoaded.Num());
+	JsonWriter->WriteValue(TEXT("memory_budget_mb"), EluProcessor->MemoryBudgetMB);
+	JsonWriter->WriteValue(TEXT("peak_used_physical_mb"), (double)(FPlatformMemory::GetStats().PeakUsedPhysical / (1024 * 1024)));
+
+	JsonWriter->WriteArrayStart(TEXT("loaded"));
+	for (const FString& FilePath_EluXml : Paths_EluXmlFilesLoaded)
+	{
+		JsonWriter->WriteValue(FilePath_EluXml);
+	}
+	JsonWriter->WriteArrayEnd();
+
+	// Files that were cancelled before they were reached are listed as not loaded as well
+	JsonWriter->WriteArrayStart(TEXT("not_loaded"));
+	for (const FString& FilePath_EluXml : Paths_EluXmlFilesToLoad)
+	{
+		if (!Paths_EluXmlFilesLoaded.Contains(FilePath_EluXml))
+		{
+			JsonWriter->WriteValue(FilePath_EluXml);
+		}
+	}
+	JsonWriter->WriteArrayEnd();
+
+	JsonWriter->WriteObjectStart(TEXT("errors"));
+	for (const TPair<EEluErrorKind, int32>& ErrorCountPair : EluProcessor->ErrorCounts)
+	{
+		JsonWriter->WriteValue(FEluErrorRecord::GetErrorKindName(ErrorCountPair.Key), ErrorCountPair.Value);
+	}
+	JsonWriter->WriteObjectEnd();
+
+	JsonWriter->WriteValue(TEXT("error_journal"), EluProcessor->FilePath_ErrorJournal);
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+
+	bool bResult = FFileHelper::SaveStringToFile(SummaryJson, *FilePath_Summary);
+	if (!bResult)
+	{
+		LogMessage = FString("Unable to write import summary: ") + FilePath_Summary;
+		UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+	}
+
+	return bResult;
+}
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "EluProcessor.h"
+#include "EluImportCommandlet.generated.h"
+
+
+/**
+ * Runs an elu model import without any UI, e.g., on a build machine:
+ *
+ * UE4Editor-Cmd.exe RaiderZAssets.uproject -run=EluImport [-All] [-EluXml=<path>+<path>] [-EluXmlList=<file>]
+ *     [-DefaultErrorPolicy=Skip] [-ErrorPolicy=<ErrorKind>:<Policy>,...] [-Summary=<file>] [-ErrorJournal=<file>] [-ImportReport=<file>] [-Progress=<file>]
+ *     [-MemoryBudgetMB=<MB>] [-Checkpoint=<file>] [-Resume] [-SkeletalLODs] [-Plan[=<file>]]
+ *     [-ReadOnlyCaches] [-MIDir=<editor dir>] [-MIStore=<file>]
+ *
+ * Writes a json summary of the import and returns non-zero if the import was cancelled or any elu.xml file failed.
+ * -Plan writes a json plan of what the import would do, with time and disk estimates, instead of importing anything.
+ * With -Resume, the elu objects the checkpoint of an earlier run lists as finished are passed over, and count as loaded.
+ * -SkeletalLODs generates the LOD chains of the fbx import presets for the imported skeletal meshes.
+ * -ReadOnlyCaches, -MIDir and -MIStore are used by the import coordinator: its workers load the shared caches but never write them, create their
+ * new material instances in a directory of their own, and write the material instances they added to the store to a file of their own for the coordinator to merge.
+ */
+UCLASS()
+class RAIDERZASSETS_API UEluImportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UEluImportCommandlet(const FObjectInitializer& ObjectInitializer);
+
+	virtual int32 Main(const FString& Params) override;
+
+	/** Collects the elu.xml files selected by -All, -EluXmlList and -EluXml, in that order and without duplicates. Returns false if the -EluXmlList file can't be read */
+	static bool GatherEluXmlFiles(const TArray<FString>& Switches, const TMap<FString, FString>& ParamsMap, const class FEluFileIndex& FileIndex, TArray<FString>& OutPaths_EluXml);
+
+	/** Parses comma separated <ErrorKind>:<Policy> pairs, e.g., "ParentMaterialMissing:Retry,MaterialSlotUnresolved:Skip" */
+	static bool ParseErrorPolicies(const FString& ErrorPoliciesString, TMap<EEluErrorKind, EEluErrorPolicy>& OutErrorPolicies);
+
+	static bool WriteSummary(const FString& FilePath_Summary, class UEluProcessor* EluProcessor, EImportResult ImportResult, double ImportTime,
+							 const TArray<FString>& Paths_EluXmlFilesToLoad, const TArray<FString>& Paths_EluXmlFilesLoaded);
+
+};
@@ -0,0 +1,483 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluImportCoordinatorCommandlet.h"
+#include "EluImportCommandlet.h"
+#include "EluProcessor.h"
+#include "EluFileIndex.h"
+#include "EluErrorJournal.h"
+#include "EluMaterialInstanceStore.h"
+
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+
+const int32 UEluImportCoordinatorCommandlet::MaxUnattributedCrashes = 2;
+
+
+FEluImportShard::FEluImportShard()
+{
+	ShardIndex = 0;
+	EstimatedCost = 0;
+	NumUnattributedCrashes = 0;
+	NumRestarts = 0;
+	bRunning = false;
+}
+
+UEluImportCoordinatorCommandlet::UEluImportCoordinatorCommandlet(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+	bResume = false;
+}
+
+int32 UEluImportCoordinatorCommandlet::Main(const FString& Params)
+{
+	FString LogMessage;
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamsMap;
+	UCommandlet::ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+	const FString* DefaultErrorPolicyString = ParamsMap.Find(TEXT("DefaultErrorPolicy"));
+	if (DefaultErrorPolicyString)
+	{
+		WorkerParams += FString(" -DefaultErrorPolicy=") + *DefaultErrorPolicyString;
+	}
+
+	const FString* ErrorPoliciesString = ParamsMap.Find(TEXT("ErrorPolicy"));
+	if (ErrorPoliciesString)
+	{
+		WorkerParams += FString(" -ErrorPolicy=") + *ErrorPoliciesString;
+	}
+
+	// The budget applies to every worker on its own
+	const FString* MemoryBudgetString = ParamsMap.Find(TEXT("MemoryBudgetMB"));
+	if (MemoryBudgetString)
+	{
+		WorkerParams += FString(" -MemoryBudgetMB=") + *MemoryBudgetString;
+	}
+
+	if (Switches.Contains(TEXT("SkeletalLODs")))
+	{
+		WorkerParams += FString(" -SkeletalLODs");
+	}
+
+	// Shards are built the same way every time, so unchanged inputs give every worker the checkpoint of its previous run
+	bResume = Switches.Contains(TEXT("Resume"));
+
+	int32 NumWorkers = FMath::Max(1, FPlatformMisc::NumberOfCores() / 4);
+	const FString* NumWorkersString = ParamsMap.Find(TEXT("Workers"));
+	if (NumWorkersString)
+	{
+		NumWorkers = FMath::Max(1, FCString::Atoi(**NumWorkersString));
+	}
+
+	// Workers refresh the index themselves, it only has to be current for the cost estimate here
+	FEluFileIndex FileIndex;
+	FileIndex.LoadFromFile(UEluProcessor::FilePath_FileIndex);
+	FileIndex.Refresh(UEluProcessor::DirPath_AllModels);
+	FileIndex.SaveToFile(UEluProcessor::FilePath_FileIndex);
+
+	TArray<FString> Paths_EluXmlFilesToLoad;
+	if (!UEluImportCommandlet::GatherEluXmlFiles(Switches, ParamsMap, FileIndex, Paths_EluXmlFilesToLoad))
+	{
+		return 1;
+	}
+
+	TArray<FEluImportShard> Shards;
+	UEluImportCoordinatorCommandlet::BuildShards(Paths_EluXmlFilesToLoad, FileIndex, NumWorkers, Shards);
+
+	LogMessage = FString::Printf(TEXT("Importing %d elu xml files with %d workers"), Paths_EluXmlFilesToLoad.Num(), Shards.Num());
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	double StartTime = FPlatformTime::Seconds();
+
+	IFileManager::Get().MakeDirectory(*UEluProcessor::DirPath_ImportShards, true);
+	for (FEluImportShard& Shard : Shards)
+	{
+		FString FilePath_ShardBase = UEluProcessor::DirPath_ImportShards + FString::Printf(TEXT("/shard_%d"), Shard.ShardIndex);
+		Shard.FilePath_List = FilePath_ShardBase + FString("_list.txt");
+		Shard.FilePath_Summary = FilePath_ShardBase + FString("_summary.json");
+		Shard.FilePath_Progress = FilePath_ShardBase + FString("_progress.txt");
+		Shard.FilePath_ErrorJournal = FilePath_ShardBase + FString("_errors.txt");
+		Shard.FilePath_ImportReport = FilePath_ShardBase + FString("_report.json");
+		Shard.FilePath_Checkpoint = FilePath_ShardBase + FString("_checkpoint.txt");
+		Shard.FilePath_MIStore = FilePath_ShardBase + FString("_mi_store.bin");
+		Shard.EditorDir_MIs = UEluProcessor::EditorDir_MaterialInstances + FString::Printf(TEXT("/Shard_%d"), Shard.ShardIndex);
+
+		// Journals and material instance stores of earlier runs would be merged again otherwise
+		IFileManager::Get().Delete(*Shard.FilePath_ErrorJournal, false, true, true);
+		IFileManager::Get().Delete(*Shard.FilePath_MIStore, false, true, true);
+
+		LaunchWorker(Shard);
+	}
+
+	int32 NumRunning = Shards.FilterByPredicate([](const FEluImportShard& Shard) { return Shard.bRunning; }).Num();
+	while (NumRunning > 0)
+	{
+		FPlatformProcess::Sleep(1.0f);
+
+		for (FEluImportShard& Shard : Shards)
+		{
+			if (!Shard.bRunning || FPlatformProcess::IsProcRunning(Shard.WorkerHandle))
+			{
+				continue;
+			}
+
+			int32 ReturnCode = 0;
+			FPlatformProcess::GetProcReturnCode(Shard.WorkerHandle, &ReturnCode);
+			FPlatformProcess::CloseProc(Shard.WorkerHandle);
+			Shard.bRunning = false;
+
+			if (!HandleWorkerExit(Shard, ReturnCode))
+			{
+				NumRunning--;
+			}
+		}
+	}
+
+	double ImportTime = FPlatformTime::Seconds() - StartTime;
+
+	FEluErrorJournal::Get().Open(UEluProcessor::FilePath_ErrorFile);
+	for (const FEluImportShard& Shard : Shards)
+	{
+		FEluErrorJournal::Get().Merge(Shard.FilePath_ErrorJournal);
+	}
+	FEluErrorJournal::Get().Close();
+
+	UEluImportCoordinatorCommandlet::MergeWorkerMIStores(Shards);
+
+	const FString* SummaryFilePath = ParamsMap.Find(TEXT("Summary"));
+	FString FilePath_Summary = SummaryFilePath ? *SummaryFilePath : UEluProcessor::FilePath_ImportSummary;
+	UEluImportCoordinatorCommandlet::WriteMergedSummary(FilePath_Summary, Shards, Paths_EluXmlFilesToLoad, ImportTime);
+
+	int32 NumLoaded = 0;
+	int32 NumQuarantined = 0;
+	for (const FEluImportShard& Shard : Shards)
+	{
+		NumLoaded += Shard.Paths_Loaded.Num();
+		NumQuarantined += Shard.Paths_Quarantined.Num();
+	}
+
+	LogMessage = FString::Printf(TEXT("Imported %d of %d elu xml files in %.1f seconds, %d quarantined"), NumLoaded, Paths_EluXmlFilesToLoad.Num(), ImportTime, NumQuarantined);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	return NumLoaded == Paths_EluXmlFilesToLoad.Num() ? 0 : 1;
+}
+
+int64 UEluImportCoordinatorCommandlet::EstimateImportCost(const FEluFileIndex& FileIndex, const FString& FilePath_EluXml)
+{
+	// Every elu object costs something, even if its files are tiny
+	int64 Cost = 64 * 1024;
+
+	FString DirPath_EluObject = FPaths::GetPath(FPaths::GetPath(FilePath_EluXml));
+
+	TArray<FString> DirPaths_Source;
+	DirPaths_Source.Add(DirPath_EluObject + FString("/") + UEluProcessor::DirName_EluModels);
+	DirPaths_Source.Add(DirPath_EluObject + FString("/") + UEluProcessor::DirName_EluAnimations);
+
+	for (const FString& DirPath_Source : DirPaths_Source)
+	{
+		const FEluIndexedDirectory* IndexedDirectory = FileIndex.FindDirectory(DirPath_Source);
+		if (!IndexedDirectory)
+		{
+			continue;
+		}
+
+		for (const FEluIndexedFile& IndexedFile : IndexedDirectory->Files)
+		{
+			Cost += IndexedFile.FileSize;
+		}
+	}
+
+	return Cost;
+}
+
+void UEluImportCoordinatorCommandlet::BuildShards(const TArray<FString>& Paths_EluXml, const FEluFileIndex& FileIndex, int32 NumShards, TArray<FEluImportShard>& OutShards)
+{
+	OutShards.Empty();
+
+	NumShards = FMath::Min(NumShards, Paths_EluXml.Num());
+	if (NumShards <= 0)
+	{
+		return;
+	}
+
+	TMap<FString, int64> Costs;
+	for (const FString& FilePath_EluXml : Paths_EluXml)
+	{
+		Costs.Add(FilePath_EluXml, UEluImportCoordinatorCommandlet::EstimateImportCost(FileIndex, FilePath_EluXml));
+	}
+
+	TArray<FString> SortedPaths_EluXml = Paths_EluXml;
+	SortedPaths_EluXml.Sort([&Costs](const FString& A, const FString& B)
+	{
+		return Costs[A] > Costs[B];
+	});
+
+	OutShards.SetNum(NumShards);
+	for (int32 ShardIndex = 0; ShardIndex < NumShards; ShardIndex++)
+	{
+		OutShards[ShardIndex].ShardIndex = ShardIndex;
+	}
+
+	for (const FString& FilePath_EluXml : SortedPaths_EluXml)
+	{
+		FEluImportShard* CheapestShard = &OutShards[0];
+		for (FEluImportShard& Shard : OutShards)
+		{
+			if (Shard.EstimatedCost < CheapestShard->EstimatedCost)
+			{
+				CheapestShard = &Shard;
+			}
+		}
+
+		CheapestShard->Paths_EluXml.Add(FilePath_EluXml);
+		CheapestShard->EstimatedCost += Costs[FilePath_EluXml];
+	}
+}
+
+bool UEluImportCoordinatorCommandlet::LaunchWorker(FEluImportShard& Shard)
+{
+	FString LogMessage;
+
+	if (Shard.Paths_EluXml.Num() == 0)
+	{
+		return false;
+	}
+
+	FFileHelper::SaveStringArrayToFile(Shard.Paths_EluXml, *Shard.FilePath_List);
+
+	// A summary is only written by a worker that didn't crash, and the progress file must not point at a previous run
+	IFileManager::Get().Delete(*Shard.FilePath_Summary, false, true, true);
+	IFileManager::Get().Delete(*Shard.FilePath_Progress, false, true, true);
+
+	// Without -Resume the worker starts its checkpoint over
+	bool bWorkerResume = bResume || Shard.NumRestarts > 0;
+
+	FString FilePath_Project = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	FString WorkerCommandLine = FString::Printf(TEXT("\"%s\" -run=EluImport -EluXmlList=\"%s\" -Summary=\"%s\" -Progress=\"%s\" -ErrorJournal=\"%s\" -ImportReport=\"%s\" -Checkpoint=\"%s\" -MIStore=\"%s\" -MIDir=\"%s\" -ReadOnlyCaches%s%s -unattended -nopause -nosplash"),
+												*FilePath_Project, *Shard.FilePath_List, *Shard.FilePath_Summary, *Shard.FilePath_Progress, *Shard.FilePath_ErrorJournal,
+												*Shard.FilePath_ImportReport, *Shard.FilePath_Checkpoint, *Shard.FilePath_MIStore, *Shard.EditorDir_MIs, bWorkerResume ? TEXT(" -Resume") : TEXT(""), *WorkerParams);
+
+	Shard.WorkerHandle = FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *WorkerCommandLine, false, true, true, nullptr, 0, nullptr, nullptr);
+	Shard.bRunning = Shard.WorkerHandle.IsValid();
+
+	if (Shard.bRunning)
+	{
+		LogMessage = FString::Printf(TEXT("Started worker for shard %d: %d elu xml files, %lld source bytes"), Shard.ShardIndex, Shard.Paths_EluXml.Num(), Shard.EstimatedCost);
+		UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+	}
+	else
+	{
+		LogMessage = FString::Printf(TEXT("Unable to start worker for shard %d"), Shard.ShardIndex);
+		UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+	}
+
+	return Shard.bRunning;
+}
+
+bool UEluImportCoordinatorCommandlet::HandleWorkerExit(FEluImportShard& Shard, int32 ReturnCode)
+{
+	FString LogMessage;
+
+	if (UEluImportCoordinatorCommandlet::ReadWorkerSummary(Shard))
+	{
+		LogMessage = FString::Printf(TEXT("Worker for shard %d finished: %d of %d elu xml files loaded"), Shard.ShardIndex, Shard.Paths_Loaded.Num(), Shard.Paths_EluXml.Num());
+		UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+		return false;
+	}
+
+	FString FilePath_Crashed;
+	FFileHelper::LoadFileToString(FilePath_Crashed, *Shard.FilePath_Progress);
+	FilePath_Crashed.TrimStartAndEndInline();
+
+	if (!FilePath_Crashed.IsEmpty() && Shard.Paths_EluXml.Remove(FilePath_Crashed) > 0)
+	{
+		Shard.Paths_Quarantined.Add(FilePath_Crashed);
+
+		LogMessage = FString::Printf(TEXT("Worker for shard %d crashed (return code %d) while importing: %s. Quarantining it and restarting the worker"), Shard.ShardIndex, ReturnCode, *FilePath_Crashed);
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+	}
+	else if (++Shard.NumUnattributedCrashes <= UEluImportCoordinatorCommandlet::MaxUnattributedCrashes)
+	{
+		LogMessage = FString::Printf(TEXT("Worker for shard %d crashed (return code %d) outside of any elu object. Restarting the worker"), Shard.ShardIndex, ReturnCode);
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+	}
+	else
+	{
+		LogMessage = FString::Printf(TEXT("Worker for shard %d keeps crashing outside of any elu object. Giving up on the shard"), Shard.ShardIndex);
+		UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+		Shard.ImportResult = FString("Crashed");
+		return false;
+	}
+
+	// The restarted worker resumes from its checkpoint, so the elu objects it already finished and saved aren't even loaded
+	Shard.NumRestarts++;
+	return LaunchWorker(Shard);
+}
+
+bool UEluImportCoordinatorCommandlet::ReadWorkerSummary(FEluImportShard& Shard)
+{
+	FString SummaryJson;
+	if (!FFileHelper::LoadFileToString(SummaryJson, *Shard.FilePath_Summary))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> SummaryObject;
+	TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(SummaryJson);
+	if (!FJsonSerializer::Deserialize(JsonReader, SummaryObject) || !SummaryObject.IsValid())
+	{
+		return false;
+	}
+
+	Shard.ImportResult = SummaryObject->GetStringField(TEXT("result"));
+
+	Shard.Paths_Loaded.Empty();
+	SummaryObject->TryGetStringArrayField(TEXT("loaded"), Shard.Paths_Loaded);
+
+	const TSharedPtr<FJsonObject>* ErrorsObject = nullptr;
+	if (SummaryObject->TryGetObjectField(TEXT("errors"), ErrorsObject))
+	{
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& ErrorPair : (*ErrorsObject)->Values)
+		{
+			Shard.ErrorCounts.FindOrAdd(ErrorPair.Key) += (int32)ErrorPair.Value->AsNumber();
+		}
+	}
+
+	return true;
+}
+
+void UEluImportCoordinatorCommandlet::MergeWorkerMIStores(const TArray<FEluImportShard>& Shards)
+{
+	FString LogMessage;
+
+	FEluMaterialInstanceStore MIStore;
+	MIStore.LoadFromFile(UEluProcessor::FilePath_MaterialInstanceStore);
+	int32 NumEntriesBefore = MIStore.Num();
+
+	for (const FEluImportShard& Shard : Shards)
+	{
+		FEluMaterialInstanceStore WorkerMIStore;
+		if (WorkerMIStore.LoadFromFile(Shard.FilePath_MIStore))
+		{
+			MIStore.Append(WorkerMIStore);
+		}
+	}
+
+	if (!MIStore.SaveToFile(UEluProcessor::FilePath_MaterialInstanceStore))
+	{
+		LogMessage = FString("Unable to write material instance store: ") + UEluProcessor::FilePath_MaterialInstanceStore;
+		UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+		return;
+	}
+
+	LogMessage = FString::Printf(TEXT("Merged %d material instances of the workers into the material instance store"), MIStore.Num() - NumEntriesBefore);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+}
+
+bool UEluImportCoordinatorCommandlet::WriteMergedSummary(const FString& FilePath_Summary, const TArray<FEluImportShard>& Shards, const TArray<FString>& Paths_EluXmlFilesToLoad, double ImportTime)
+{
+	FString LogMessage;
+
+	TSet<FString> Paths_Loaded;
+	TArray<FString> Paths_Quarantined;
+	TMap<FString, int32> ErrorCounts;
+	bool bAllShardsSucceeded = true;
+
+	for (const FEluImportShard& Shard : Shards)
+	{
+		Paths_Loaded.Append(Shard.Paths_Loaded);
+		Paths_Quarantined.Append(Shard.Paths_Quarantined);
+
+		for (const TPair<FString, int32>& ErrorCountPair : Shard.ErrorCounts)
+		{
+			ErrorCounts.FindOrAdd(ErrorCountPair.Key) += ErrorCountPair.Value;
+		}
+
+		bAllShardsSucceeded &= Shard.ImportResult == FString("Success");
+	}
+
+	FString SummaryJson;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&SummaryJson);
+
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteValue(TEXT("result"), bAllShardsSucceeded ? FString("Success") : FString("Failure"));
+	JsonWriter->WriteValue(TEXT("import_time_seconds"), ImportTime);
+	JsonWriter->WriteValue(TEXT("num_requested"), Paths_EluXmlFilesToLoad.Num());
+	JsonWriter->WriteValue(TEXT("num_loaded"), Paths_Loaded.Num());
+
+	JsonWriter->WriteArrayStart(TEXT("loaded"));
+	for (const FString& FilePath_EluXml : Paths_EluXmlFilesToLoad)
+	{
+		if (Paths_Loaded.Contains(FilePath_EluXml))
+		{
+			JsonWriter->WriteValue(FilePath_EluXml);
+		}
+	}
+	JsonWriter->WriteArrayEnd();
+
+	JsonWriter->WriteArrayStart(TEXT("not_loaded"));
+	for (const FString& FilePath_EluXml : Paths_EluXmlFilesToLoad)
+	{
+		if (!Paths_Loaded.Contains(FilePath_EluXml))
+		{
+			JsonWriter->WriteValue(FilePath_EluXml);
+		}
+	}
+	JsonWriter->WriteArrayEnd();
+
+	JsonWriter->WriteArrayStart(TEXT("quarantined"));
+	for (const FString& FilePath_EluXml : Paths_Quarantined)
+	{
+		JsonWriter->WriteValue(FilePath_EluXml);
+	}
+	JsonWriter->WriteArrayEnd();
+
+	JsonWriter->WriteObjectStart(TEXT("errors"));
+	for (const TPair<FString, int32>& ErrorCountPair : ErrorCounts)
+	{
+		JsonWriter->WriteValue(ErrorCountPair.Key, ErrorCountPair.Value);
+	}
+	JsonWriter->WriteObjectEnd();
+
+	JsonWriter->WriteArrayStart(TEXT("shards"));
+	for (const FEluImportShard& Shard : Shards)
+	{
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("index"), Shard.ShardIndex);
+		JsonWriter->WriteValue(TEXT("result"), Shard.ImportResult);
+		JsonWriter->WriteValue(TEXT("num_files"), Shard.Paths_EluXml.Num() + Shard.Paths_Quarantined.Num());
+		JsonWriter->WriteValue(TEXT("num_loaded"), Shard.Paths_Loaded.Num());
+		JsonWriter->WriteValue(TEXT("estimated_cost_bytes"), Shard.EstimatedCost);
+		JsonWriter->WriteValue(TEXT("num_restarts"), Shard.NumRestarts);
+		JsonWriter->WriteObjectEnd();
+	}
+	JsonWriter->WriteArrayEnd();
+
+	JsonWriter->WriteValue(TEXT("error_journal"), UEluProcessor::FilePath_ErrorFile);
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+
+	bool bResult = FFileHelper::SaveStringToFile(SummaryJson, *FilePath_Summary);
+	if (!bResult)
+	{
+		LogMessage = FString("Unable to write import summary: ") + FilePath_Summary;
+		UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+	}
+
+	return bResult;
+}
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HAL/PlatformProcess.h"
+#include "EluImportCoordinatorCommandlet.generated.h"
+
+
+struct RAIDERZASSETS_API FEluImportShard
+{
+	int32 ShardIndex;
+
+	/** Elu.xml files of this shard, largest first */
+	TArray<FString> Paths_EluXml;
+
+	/** Source bytes of all elu objects of this shard */
+	int64 EstimatedCost;
+
+	/** Elu objects whose import crashed a worker. They are left out when the worker is restarted */
+	TArray<FString> Paths_Quarantined;
+
+	TArray<FString> Paths_Loaded;
+
+	/** Restarts after crashes that couldn't be attributed to an elu object */
+	int32 NumUnattributedCrashes;
+
+	int32 NumRestarts;
+
+	FString ImportResult;
+
+	FProcHandle WorkerHandle;
+
+	bool bRunning;
+
+	FString FilePath_List;
+
+	FString FilePath_Summary;
+
+	FString FilePath_Progress;
+
+	FString FilePath_ErrorJournal;
+
+	/** Phase times of the worker. Its csv lines are appended across runs and restarts */
+	FString FilePath_ImportReport;
+
+	/** Elu objects the worker finished and saved. Restarted workers resume from it */
+	FString FilePath_Checkpoint;
+
+	/** Material instances the worker created, merged into the shared material instance store once all workers are done */
+	FString FilePath_MIStore;
+
+	/** Editor directory the worker creates its material instances in, so that no two workers ever create the same package */
+	FString EditorDir_MIs;
+
+	/** Error counts by kind name, read from the worker summary */
+	TMap<FString, int32> ErrorCounts;
+
+	FEluImportShard();
+};
+
+
+/**
+ * Splits an elu model import across several EluImport commandlet worker processes:
+ *
+ * UE4Editor-Cmd.exe RaiderZAssets.uproject -run=EluImportCoordinator [-Workers=<N>] [-All] [-EluXml=<path>+<path>] [-EluXmlList=<file>]
+ *     [-DefaultErrorPolicy=Skip] [-ErrorPolicy=<ErrorKind>:<Policy>,...] [-MemoryBudgetMB=<MB>] [-SkeletalLODs] [-Summary=<file>] [-Resume]
+ *
+ * Elu objects are distributed largest first, so that shards finish at about the same time. A worker that crashes is restarted
+ * without the elu object it was importing, which is reported as quarantined, and resumes from its checkpoint.
+ * Worker summaries and error journals are merged into one. -Resume also lets the first workers resume from the checkpoints of the previous run.
+ * Workers load the shared caches but never write them, and reuse the material instances the shared store and /Game/EOD/MIs already hold. New material
+ * instances are created in a directory per worker, and merged into the shared store at the end. Only materials that are new to the whole run can end up
+ * with one material instance per shard.
+ */
+UCLASS()
+class RAIDERZASSETS_API UEluImportCoordinatorCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** A shard is given up after this many crashes that happened outside of any elu object */
+	static const int32 MaxUnattributedCrashes;
+
+	UEluImportCoordinatorCommandlet(const FObjectInitializer& ObjectInitializer);
+
+	virtual int32 Main(const FString& Params) override;
+
+	/** Estimates the import cost of an elu object by the size of its model and animation files */
+	static int64 EstimateImportCost(const class FEluFileIndex& FileIndex, const FString& FilePath_EluXml);
+
+	/** Distributes the elu.xml files over NumShards shards, largest first, always onto the shard with the lowest cost so far */
+	static void BuildShards(const TArray<FString>& Paths_EluXml, const class FEluFileIndex& FileIndex, int32 NumShards, TArray<FEluImportShard>& OutShards);
+
+private:
+
+	/** Error policy switches passed through to every worker */
+	FString WorkerParams;
+
+	bool bResume;
+
+	bool LaunchWorker(FEluImportShard& Shard);
+
+	/** Collects the results of a finished worker, or restarts it if it crashed. Returns true if the worker was restarted */
+	bool HandleWorkerExit(FEluImportShard& Shard, int32 ReturnCode);
+
+	static bool ReadWorkerSummary(FEluImportShard& Shard);
+
+	/** Adds the material instances created by the workers to the shared material instance store */
+	static void MergeWorkerMIStores(const TArray<FEluImportShard>& Shards);
+
+	static bool WriteMergedSummary(const FString& FilePath_Summary, const TArray<FEluImportShard>& Shards, const TArray<FString>& Paths_EluXmlFilesToLoad, double ImportTime);
+
+};
@@ -0,0 +1,548 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluImportPlan.h"
+#include "EluFileIndex.h"
+#include "EluFbxPrefilter.h"
+#include "EluMaterialPermutation.h"
+#include "EluMaterialInstanceStore.h"
+#include "EluAssetRegistrySnapshot.h"
+
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "PackageTools.h"
+#include "AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "EditorFramework/AssetImportData.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+
+FEluObjectImportPlan::FEluObjectImportPlan()
+{
+	ModelType = EEluModelType::Unknown;
+	bSupported = false;
+	bRejected = false;
+	NumMeshesToImport = 0;
+	NumMeshesUpToDate = 0;
+	NumMeshesFiltered = 0;
+	NumMeshesWithoutGeometry = 0;
+	NumMeshLODsToImport = 0;
+	NumHumanMeshesNotSkeletal = 0;
+	NumAnimationsToImport = 0;
+	NumAnimationsUpToDate = 0;
+	NumMaterials = 0;
+	NumMaterialInstancesToReuse = 0;
+	NumMaterialInstancesToCreate = 0;
+	MeshSourceBytesToImport = 0;
+	AnimationSourceBytesToImport = 0;
+	EstimatedSeconds = 0.0;
+	EstimatedDiskBytes = 0;
+}
+
+void FEluObjectImportPlan::Accumulate(const FEluObjectImportPlan& Other)
+{
+	NumMeshesToImport += Other.NumMeshesToImport;
+	NumMeshesUpToDate += Other.NumMeshesUpToDate;
+	NumMeshesFiltered += Other.NumMeshesFiltered;
+	NumMeshesWithoutGeometry += Other.NumMeshesWithoutGeometry;
+	NumMeshLODsToImport += Other.NumMeshLODsToImport;
+	NumHumanMeshesNotSkeletal += Other.NumHumanMeshesNotSkeletal;
+	NumAnimationsToImport += Other.NumAnimationsToImport;
+	NumAnimationsUpToDate += Other.NumAnimationsUpToDate;
+	NumMaterials += Other.NumMaterials;
+	NumMaterialInstancesToReuse += Other.NumMaterialInstancesToReuse;
+	NumMaterialInstancesToCreate += Other.NumMaterialInstancesToCreate;
+	MeshSourceBytesToImport += Other.MeshSourceBytesToImport;
+	AnimationSourceBytesToImport += Other.AnimationSourceBytesToImport;
+	EstimatedSeconds += Other.EstimatedSeconds;
+	EstimatedDiskBytes += Other.EstimatedDiskBytes;
+}
+
+FEluImportPlan::FEluImportPlan()
+{
+	SecondsPerMesh = 0.5;
+	SecondsPerMeshSourceMB = 2.0;
+	SecondsPerAnimation = 0.2;
+	SecondsPerAnimationSourceMB = 1.0;
+	SecondsPerMaterialInstance = 0.05;
+	DiskBytesPerMeshSourceByte = 1.5;
+	DiskBytesPerAnimationSourceByte = 0.75;
+	DiskBytesPerMaterialInstance = 16 * 1024;
+	NumObjectsRejected = 0;
+	BuildSeconds = 0.0;
+}
+
+void FEluImportPlan::Build(const TArray<FString>& Paths_EluXml, const FEluFileIndex& FileIndex, const FEluMaterialInstanceStore& MIStore, const FEluFbxPrefilter& FbxPrefilter,
+						   const TMap<FString, FMD5Hash>& SourceFileHashes, const FString& DirPath_ModelsRoot, const FString& EditorDir_ModelsRoot)
+{
+	check(IsInGameThread());
+
+	double StartTime = FPlatformTime::Seconds();
+
+	ObjectPlans.Empty();
+	Totals = FEluObjectImportPlan();
+	MissingTextures.Empty();
+	MissingParentMaterials.Empty();
+	NumObjectsRejected = 0;
+
+	// The asset registry isn't safe to query from worker threads, everything they need from it is copied here
+	GatherImportInfos(EditorDir_ModelsRoot);
+
+	ObjectPlans.SetNum(Paths_EluXml.Num());
+	ParallelFor(Paths_EluXml.Num(), [this, &Paths_EluXml, &FileIndex, &FbxPrefilter, &SourceFileHashes, &DirPath_ModelsRoot, &EditorDir_ModelsRoot](int32 Index)
+	{
+		PlanObject(Paths_EluXml[Index], FileIndex, FbxPrefilter, SourceFileHashes, DirPath_ModelsRoot, EditorDir_ModelsRoot, ObjectPlans[Index]);
+	});
+
+	// Material instances are shared across elu objects, so only the first elu object of the batch that needs one creates it
+	TSet<uint64> MaterialHashesCreated;
+	for (FEluObjectImportPlan& ObjectPlan : ObjectPlans)
+	{
+		for (FName TextureName : ObjectPlan.MissingTextures)
+		{
+			MissingTextures.FindOrAdd(TextureName)++;
+		}
+
+		for (FName ParentMatName : ObjectPlan.MissingParentMaterials)
+		{
+			MissingParentMaterials.FindOrAdd(ParentMatName)++;
+		}
+
+		// Rejected elu objects are never imported, so they neither create material instances nor cost anything
+		if (ObjectPlan.bRejected)
+		{
+			ObjectPlan.MaterialHashes.Empty();
+			NumObjectsRejected++;
+			continue;
+		}
+
+		for (uint64 MaterialHash : ObjectPlan.MaterialHashes)
+		{
+			if (MIStore.Contains(MaterialHash) || MaterialHashesCreated.Contains(MaterialHash))
+			{
+				ObjectPlan.NumMaterialInstancesToReuse++;
+			}
+			else
+			{
+				MaterialHashesCreated.Add(MaterialHash);
+				ObjectPlan.NumMaterialInstancesToCreate++;
+			}
+		}
+		ObjectPlan.MaterialHashes.Empty();
+
+		EstimateCost(ObjectPlan);
+		Totals.Accumulate(ObjectPlan);
+	}
+
+	// Most used first, that's the order in which they are worth fixing
+	MissingTextures.ValueSort(TGreater<int32>());
+	MissingParentMaterials.ValueSort(TGreater<int32>());
+
+	ImportInfoJsons.Empty();
+
+	BuildSeconds = FPlatformTime::Seconds() - StartTime;
+}
+
+const TArray<FEluObjectImportPlan>& FEluImportPlan::GetObjectPlans() const
+{
+	return ObjectPlans;
+}
+
+const FEluObjectImportPlan& FEluImportPlan::GetTotals() const
+{
+	return Totals;
+}
+
+const TMap<FName, int32>& FEluImportPlan::GetMissingTextures() const
+{
+	return MissingTextures;
+}
+
+const TMap<FName, int32>& FEluImportPlan::GetMissingParentMaterials() const
+{
+	return MissingParentMaterials;
+}
+
+int32 FEluImportPlan::GetNumObjectsRejected() const
+{
+	return NumObjectsRejected;
+}
+
+double FEluImportPlan::GetBuildSeconds() const
+{
+	return BuildSeconds;
+}
+
+void FEluImportPlan::LogSummary() const
+{
+	FString LogMessage;
+
+	LogMessage = FString::Printf(TEXT("Import plan of %d elu objects, built in %.2f seconds:"), ObjectPlans.Num(), BuildSeconds);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	LogMessage = FString::Printf(TEXT("    Meshes: %d to import with %d further LODs, %d up to date, %d filtered out, %d without geometry, %d human meshes that aren't skeletal"),
+		Totals.NumMeshesToImport, Totals.NumMeshLODsToImport, Totals.NumMeshesUpToDate, Totals.NumMeshesFiltered, Totals.NumMeshesWithoutGeometry, Totals.NumHumanMeshesNotSkeletal);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	LogMessage = FString::Printf(TEXT("    Animations: %d to import, %d up to date"), Totals.NumAnimationsToImport, Totals.NumAnimationsUpToDate);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	LogMessage = FString::Printf(TEXT("    Material instances: %d to create, %d to reuse"), Totals.NumMaterialInstancesToCreate, Totals.NumMaterialInstancesToReuse);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	LogMessage = FString::Printf(TEXT("    Missing: %d textures, %d parent materials, %d elu objects rejected for them"), MissingTextures.Num(), MissingParentMaterials.Num(), NumObjectsRejected);
+	if (MissingTextures.Num() + MissingParentMaterials.Num() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+	}
+
+	LogMessage = FString::Printf(TEXT("    Estimate: %.1f minutes, %.1f MB of new packages from %.1f MB of source files"),
+		Totals.EstimatedSeconds / 60.0, Totals.EstimatedDiskBytes / (1024.0 * 1024.0),
+		(Totals.MeshSourceBytesToImport + Totals.AnimationSourceBytesToImport) / (1024.0 * 1024.0));
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+}
+
+bool FEluImportPlan::WriteJson(const FString& FilePath_Plan) const
+{
+	FString LogMessage;
+
+	auto WritePlan = [](TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>>& JsonWriter, const FEluObjectImportPlan& ObjectPlan)
+	{
+		JsonWriter->WriteValue(TEXT("meshes_to_import"), ObjectPlan.NumMeshesToImport);
+		JsonWriter->WriteValue(TEXT("meshes_up_to_date"), ObjectPlan.NumMeshesUpToDate);
+		JsonWriter->WriteValue(TEXT("meshes_filtered"), ObjectPlan.NumMeshesFiltered);
+		JsonWriter->WriteValue(TEXT("meshes_without_geometry"), ObjectPlan.NumMeshesWithoutGeometry);
+		JsonWriter->WriteValue(TEXT("mesh_lods_to_import"), ObjectPlan.NumMeshLODsToImport);
+		JsonWriter->WriteValue(TEXT("human_meshes_not_skeletal"), ObjectPlan.NumHumanMeshesNotSkeletal);
+		JsonWriter->WriteValue(TEXT("animations_to_import"), ObjectPlan.NumAnimationsToImport);
+		JsonWriter->WriteValue(TEXT("animations_up_to_date"), ObjectPlan.NumAnimationsUpToDate);
+		JsonWriter->WriteValue(TEXT("materials"), ObjectPlan.NumMaterials);
+		JsonWriter->WriteValue(TEXT("material_instances_to_create"), ObjectPlan.NumMaterialInstancesToCreate);
+		JsonWriter->WriteValue(TEXT("material_instances_to_reuse"), ObjectPlan.NumMaterialInstancesToReuse);
+		JsonWriter->WriteValue(TEXT("mesh_source_bytes"), (double)ObjectPlan.MeshSourceBytesToImport);
+		JsonWriter->WriteValue(TEXT("animation_source_bytes"), (double)ObjectPlan.AnimationSourceBytesToImport);
+		JsonWriter->WriteValue(TEXT("estimated_seconds"), ObjectPlan.EstimatedSeconds);
+		JsonWriter->WriteValue(TEXT("estimated_disk_bytes"), (double)ObjectPlan.EstimatedDiskBytes);
+	};
+
+	auto WriteNameCounts = [](TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>>& JsonWriter, const TCHAR* Identifier, const TMap<FName, int32>& NameCounts)
+	{
+		JsonWriter->WriteObjectStart(Identifier);
+		for (const TPair<FName, int32>& NameCountPair : NameCounts)
+		{
+			JsonWriter->WriteValue(NameCountPair.Key.ToString(), NameCountPair.Value);
+		}
+		JsonWriter->WriteObjectEnd();
+	};
+
+	FString PlanJson;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&PlanJson);
+
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteValue(TEXT("elu_objects"), ObjectPlans.Num());
+	JsonWriter->WriteValue(TEXT("elu_objects_rejected"), NumObjectsRejected);
+	JsonWriter->WriteValue(TEXT("build_seconds"), BuildSeconds);
+
+	JsonWriter->WriteObjectStart(TEXT("totals"));
+	WritePlan(JsonWriter, Totals);
+	JsonWriter->WriteObjectEnd();
+
+	// Values are the number of elu objects that need the asset
+	WriteNameCounts(JsonWriter, TEXT("missing_textures"), MissingTextures);
+	WriteNameCounts(JsonWriter, TEXT("missing_parent_materials"), MissingParentMaterials);
+
+	JsonWriter->WriteArrayStart(TEXT("objects"));
+	for (const FEluObjectImportPlan& ObjectPlan : ObjectPlans)
+	{
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("elu_xml"), ObjectPlan.FilePath_EluXml);
+		JsonWriter->WriteValue(TEXT("supported"), ObjectPlan.bSupported);
+		JsonWriter->WriteValue(TEXT("rejected"), ObjectPlan.bRejected);
+		WritePlan(JsonWriter, ObjectPlan);
+
+		JsonWriter->WriteArrayStart(TEXT("missing_textures"));
+		for (FName TextureName : ObjectPlan.MissingTextures)
+		{
+			JsonWriter->WriteValue(TextureName.ToString());
+		}
+		JsonWriter->WriteArrayEnd();
+
+		JsonWriter->WriteArrayStart(TEXT("missing_parent_materials"));
+		for (FName ParentMatName : ObjectPlan.MissingParentMaterials)
+		{
+			JsonWriter->WriteValue(ParentMatName.ToString());
+		}
+		JsonWriter->WriteArrayEnd();
+
+		JsonWriter->WriteObjectEnd();
+	}
+	JsonWriter->WriteArrayEnd();
+
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+
+	bool bResult = FFileHelper::SaveStringToFile(PlanJson, *FilePath_Plan);
+	if (!bResult)
+	{
+		LogMessage = FString("Unable to write import plan: ") + FilePath_Plan;
+		UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+	}
+
+	return bResult;
+}
+
+void FEluImportPlan::GatherImportInfos(const FString& EditorDir_ModelsRoot)
+{
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+
+	TArray<FAssetData> AssetDataList;
+	AssetRegistryModule.Get().GetAssetsByPath(FName(*EditorDir_ModelsRoot), AssetDataList, true);
+
+	ImportInfoJsons.Empty(AssetDataList.Num());
+	for (const FAssetData& AssetData : AssetDataList)
+	{
+		FString ImportInfoJson;
+		if (AssetData.GetTagValue(UObject::SourceFileTagName(), ImportInfoJson))
+		{
+			ImportInfoJsons.Add(AssetData.ObjectPath, ImportInfoJson);
+		}
+	}
+}
+
+bool FEluImportPlan::IsAssetUpToDate(const FString& ObjectPath, const FString& FilePath_Source, const FString& FilePath_EluXml, const TArray<FString>& FilePaths_LODs, const FEluFileIndex& FileIndex) const
+{
+	const FString* ImportInfoJson = ImportInfoJsons.Find(FName(*ObjectPath));
+	if (!ImportInfoJson)
+	{
+		return false;
+	}
+
+	TOptional<FAssetImportInfo> ImportInfo = FAssetImportInfo::FromJson(*ImportInfoJson);
+	if (!ImportInfo.IsSet())
+	{
+		return false;
+	}
+
+	TArray<FString> FilePaths_Required;
+	FilePaths_Required.Add(FilePath_Source);
+	if (!FilePath_EluXml.IsEmpty())
+	{
+		FilePaths_Required.Add(FilePath_EluXml);
+	}
+	FilePaths_Required.Append(FilePaths_LODs);
+
+	if (ImportInfo.GetValue().SourceFiles.Num() != FilePaths_Required.Num())
+	{
+		return false;
+	}
+
+	for (const FString& FilePath_Required : FilePaths_Required)
+	{
+		FString FileName_Required = FPaths::GetCleanFilename(FilePath_Required);
+
+		const FAssetImportInfo::FSourceFile* SourceFile = ImportInfo.GetValue().SourceFiles.FindByPredicate([&FileName_Required](const FAssetImportInfo::FSourceFile& File)
+		{
+			return FPaths::GetCleanFilename(File.RelativeFilename) == FileName_Required;
+		});
+
+		// Hashes were recorded too, but checking them would mean reading every source file. The recorded timestamp comes from
+		// IFileManager::GetTimeStamp and the indexed one from a directory listing, which don't always agree on sub-second precision.
+		const FEluIndexedFile* IndexedFile = FileIndex.FindFile(FilePath_Required);
+		if (!SourceFile || !SourceFile->FileHash.IsValid() || !IndexedFile || (SourceFile->Timestamp - IndexedFile->TimeStamp).GetDuration() > FTimespan::FromSeconds(2.0))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FEluImportPlan::IsKnownToHaveNoMesh(const FString& FilePath_EluModel, const FEluFbxPrefilter& FbxPrefilter, const TMap<FString, FMD5Hash>& SourceFileHashes)
+{
+	// The import hashes every model file it imports anyway, so hashing those that aren't hashed yet costs the plan no more than it saves the import
+	const FMD5Hash* KnownFileHash = SourceFileHashes.Find(FilePath_EluModel);
+	FMD5Hash FileHash = KnownFileHash ? *KnownFileHash : UEluProcessor::HashSourceFile(FilePath_EluModel);
+
+	const FEluFbxSceneInfo* SceneInfo = FbxPrefilter.FindSceneInfo(FileHash);
+	return SceneInfo && SceneInfo->IsKnownToHaveNoMesh();
+}
+
+void FEluImportPlan::PlanObject(const FString& FilePath_EluXml, const FEluFileIndex& FileIndex, const FEluFbxPrefilter& FbxPrefilter, const TMap<FString, FMD5Hash>& SourceFileHashes,
+								const FString& DirPath_ModelsRoot, const FString& EditorDir_ModelsRoot, FEluObjectImportPlan& OutObjectPlan) const
+{
+	OutObjectPlan.FilePath_EluXml = FilePath_EluXml;
+	OutObjectPlan.ModelType = UEluProcessor::GetEluModelType(FilePath_EluXml);
+
+	bool bHumanModel = OutObjectPlan.ModelType == EEluModelType::Female || OutObjectPlan.ModelType == EEluModelType::Male;
+	OutObjectPlan.bSupported = bHumanModel ||
+		OutObjectPlan.ModelType == EEluModelType::MapObject ||
+		OutObjectPlan.ModelType == EEluModelType::Monster ||
+		OutObjectPlan.ModelType == EEluModelType::NPC ||
+		OutObjectPlan.ModelType == EEluModelType::Ride ||
+		OutObjectPlan.ModelType == EEluModelType::Sky ||
+		OutObjectPlan.ModelType == EEluModelType::Weapon;
+
+	if (!OutObjectPlan.bSupported)
+	{
+		return;
+	}
+
+	// Without a material info cache the elu.xml file is parsed here, which is safe on any thread. The cache itself isn't
+	FEluImportFilesInfo EluImportFilesInfo(FilePath_EluXml, &FileIndex, nullptr);
+	FString EditorDir_ModelPackage = EluImportFilesInfo.DirPath_EluObject.Replace(*DirPath_ModelsRoot, *EditorDir_ModelsRoot);
+
+	TSet<FString> FilePaths_EluModelLODs;
+	for (const TPair<FString, TArray<FString>>& StaticMeshLODsPair : EluImportFilesInfo.Map_StaticMeshLODs)
+	{
+		FilePaths_EluModelLODs.Append(StaticMeshLODsPair.Value);
+	}
+
+	// Same routing as ImportEluModels
+	bool bHasSkeletalMesh = false;
+	for (const FString& FilePath_EluModel : EluImportFilesInfo.FilePaths_EluModels)
+	{
+		FString FileName_EluModel = FPaths::GetBaseFilename(FilePath_EluModel);
+		bool bSkeletalMesh = FileName_EluModel.StartsWith(TEXT("SK_"));
+
+		if (!bHumanModel && FileName_EluModel.StartsWith(TEXT("S_")))
+		{
+			if (!(FileName_EluModel.Contains(TEXT("_LOD-1")) || FileName_EluModel.Contains(TEXT("_LOD0"))))
+			{
+				// Further LODs are planned along with their LOD0 model
+				if (!FilePaths_EluModelLODs.Contains(FilePath_EluModel))
+				{
+					OutObjectPlan.NumMeshesFiltered++;
+				}
+				continue;
+			}
+		}
+		else if (!bSkeletalMesh && bHumanModel)
+		{
+			OutObjectPlan.NumHumanMeshesNotSkeletal++;
+			continue;
+		}
+		else if (!bSkeletalMesh)
+		{
+			OutObjectPlan.NumMeshesFiltered++;
+			continue;
+		}
+
+		FString MeshName = FileName_EluModel.Replace(TEXT("LOD"), TEXT(""));
+		FString ModelPackageName = PackageTools::SanitizePackageName(EditorDir_ModelPackage + FString("/") + MeshName);
+		FString ModelObjectPath = ModelPackageName + FString(".") + MeshName;
+
+		TArray<FString> FilePaths_LODs = EluImportFilesInfo.Map_StaticMeshLODs.FindRef(FilePath_EluModel);
+		if (IsAssetUpToDate(ModelObjectPath, FilePath_EluModel, FilePath_EluXml, FilePaths_LODs, FileIndex))
+		{
+			bHasSkeletalMesh |= bSkeletalMesh;
+			OutObjectPlan.NumMeshesUpToDate++;
+			continue;
+		}
+
+		// Same verdicts as ImportStaticMesh and ImportSkeletalMesh, which skip these files before creating their package
+		if (IsKnownToHaveNoMesh(FilePath_EluModel, FbxPrefilter, SourceFileHashes))
+		{
+			OutObjectPlan.NumMeshesWithoutGeometry++;
+			continue;
+		}
+
+		// The LOD chain of a static mesh ends at its first file without a mesh
+		for (int32 LODIndex = 0; LODIndex < FilePaths_LODs.Num(); LODIndex++)
+		{
+			if (IsKnownToHaveNoMesh(FilePaths_LODs[LODIndex], FbxPrefilter, SourceFileHashes))
+			{
+				FilePaths_LODs.SetNum(LODIndex);
+				break;
+			}
+		}
+
+		// Animations are only imported for skeletal meshes that exist
+		bHasSkeletalMesh |= bSkeletalMesh;
+		OutObjectPlan.NumMeshesToImport++;
+		OutObjectPlan.NumMeshLODsToImport += FilePaths_LODs.Num();
+
+		FilePaths_LODs.Add(FilePath_EluModel);
+		for (const FString& FilePath_MeshSource : FilePaths_LODs)
+		{
+			const FEluIndexedFile* IndexedFile = FileIndex.FindFile(FilePath_MeshSource);
+			OutObjectPlan.MeshSourceBytesToImport += IndexedFile ? IndexedFile->FileSize : 0;
+		}
+	}
+
+	// Animations of human models are imported by hand
+	if (!bHumanModel && bHasSkeletalMesh)
+	{
+		for (const FString& FilePath_Animation : EluImportFilesInfo.FilePaths_EluAnimations)
+		{
+			FString FileName_Animation = FPaths::GetBaseFilename(FilePath_Animation);
+			FString AniPackageName = PackageTools::SanitizePackageName(EditorDir_ModelPackage + FString("/") + FString("ani") + FString("/") + FileName_Animation);
+			FString AniObjectPath = AniPackageName + FString(".") + FileName_Animation;
+
+			if (IsAssetUpToDate(AniObjectPath, FilePath_Animation, FString(), TArray<FString>(), FileIndex))
+			{
+				OutObjectPlan.NumAnimationsUpToDate++;
+				continue;
+			}
+
+			const FEluIndexedFile* IndexedFile = FileIndex.FindFile(FilePath_Animation);
+			OutObjectPlan.NumAnimationsToImport++;
+			OutObjectPlan.AnimationSourceBytesToImport += IndexedFile ? IndexedFile->FileSize : 0;
+		}
+	}
+
+	OutObjectPlan.NumMaterials = EluImportFilesInfo.Map_EluMatsInfo.Num();
+
+	// Same rule as ValidateBatchMaterials, which checks every elu object of the batch, whether it has meshes to import or not
+	const FEluAssetRegistrySnapshot& AssetRegistrySnapshot = FEluAssetRegistrySnapshot::Get();
+	TSet<uint64> ObjectMaterialHashes;
+	for (const TPair<FString, FEluMatInfo>& EluMatInfoPair : EluImportFilesInfo.Map_EluMatsInfo)
+	{
+		const FEluMatInfo& MatInfo = EluMatInfoPair.Value;
+
+		// Materials are only applied to meshes that are imported. Meshes of the same elu object share the material instances of identical materials
+		uint64 MaterialHash = FEluMaterialInstanceStore::ComputeMaterialHash(MatInfo);
+		if (OutObjectPlan.NumMeshesToImport > 0 && !ObjectMaterialHashes.Contains(MaterialHash))
+		{
+			ObjectMaterialHashes.Add(MaterialHash);
+			OutObjectPlan.MaterialHashes.Add(MaterialHash);
+		}
+
+		FName ParentMatName = FName(*UEluProcessor::GetEditorMatName(MatInfo));
+		if (!AssetRegistrySnapshot.FindParentMaterial(ParentMatName))
+		{
+			OutObjectPlan.MissingParentMaterials.AddUnique(ParentMatName);
+		}
+
+		uint32 RequiredParameters = FEluMatPermutation::GetRequiredParameters(MatInfo.Permutation);
+		for (const FEluMatParameterDesc& ParameterDesc : FEluMatPermutation::GetTextureParameters())
+		{
+			FName TextureName = MatInfo.*ParameterDesc.Texture;
+			if ((RequiredParameters & ParameterDesc.Parameter) && !TextureName.IsNone() && !AssetRegistrySnapshot.FindTexture(TextureName))
+			{
+				OutObjectPlan.MissingTextures.AddUnique(TextureName);
+			}
+		}
+	}
+
+	OutObjectPlan.bRejected = OutObjectPlan.MissingTextures.Num() > 0 || OutObjectPlan.MissingParentMaterials.Num() > 0;
+}
+
+void FEluImportPlan::EstimateCost(FEluObjectImportPlan& ObjectPlan) const
+{
+	const double BytesPerMB = 1024.0 * 1024.0;
+
+	ObjectPlan.EstimatedSeconds =
+		(ObjectPlan.NumMeshesToImport + ObjectPlan.NumMeshLODsToImport) * SecondsPerMesh + ObjectPlan.MeshSourceBytesToImport / BytesPerMB * SecondsPerMeshSourceMB +
+		ObjectPlan.NumAnimationsToImport * SecondsPerAnimation + ObjectPlan.AnimationSourceBytesToImport / BytesPerMB * SecondsPerAnimationSourceMB +
+		ObjectPlan.NumMaterialInstancesToCreate * SecondsPerMaterialInstance;
+
+	ObjectPlan.EstimatedDiskBytes =
+		(int64)(ObjectPlan.MeshSourceBytesToImport * DiskBytesPerMeshSourceByte) +
+		(int64)(ObjectPlan.AnimationSourceBytesToImport * DiskBytesPerAnimationSourceByte) +
+		ObjectPlan.NumMaterialInstancesToCreate * DiskBytesPerMaterialInstance;
+}
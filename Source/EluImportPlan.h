@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EluProcessor.h"
+
+
+/** What ImportEluModels is expected to do with one elu object */
+struct RAIDERZASSETS_API FEluObjectImportPlan
+{
+	FString FilePath_EluXml;
+
+	EEluModelType ModelType;
+
+	/** False for model types ImportEluModels skips as unsupported */
+	bool bSupported;
+
+	/**
+	 * True if the elu object needs a missing texture or parent material, in which case ValidateBatchMaterials rejects it, as it does unattended.
+	 * Its counts are still filled, but left out of the totals and estimates
+	 */
+	bool bRejected;
+
+	/** Meshes whose assets are missing, or whose source files changed since they were imported */
+	int32 NumMeshesToImport;
+
+	/** Meshes whose recorded source file timestamps match the indexed ones. The import itself still compares hashes */
+	int32 NumMeshesUpToDate;
+
+	/** Model files the import never looks at: S_ LODs that don't follow an unbroken chain from _LOD0, and files that are neither S_ nor SK_ */
+	int32 NumMeshesFiltered;
+
+	/** Meshes to import whose fbx file the prefilter found to have no mesh, which the import skips. Files without a cached verdict count as meshes */
+	int32 NumMeshesWithoutGeometry;
+
+	/** LOD files imported along with the static meshes to import, as LOD 1 and up */
+	int32 NumMeshLODsToImport;
+
+	/** Non skeletal model files of human models, each one is reported as an error by the import */
+	int32 NumHumanMeshesNotSkeletal;
+
+	int32 NumAnimationsToImport;
+
+	int32 NumAnimationsUpToDate;
+
+	/** Materials of the elu.xml file. Their material instances are only touched if a mesh of the elu object is imported */
+	int32 NumMaterials;
+
+	int32 NumMaterialInstancesToReuse;
+
+	int32 NumMaterialInstancesToCreate;
+
+	/** Textures and parent materials that don't exist but are needed by the materials of this elu object */
+	TArray<FName> MissingTextures;
+
+	TArray<FName> MissingParentMaterials;
+
+	/** Size of the model and animation files that are going to be imported */
+	int64 MeshSourceBytesToImport;
+
+	int64 AnimationSourceBytesToImport;
+
+	double EstimatedSeconds;
+
+	int64 EstimatedDiskBytes;
+
+	/** Content hashes of the materials that need a material instance, in elu.xml order. Only used while the plan is built */
+	TArray<uint64> MaterialHashes;
+
+	FEluObjectImportPlan();
+
+	void Accumulate(const FEluObjectImportPlan& Other);
+};
+
+
+/**
+ * Dry run of ImportEluModels. Predicts from the file index, the asset registry and the material instance store which meshes and animations
+ * would be imported or skipped, which material instances would be reused or created and which textures and parent materials are missing,
+ * along with a rough estimate of the import time and the size of the new packages. Never creates, loads or modifies any package or object.
+ */
+class RAIDERZASSETS_API FEluImportPlan
+{
+public:
+
+	/**
+	 * Rough cost model. Fbx import time grows with the size of the file, on top of a fixed cost per asset. Each further LOD of a static mesh costs as much as a mesh.
+	 * The defaults are guesses, not calibrated against any import. Phase timings of an import report are what they should be fitted to
+	 */
+	double SecondsPerMesh;
+
+	double SecondsPerMeshSourceMB;
+
+	double SecondsPerAnimation;
+
+	double SecondsPerAnimationSourceMB;
+
+	double SecondsPerMaterialInstance;
+
+	/** Size of the saved packages relative to the size of their source files */
+	double DiskBytesPerMeshSourceByte;
+
+	double DiskBytesPerAnimationSourceByte;
+
+	int64 DiskBytesPerMaterialInstance;
+
+	FEluImportPlan();
+
+	/**
+	 * Plans the import of the given elu.xml files, in parallel. Must be called on the game thread, which only reads the asset registry up front.
+	 * The file index must be current, MIStore validated against the asset registry, and the asset registry snapshot built.
+	 * Model files are looked up in the fbx prefilter by their hash, taken from SourceFileHashes or, for meshes to import, computed on the worker threads.
+	 */
+	void Build(const TArray<FString>& Paths_EluXml, const FEluFileIndex& FileIndex, const FEluMaterialInstanceStore& MIStore, const FEluFbxPrefilter& FbxPrefilter,
+			   const TMap<FString, FMD5Hash>& SourceFileHashes, const FString& DirPath_ModelsRoot, const FString& EditorDir_ModelsRoot);
+
+	const TArray<FEluObjectImportPlan>& GetObjectPlans() const;
+
+	const FEluObjectImportPlan& GetTotals() const;
+
+	/** Missing textures and parent materials of the whole batch, with the number of elu objects that need each of them */
+	const TMap<FName, int32>& GetMissingTextures() const;
+
+	const TMap<FName, int32>& GetMissingParentMaterials() const;
+
+	/** Elu objects ValidateBatchMaterials would reject for their missing textures and parent materials */
+	int32 GetNumObjectsRejected() const;
+
+	double GetBuildSeconds() const;
+
+	void LogSummary() const;
+
+	bool WriteJson(const FString& FilePath_Plan) const;
+
+private:
+
+	TArray<FEluObjectImportPlan> ObjectPlans;
+
+	FEluObjectImportPlan Totals;
+
+	TMap<FName, int32> MissingTextures;
+
+	TMap<FName, int32> MissingParentMaterials;
+
+	int32 NumObjectsRejected;
+
+	double BuildSeconds;
+
+	/** Source file entries recorded in the import data of every asset under the model editor directory, as json, by object path */
+	TMap<FName, FString> ImportInfoJsons;
+
+	void GatherImportInfos(const FString& EditorDir_ModelsRoot);
+
+	/** Same test as UEluProcessor::IsImportedAssetUpToDate, but on the recorded timestamps instead of file hashes */
+	bool IsAssetUpToDate(const FString& ObjectPath, const FString& FilePath_Source, const FString& FilePath_EluXml, const TArray<FString>& FilePaths_LODs, const FEluFileIndex& FileIndex) const;
+
+	/** Same test as the import's, on the cached prefilter verdict of the model file. Only hashes the file if its hash isn't known yet */
+	static bool IsKnownToHaveNoMesh(const FString& FilePath_EluModel, const FEluFbxPrefilter& FbxPrefilter, const TMap<FString, FMD5Hash>& SourceFileHashes);
+
+	void PlanObject(const FString& FilePath_EluXml, const FEluFileIndex& FileIndex, const FEluFbxPrefilter& FbxPrefilter, const TMap<FString, FMD5Hash>& SourceFileHashes,
+					const FString& DirPath_ModelsRoot, const FString& EditorDir_ModelsRoot, FEluObjectImportPlan& OutObjectPlan) const;
+
+	void EstimateCost(FEluObjectImportPlan& ObjectPlan) const;
+
+};
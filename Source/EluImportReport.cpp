@@ -0,0 +1,488 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluImportReport.h"
+
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+
+DECLARE_STATS_GROUP(TEXT("EluImport"), STATGROUP_EluImport, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Elu file discovery"), STAT_EluImport_Discovery, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Elu xml parse"), STAT_EluImport_XmlParse, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Source file hashing"), STAT_EluImport_SourceHash, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Fbx prefilter"), STAT_EluImport_FbxPrefilter, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Texture preload"), STAT_EluImport_TexturePreload, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Fbx import"), STAT_EluImport_FbxImport, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Materials"), STAT_EluImport_Materials, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Material instance creation"), STAT_EluImport_MaterialInstances, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Texture load"), STAT_EluImport_TextureLoad, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Animation import"), STAT_EluImport_Animations, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Package save"), STAT_EluImport_Save, STATGROUP_EluImport);
+DECLARE_CYCLE_STAT(TEXT("Skeletal LOD generation"), STAT_EluImport_SkeletalLODs, STATGROUP_EluImport);
+
+
+FEluObjectImportRecord::FEluObjectImportRecord()
+{
+	bLoaded = false;
+	StartTime = 0.0;
+	TotalSeconds = 0.0;
+	BytesRead = 0;
+
+	for (int32 PhaseIndex = 0; PhaseIndex < (int32)EEluImportPhase::Num; PhaseIndex++)
+	{
+		PhaseSeconds[PhaseIndex] = 0.0;
+	}
+
+	for (int32 CounterIndex = 0; CounterIndex < (int32)EEluImportCounter::Num; CounterIndex++)
+	{
+		Counts[CounterIndex] = 0;
+	}
+}
+
+double FEluObjectImportRecord::GetUntrackedSeconds() const
+{
+	double TrackedSeconds = 0.0;
+	for (int32 PhaseIndex = 0; PhaseIndex < (int32)EEluImportPhase::Num; PhaseIndex++)
+	{
+		TrackedSeconds += PhaseSeconds[PhaseIndex];
+	}
+
+	return FMath::Max(TotalSeconds - TrackedSeconds, 0.0);
+}
+
+void FEluObjectImportRecord::Accumulate(const FEluObjectImportRecord& Other)
+{
+	TotalSeconds += Other.TotalSeconds;
+	BytesRead += Other.BytesRead;
+
+	for (int32 PhaseIndex = 0; PhaseIndex < (int32)EEluImportPhase::Num; PhaseIndex++)
+	{
+		PhaseSeconds[PhaseIndex] += Other.PhaseSeconds[PhaseIndex];
+	}
+
+	for (int32 CounterIndex = 0; CounterIndex < (int32)EEluImportCounter::Num; CounterIndex++)
+	{
+		Counts[CounterIndex] += Other.Counts[CounterIndex];
+	}
+}
+
+FEluImportReport& FEluImportReport::Get()
+{
+	static FEluImportReport ImportReport;
+	return ImportReport;
+}
+
+FEluImportReport::FEluImportReport()
+{
+	bBatchRunning = false;
+	CurrentObjectIndex = INDEX_NONE;
+	PhaseSwitchTime = 0.0;
+}
+
+void FEluImportReport::BeginBatch()
+{
+	RunId = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
+	bBatchRunning = true;
+
+	BatchRecord = FEluObjectImportRecord();
+	BatchRecord.StartTime = FPlatformTime::Seconds();
+	ObjectRecords.Empty();
+	CurrentObjectIndex = INDEX_NONE;
+	PhaseStack.Empty();
+	PhaseSwitchTime = BatchRecord.StartTime;
+}
+
+void FEluImportReport::EndBatch()
+{
+	if (!bBatchRunning)
+	{
+		return;
+	}
+
+	EndObject();
+
+	// Phases left open by an early return are charged up to here
+	double Now = FPlatformTime::Seconds();
+	ChargeOpenPhase(Now);
+	PhaseStack.Empty();
+
+	BatchRecord.TotalSeconds = Now - BatchRecord.StartTime;
+	bBatchRunning = false;
+}
+
+bool FEluImportReport::IsBatchRunning() const
+{
+	return bBatchRunning;
+}
+
+void FEluImportReport::BeginObject(const FString& FilePath_EluXml)
+{
+	if (!bBatchRunning)
+	{
+		return;
+	}
+
+	EndObject();
+
+	double Now = FPlatformTime::Seconds();
+	ChargeOpenPhase(Now);
+
+	CurrentObjectIndex = ObjectRecords.AddDefaulted();
+	FEluObjectImportRecord& ObjectRecord = ObjectRecords[CurrentObjectIndex];
+	ObjectRecord.FilePath_EluXml = FilePath_EluXml;
+	ObjectRecord.StartTime = Now;
+}
+
+void FEluImportReport::EndObject()
+{
+	if (CurrentObjectIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	double Now = FPlatformTime::Seconds();
+	ChargeOpenPhase(Now);
+
+	FEluObjectImportRecord& ObjectRecord = ObjectRecords[CurrentObjectIndex];
+	ObjectRecord.TotalSeconds = Now - ObjectRecord.StartTime;
+	CurrentObjectIndex = INDEX_NONE;
+}
+
+void FEluImportReport::MarkObjectLoaded()
+{
+	if (CurrentObjectIndex != INDEX_NONE)
+	{
+		ObjectRecords[CurrentObjectIndex].bLoaded = true;
+	}
+}
+
+void FEluImportReport::EnterPhase(EEluImportPhase Phase)
+{
+	double Now = FPlatformTime::Seconds();
+	ChargeOpenPhase(Now);
+	PhaseStack.Push(Phase);
+}
+
+void FEluImportReport::LeavePhase()
+{
+	double Now = FPlatformTime::Seconds();
+	ChargeOpenPhase(Now);
+
+	if (PhaseStack.Num() > 0)
+	{
+		PhaseStack.Pop(false);
+	}
+}
+
+void FEluImportReport::AddCount(EEluImportCounter Counter, int32 Count)
+{
+	if (bBatchRunning)
+	{
+		GetCurrentRecord().Counts[(int32)Counter] += Count;
+	}
+}
+
+void FEluImportReport::AddBytesRead(int64 NumBytes)
+{
+	if (bBatchRunning)
+	{
+		GetCurrentRecord().BytesRead += NumBytes;
+	}
+}
+
+void FEluImportReport::AddSkeletalLODRecord(const FEluSkeletalLODRecord& SkeletalLODRecord)
+{
+	if (bBatchRunning)
+	{
+		GetCurrentRecord().SkeletalLODs.Add(SkeletalLODRecord);
+	}
+}
+
+const FEluObjectImportRecord& FEluImportReport::GetBatchRecord() const
+{
+	return BatchRecord;
+}
+
+const TArray<FEluObjectImportRecord>& FEluImportReport::GetObjectRecords() const
+{
+	return ObjectRecords;
+}
+
+FEluObjectImportRecord FEluImportReport::GetTotals() const
+{
+	FEluObjectImportRecord Totals = BatchRecord;
+	for (const FEluObjectImportRecord& ObjectRecord : ObjectRecords)
+	{
+		Totals.Accumulate(ObjectRecord);
+	}
+
+	// Elu objects are part of the batch, their time must not be counted twice
+	Totals.TotalSeconds = BatchRecord.TotalSeconds;
+	return Totals;
+}
+
+FEluObjectImportRecord& FEluImportReport::GetCurrentRecord()
+{
+	return CurrentObjectIndex != INDEX_NONE ? ObjectRecords[CurrentObjectIndex] : BatchRecord;
+}
+
+void FEluImportReport::ChargeOpenPhase(double Now)
+{
+	if (PhaseStack.Num() > 0 && bBatchRunning)
+	{
+		GetCurrentRecord().PhaseSeconds[(int32)PhaseStack.Top()] += Now - PhaseSwitchTime;
+	}
+
+	PhaseSwitchTime = Now;
+}
+
+bool FEluImportReport::WriteJson(const FString& FilePath_Report) const
+{
+	FString LogMessage;
+
+	auto WriteRecord = [](TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>>& JsonWriter, const FEluObjectImportRecord& Record)
+	{
+		JsonWriter->WriteValue(TEXT("total_seconds"), Record.TotalSeconds);
+		JsonWriter->WriteValue(TEXT("untracked_seconds"), Record.GetUntrackedSeconds());
+		JsonWriter->WriteValue(TEXT("bytes_read"), (double)Record.BytesRead);
+
+		// Compares runs with different fbx import options, e.g., with and without UEluProcessor::bApplyFbxImportPresets
+		int32 NumMeshes = Record.Counts[(int32)EEluImportCounter::Meshes];
+		JsonWriter->WriteValue(TEXT("fbx_import_seconds_per_mesh"), NumMeshes > 0 ? Record.PhaseSeconds[(int32)EEluImportPhase::FbxImport] / NumMeshes : 0.0);
+
+		JsonWriter->WriteObjectStart(TEXT("phase_seconds"));
+		for (int32 PhaseIndex = 0; PhaseIndex < (int32)EEluImportPhase::Num; PhaseIndex++)
+		{
+			JsonWriter->WriteValue(FEluImportReport::GetPhaseName((EEluImportPhase)PhaseIndex), Record.PhaseSeconds[PhaseIndex]);
+		}
+		JsonWriter->WriteObjectEnd();
+
+		JsonWriter->WriteObjectStart(TEXT("counts"));
+		for (int32 CounterIndex = 0; CounterIndex < (int32)EEluImportCounter::Num; CounterIndex++)
+		{
+			JsonWriter->WriteValue(FEluImportReport::GetCounterName((EEluImportCounter)CounterIndex), Record.Counts[CounterIndex]);
+		}
+		JsonWriter->WriteObjectEnd();
+	};
+
+	FString ReportJson;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&ReportJson);
+
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteValue(TEXT("run_id"), RunId);
+
+	JsonWriter->WriteObjectStart(TEXT("totals"));
+	WriteRecord(JsonWriter, GetTotals());
+	JsonWriter->WriteObjectEnd();
+
+	JsonWriter->WriteObjectStart(TEXT("batch"));
+	WriteRecord(JsonWriter, BatchRecord);
+	JsonWriter->WriteObjectEnd();
+
+	JsonWriter->WriteArrayStart(TEXT("objects"));
+	for (const FEluObjectImportRecord& ObjectRecord : ObjectRecords)
+	{
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("elu_xml"), ObjectRecord.FilePath_EluXml);
+		JsonWriter->WriteValue(TEXT("loaded"), ObjectRecord.bLoaded);
+		WriteRecord(JsonWriter, ObjectRecord);
+
+		if (ObjectRecord.SkeletalLODs.Num() > 0)
+		{
+			JsonWriter->WriteArrayStart(TEXT("skeletal_lods"));
+			for (const FEluSkeletalLODRecord& SkeletalLODRecord : ObjectRecord.SkeletalLODs)
+			{
+				JsonWriter->WriteObjectStart();
+				JsonWriter->WriteValue(TEXT("mesh"), SkeletalLODRecord.MeshName);
+
+				// Savings are relative to LOD0
+				JsonWriter->WriteArrayStart(TEXT("lods"));
+				for (int32 LODIndex = 0; LODIndex < SkeletalLODRecord.NumTriangles.Num(); LODIndex++)
+				{
+					JsonWriter->WriteObjectStart();
+					JsonWriter->WriteValue(TEXT("triangles"), SkeletalLODRecord.NumTriangles[LODIndex]);
+					JsonWriter->WriteValue(TEXT("bones"), SkeletalLODRecord.NumBones[LODIndex]);
+					JsonWriter->WriteValue(TEXT("triangles_saved"), SkeletalLODRecord.NumTriangles[0] - SkeletalLODRecord.NumTriangles[LODIndex]);
+					JsonWriter->WriteValue(TEXT("bones_saved"), SkeletalLODRecord.NumBones[0] - SkeletalLODRecord.NumBones[LODIndex]);
+					JsonWriter->WriteObjectEnd();
+				}
+				JsonWriter->WriteArrayEnd();
+
+				JsonWriter->WriteObjectEnd();
+			}
+			JsonWriter->WriteArrayEnd();
+		}
+
+		JsonWriter->WriteObjectEnd();
+	}
+	JsonWriter->WriteArrayEnd();
+
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+
+	bool bResult = FFileHelper::SaveStringToFile(ReportJson, *FilePath_Report);
+	if (!bResult)
+	{
+		LogMessage = FString("Unable to write import report: ") + FilePath_Report;
+		UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+	}
+
+	return bResult;
+}
+
+bool FEluImportReport::AppendCsv(const FString& FilePath_Csv) const
+{
+	FString LogMessage;
+	FString Csv;
+
+	if (!IFileManager::Get().FileExists(*FilePath_Csv))
+	{
+		Csv += FString("run_id,elu_xml,loaded,total_seconds,untracked_seconds,bytes_read");
+		for (int32 PhaseIndex = 0; PhaseIndex < (int32)EEluImportPhase::Num; PhaseIndex++)
+		{
+			Csv += FString(",") + FEluImportReport::GetPhaseName((EEluImportPhase)PhaseIndex) + FString("_seconds");
+		}
+		for (int32 CounterIndex = 0; CounterIndex < (int32)EEluImportCounter::Num; CounterIndex++)
+		{
+			Csv += FString(",") + FEluImportReport::GetCounterName((EEluImportCounter)CounterIndex);
+		}
+		Csv += FString("\n");
+	}
+
+	for (const FEluObjectImportRecord& ObjectRecord : ObjectRecords)
+	{
+		// Quoted, elu.xml paths may contain commas
+		Csv += FString::Printf(TEXT("%s,\"%s\",%d,%.4f,%.4f,%lld"), *RunId, *ObjectRecord.FilePath_EluXml.Replace(TEXT("\""), TEXT("\"\"")),
+			ObjectRecord.bLoaded ? 1 : 0, ObjectRecord.TotalSeconds, ObjectRecord.GetUntrackedSeconds(), ObjectRecord.BytesRead);
+
+		for (int32 PhaseIndex = 0; PhaseIndex < (int32)EEluImportPhase::Num; PhaseIndex++)
+		{
+			Csv += FString::Printf(TEXT(",%.4f"), ObjectRecord.PhaseSeconds[PhaseIndex]);
+		}
+		for (int32 CounterIndex = 0; CounterIndex < (int32)EEluImportCounter::Num; CounterIndex++)
+		{
+			Csv += FString::Printf(TEXT(",%d"), ObjectRecord.Counts[CounterIndex]);
+		}
+		Csv += FString("\n");
+	}
+
+	// AutoDetect would switch to UTF-16 with a BOM for non-ANSI paths, and put the BOM in the middle of the appended file
+	bool bResult = FFileHelper::SaveStringToFile(Csv, *FilePath_Csv, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+	if (!bResult)
+	{
+		LogMessage = FString("Unable to append to import report: ") + FilePath_Csv;
+		UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+	}
+
+	return bResult;
+}
+
+const TCHAR* FEluImportReport::GetPhaseName(EEluImportPhase Phase)
+{
+	switch (Phase)
+	{
+	case EEluImportPhase::Discovery:
+		return TEXT("discovery");
+	case EEluImportPhase::XmlParse:
+		return TEXT("xml_parse");
+	case EEluImportPhase::SourceHash:
+		return TEXT("source_hash");
+	case EEluImportPhase::FbxPrefilter:
+		return TEXT("fbx_prefilter");
+	case EEluImportPhase::TexturePreload:
+		return TEXT("texture_preload");
+	case EEluImportPhase::FbxImport:
+		return TEXT("fbx_import");
+	case EEluImportPhase::Materials:
+		return TEXT("materials");
+	case EEluImportPhase::MaterialInstances:
+		return TEXT("material_instances");
+	case EEluImportPhase::TextureLoad:
+		return TEXT("texture_load");
+	case EEluImportPhase::Animations:
+		return TEXT("animations");
+	case EEluImportPhase::Save:
+		return TEXT("save");
+	case EEluImportPhase::SkeletalLODs:
+		return TEXT("skeletal_lods");
+	default:
+		return TEXT("unknown");
+	}
+}
+
+const TCHAR* FEluImportReport::GetCounterName(EEluImportCounter Counter)
+{
+	switch (Counter)
+	{
+	case EEluImportCounter::Meshes:
+		return TEXT("meshes");
+	case EEluImportCounter::Animations:
+		return TEXT("animations");
+	case EEluImportCounter::MaterialSlots:
+		return TEXT("material_slots");
+	case EEluImportCounter::MaterialInstancesCreated:
+		return TEXT("mis_created");
+	case EEluImportCounter::MaterialInstancesReused:
+		return TEXT("mis_reused");
+	case EEluImportCounter::TexturesLoaded:
+		return TEXT("textures_loaded");
+	default:
+		return TEXT("unknown");
+	}
+}
+
+TStatId FEluImportReport::GetPhaseStatId(EEluImportPhase Phase)
+{
+	switch (Phase)
+	{
+	case EEluImportPhase::Discovery:
+		return GET_STATID(STAT_EluImport_Discovery);
+	case EEluImportPhase::XmlParse:
+		return GET_STATID(STAT_EluImport_XmlParse);
+	case EEluImportPhase::SourceHash:
+		return GET_STATID(STAT_EluImport_SourceHash);
+	case EEluImportPhase::FbxPrefilter:
+		return GET_STATID(STAT_EluImport_FbxPrefilter);
+	case EEluImportPhase::TexturePreload:
+		return GET_STATID(STAT_EluImport_TexturePreload);
+	case EEluImportPhase::FbxImport:
+		return GET_STATID(STAT_EluImport_FbxImport);
+	case EEluImportPhase::Materials:
+		return GET_STATID(STAT_EluImport_Materials);
+	case EEluImportPhase::MaterialInstances:
+		return GET_STATID(STAT_EluImport_MaterialInstances);
+	case EEluImportPhase::TextureLoad:
+		return GET_STATID(STAT_EluImport_TextureLoad);
+	case EEluImportPhase::Animations:
+		return GET_STATID(STAT_EluImport_Animations);
+	case EEluImportPhase::Save:
+		return GET_STATID(STAT_EluImport_Save);
+	case EEluImportPhase::SkeletalLODs:
+		return GET_STATID(STAT_EluImport_SkeletalLODs);
+	default:
+		return TStatId();
+	}
+}
+
+FEluImportPhaseScope::FEluImportPhaseScope(EEluImportPhase Phase) : CycleCounter(FEluImportReport::GetPhaseStatId(Phase))
+{
+	// Worker threads, e.g., of the parallel hashing, show up in the cycle stats only
+	bTracked = IsInGameThread();
+	if (bTracked)
+	{
+		FEluImportReport::Get().EnterPhase(Phase);
+	}
+}
+
+FEluImportPhaseScope::~FEluImportPhaseScope()
+{
+	if (bTracked)
+	{
+		FEluImportReport::Get().LeavePhase();
+	}
+}
@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+
+/** Timed phases of an import. Phases nest, each one is only charged for the time not spent in the phases it contains */
+enum class EEluImportPhase : uint8
+{
+	Discovery,
+	XmlParse,
+	SourceHash,
+	FbxPrefilter,
+	TexturePreload,
+	FbxImport,
+	Materials,
+	MaterialInstances,
+	TextureLoad,
+	Animations,
+	Save,
+	SkeletalLODs,
+	Num
+};
+
+enum class EEluImportCounter : uint8
+{
+	Meshes,
+	Animations,
+	MaterialSlots,
+	MaterialInstancesCreated,
+	MaterialInstancesReused,
+	TexturesLoaded,
+	Num
+};
+
+
+/** Triangles and bones of every LOD of a skeletal mesh whose LODs were generated, LOD0 first */
+struct RAIDERZASSETS_API FEluSkeletalLODRecord
+{
+	FString MeshName;
+
+	TArray<int32> NumTriangles;
+
+	TArray<int32> NumBones;
+};
+
+
+struct RAIDERZASSETS_API FEluObjectImportRecord
+{
+	/** Empty for the record of the batch itself, which holds the phases that ran outside of any elu object */
+	FString FilePath_EluXml;
+
+	bool bLoaded;
+
+	double StartTime;
+
+	double TotalSeconds;
+
+	double PhaseSeconds[(int32)EEluImportPhase::Num];
+
+	int32 Counts[(int32)EEluImportCounter::Num];
+
+	/** Size of the source files of the elu object: elu.xml, models and animations */
+	int64 BytesRead;
+
+	/** Only written to the json report. Not accumulated into the totals */
+	TArray<FEluSkeletalLODRecord> SkeletalLODs;
+
+	FEluObjectImportRecord();
+
+	/** Part of TotalSeconds that wasn't spent in any phase */
+	double GetUntrackedSeconds() const;
+
+	void Accumulate(const FEluObjectImportRecord& Other);
+};
+
+
+/**
+ * Collects per elu object phase times and counters of the import, and writes them as a json report of the last batch
+ * and as csv lines that are appended to earlier runs, so that runs can be compared.
+ * Phases are also cycle stats of STATGROUP_EluImport. Only the game thread is tracked.
+ */
+class RAIDERZASSETS_API FEluImportReport
+{
+public:
+
+	static FEluImportReport& Get();
+
+	FEluImportReport();
+
+	void BeginBatch();
+
+	void EndBatch();
+
+	bool IsBatchRunning() const;
+
+	/** Ends the current elu object, if any, and starts recording the given one */
+	void BeginObject(const FString& FilePath_EluXml);
+
+	void EndObject();
+
+	void MarkObjectLoaded();
+
+	void EnterPhase(EEluImportPhase Phase);
+
+	void LeavePhase();
+
+	void AddCount(EEluImportCounter Counter, int32 Count = 1);
+
+	void AddBytesRead(int64 NumBytes);
+
+	void AddSkeletalLODRecord(const FEluSkeletalLODRecord& SkeletalLODRecord);
+
+	const FEluObjectImportRecord& GetBatchRecord() const;
+
+	const TArray<FEluObjectImportRecord>& GetObjectRecords() const;
+
+	/** Sum of the batch record and all elu object records, with the total time of the batch */
+	FEluObjectImportRecord GetTotals() const;
+
+	bool WriteJson(const FString& FilePath_Report) const;
+
+	/** Appends one line per elu object. The header is only written to a new file */
+	bool AppendCsv(const FString& FilePath_Csv) const;
+
+	static const TCHAR* GetPhaseName(EEluImportPhase Phase);
+
+	static const TCHAR* GetCounterName(EEluImportCounter Counter);
+
+	static TStatId GetPhaseStatId(EEluImportPhase Phase);
+
+private:
+
+	/** Start time of the batch, also tells csv lines of different runs apart */
+	FString RunId;
+
+	bool bBatchRunning;
+
+	FEluObjectImportRecord BatchRecord;
+
+	TArray<FEluObjectImportRecord> ObjectRecords;
+
+	int32 CurrentObjectIndex;
+
+	TArray<EEluImportPhase> PhaseStack;
+
+	double PhaseSwitchTime;
+
+	FEluObjectImportRecord& GetCurrentRecord();
+
+	/** Charges the time since the last phase switch to the innermost open phase */
+	void ChargeOpenPhase(double Now);
+
+};
+
+
+/** Times a phase of the import, both for the import report and as a cycle stat */
+class RAIDERZASSETS_API FEluImportPhaseScope
+{
+public:
+
+	explicit FEluImportPhaseScope(EEluImportPhase Phase);
+
+	~FEluImportPhaseScope();
+
+private:
+
+	FScopeCycleCounter CycleCounter;
+
+	bool bTracked;
+
+};
@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluMatInfoCache.h"
+#include "EluXmlMaterialParser.h"
+
+#include "Hash/CityHash.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+const uint32 FEluMatInfoCache::CacheFileMagic = 0x454C4D43;	// 'ELMC'
+// Bump this whenever the serialized layout of FEluMatInfo changes
+const int32 FEluMatInfoCache::CacheFileVersion = 3;
+
+
+FEluMatInfoCacheEntry::FEluMatInfoCacheEntry()
+{
+	ContentHash = 0;
+}
+
+FArchive& operator<<(FArchive& Ar, FEluMatInfoCacheEntry& CacheEntry)
+{
+	Ar << CacheEntry.ContentHash;
+	Ar << CacheEntry.Map_EluMatsInfo;
+	return Ar;
+}
+
+FEluMatInfoCache::FEluMatInfoCache()
+{
+	NumCacheHits = 0;
+	NumCacheMisses = 0;
+	bDirty = false;
+}
+
+bool FEluMatInfoCache::LoadFromFile(const FString& FilePath_Cache)
+{
+	FString LogMessage;
+	Empty();
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *FilePath_Cache, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Ar(FileData);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Ar << Magic;
+	Ar << Version;
+
+	if (Magic != CacheFileMagic || Version != CacheFileVersion)
+	{
+		LogMessage = FString("Discarding outdated elu material cache: ") + FilePath_Cache;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		return false;
+	}
+
+	Ar << Entries;
+
+	if (Ar.IsError())
+	{
+		LogMessage = FString("Elu material cache is corrupted: ") + FilePath_Cache;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		Empty();
+		return false;
+	}
+
+	return true;
+}
+
+bool FEluMatInfoCache::SaveToFile(const FString& FilePath_Cache)
+{
+	FString LogMessage = FString::Printf(TEXT("Elu material cache hits: %d, misses: %d"), NumCacheHits, NumCacheMisses);
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+	if (!bDirty)
+	{
+		return true;
+	}
+
+	TArray<uint8> FileData;
+	FMemoryWriter Ar(FileData);
+
+	uint32 Magic = CacheFileMagic;
+	int32 Version = CacheFileVersion;
+	Ar << Magic;
+	Ar << Version;
+	Ar << Entries;
+
+	bool bResult = FFileHelper::SaveArrayToFile(FileData, *FilePath_Cache);
+	if (bResult)
+	{
+		bDirty = false;
+	}
+
+	return bResult;
+}
+
+void FEluMatInfoCache::Empty()
+{
+	Entries.Empty();
+	NumCacheHits = 0;
+	NumCacheMisses = 0;
+	bDirty = false;
+}
+
+bool FEluMatInfoCache::FindOrParse(const FString& FilePath_EluXml, TMap<FString, FEluMatInfo>& OutMap_EluMatsInfo)
+{
+	FString LogMessage;
+
+	// The same file read is used for hashing and, on a cache miss, for parsing
+	FEluXmlMaterialParser Parser;
+	if (!Parser.LoadFile(FilePath_EluXml))
+	{
+		LogMessage = FString("Unable to read elu xml file: ") + FilePath_EluXml;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		return false;
+	}
+
+	uint64 ContentHash = FEluMatInfoCache::HashFileContent(Parser.GetFileData(), Parser.GetFileSize());
+
+	FEluMatInfoCacheEntry* CacheEntry = Entries.Find(FilePath_EluXml);
+	if (CacheEntry && CacheEntry->ContentHash == ContentHash)
+	{
+		OutMap_EluMatsInfo = CacheEntry->Map_EluMatsInfo;
+		NumCacheHits++;
+		return true;
+	}
+
+	NumCacheMisses++;
+	if (!Parser.Parse(OutMap_EluMatsInfo))
+	{
+		// A failed parse must not be cached, or the file would never be parsed again until it changes. The entry of an older version is stale as well
+		if (CacheEntry)
+		{
+			Entries.Remove(FilePath_EluXml);
+			bDirty = true;
+		}
+
+		LogMessage = FString("Unable to parse elu xml file: ") + FilePath_EluXml;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		return false;
+	}
+
+	FEluMatInfoCacheEntry& NewCacheEntry = Entries.Add(FilePath_EluXml);
+	NewCacheEntry.ContentHash = ContentHash;
+	NewCacheEntry.Map_EluMatsInfo = OutMap_EluMatsInfo;
+	bDirty = true;
+
+	return true;
+}
+
+uint64 FEluMatInfoCache::HashFileContent(const uint8* FileData, int64 FileSize)
+{
+	return CityHash64(reinterpret_cast<const char*>(FileData), FileSize);
+}
+
+void FEluMatInfoCache::GetPermutationUseCounts(TMap<uint32, int32>& OutPermutationUseCounts) const
+{
+	for (const TPair<FString, FEluMatInfoCacheEntry>& EntryPair : Entries)
+	{
+		for (const TPair<FString, FEluMatInfo>& EluMatInfoPair : EntryPair.Value.Map_EluMatsInfo)
+		{
+			OutPermutationUseCounts.FindOrAdd(EluMatInfoPair.Value.Permutation)++;
+		}
+	}
+}
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EluProcessor.h"
+
+
+struct RAIDERZASSETS_API FEluMatInfoCacheEntry
+{
+	uint64 ContentHash;
+
+	TMap<FString, FEluMatInfo> Map_EluMatsInfo;
+
+	FEluMatInfoCacheEntry();
+
+	friend FArchive& operator<<(FArchive& Ar, FEluMatInfoCacheEntry& CacheEntry);
+};
+
+
+/**
+ * Persistent cache of parsed elu.xml material tables, keyed by elu.xml path and validated by a hash of the file content.
+ */
+class RAIDERZASSETS_API FEluMatInfoCache
+{
+public:
+
+	FEluMatInfoCache();
+
+	bool LoadFromFile(const FString& FilePath_Cache);
+
+	bool SaveToFile(const FString& FilePath_Cache);
+
+	void Empty();
+
+	/**
+	 * Fills OutMap_EluMatsInfo from the cache, or parses the elu.xml file (and caches the result) if it changed since it was cached.
+	 * Returns false if the file can't be read or parsed, in which case nothing is cached.
+	 */
+	bool FindOrParse(const FString& FilePath_EluXml, TMap<FString, FEluMatInfo>& OutMap_EluMatsInfo);
+
+	static uint64 HashFileContent(const uint8* FileData, int64 FileSize);
+
+	/** Counts how many cached materials use each material permutation */
+	void GetPermutationUseCounts(TMap<uint32, int32>& OutPermutationUseCounts) const;
+
+private:
+
+	static const uint32 CacheFileMagic;
+
+	static const int32 CacheFileVersion;
+
+	TMap<FString, FEluMatInfoCacheEntry> Entries;
+
+	int32 NumCacheHits;
+
+	int32 NumCacheMisses;
+
+	bool bDirty;
+
+};
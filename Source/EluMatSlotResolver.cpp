@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluMatSlotResolver.h"
+
+
+const int32 FEluMatSlotResolver::MaxSlotNameLen = 63;
+
+
+FEluMatSlotResolver::FEluMatSlotResolver(const TMap<FString, FEluMatInfo>& InMap_EluMatsInfo) :
+	Map_EluMatsInfo(InMap_EluMatsInfo)
+{
+	for (const TPair<FString, FEluMatInfo>& EluMatInfoPair : Map_EluMatsInfo)
+	{
+		if (EluMatInfoPair.Key.Len() > FEluMatSlotResolver::MaxSlotNameLen)
+		{
+			Map_TruncatedMatNames.FindOrAdd(EluMatInfoPair.Key.Left(FEluMatSlotResolver::MaxSlotNameLen)).Add(EluMatInfoPair.Key);
+		}
+	}
+
+	// Map iteration order isn't stable, sorting keeps ambiguous matches deterministic
+	for (TPair<FString, TArray<FString>>& TruncatedMatNamePair : Map_TruncatedMatNames)
+	{
+		TruncatedMatNamePair.Value.Sort();
+	}
+}
+
+const FEluMatInfo* FEluMatSlotResolver::Resolve(const FString& SlotName, FString& OutMatName, EEluMatSlotMatch& OutMatch, TArray<FString>& OutAmbiguousMatNames) const
+{
+	OutMatName.Empty();
+	OutMatch = EEluMatSlotMatch::None;
+	OutAmbiguousMatNames.Empty();
+
+	const FEluMatInfo* MatInfo = FindMatInfo(SlotName, OutMatName, OutMatch, OutAmbiguousMatNames);
+
+	// Strip `_<suffix>` parts from the right, so that the longest matching material name wins
+	FString SlotNamePrefix = SlotName;
+	int32 SeparatorIndex = INDEX_NONE;
+	while (!MatInfo && SlotNamePrefix.FindLastChar(TCHAR('_'), SeparatorIndex) && SeparatorIndex > 0)
+	{
+		SlotNamePrefix = SlotNamePrefix.Left(SeparatorIndex);
+		MatInfo = FindMatInfo(SlotNamePrefix, OutMatName, OutMatch, OutAmbiguousMatNames);
+		if (MatInfo)
+		{
+			OutMatch = EEluMatSlotMatch::SuffixStripped;
+		}
+	}
+
+	return MatInfo;
+}
+
+const FEluMatInfo* FEluMatSlotResolver::FindMatInfo(const FString& Name, FString& OutMatName, EEluMatSlotMatch& OutMatch, TArray<FString>& OutAmbiguousMatNames) const
+{
+	const FEluMatInfo* MatInfo = Map_EluMatsInfo.Find(Name);
+	if (MatInfo)
+	{
+		OutMatName = Name;
+		OutMatch = EEluMatSlotMatch::Exact;
+		return MatInfo;
+	}
+
+	const TArray<FString>* TruncatedMatNames = Map_TruncatedMatNames.Find(Name);
+	if (TruncatedMatNames && TruncatedMatNames->Num() > 0)
+	{
+		if (TruncatedMatNames->Num() > 1)
+		{
+			OutAmbiguousMatNames = *TruncatedMatNames;
+		}
+
+		// Material instances of truncated materials are named after the truncated name, as the slot is
+		OutMatName = Name;
+		OutMatch = EEluMatSlotMatch::Truncated;
+		return Map_EluMatsInfo.Find((*TruncatedMatNames)[0]);
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EluProcessor.h"
+
+
+enum class EEluMatSlotMatch : uint8
+{
+	None,
+	Exact,
+	/** Slot name is the material name cut down to the maximum FName-safe slot name length */
+	Truncated,
+	/** Slot name is the material name followed by a `_<suffix>` added on import */
+	SuffixStripped,
+};
+
+
+/**
+ * Resolves material slot names of imported meshes to the materials of one elu.xml.
+ * Lookup tables are built once, every slot is then resolved with a few hash lookups.
+ */
+class RAIDERZASSETS_API FEluMatSlotResolver
+{
+public:
+
+	/** Material names longer than this are truncated to this length in slot names */
+	static const int32 MaxSlotNameLen;
+
+	explicit FEluMatSlotResolver(const TMap<FString, FEluMatInfo>& InMap_EluMatsInfo);
+
+	/**
+	 * Returns the material info for SlotName, or nullptr if no material matches. OutMatName is the name material instances are named after.
+	 * If several materials match equally well, the lexically smallest name is used and all candidates are returned in OutAmbiguousMatNames.
+	 */
+	const FEluMatInfo* Resolve(const FString& SlotName, FString& OutMatName, EEluMatSlotMatch& OutMatch, TArray<FString>& OutAmbiguousMatNames) const;
+
+private:
+
+	const TMap<FString, FEluMatInfo>& Map_EluMatsInfo;
+
+	/** Truncated material name -> full material names, sorted */
+	TMap<FString, TArray<FString>> Map_TruncatedMatNames;
+
+	const FEluMatInfo* FindMatInfo(const FString& Name, FString& OutMatName, EEluMatSlotMatch& OutMatch, TArray<FString>& OutAmbiguousMatNames) const;
+
+};
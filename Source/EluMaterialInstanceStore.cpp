@@ -0,0 +1,257 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluMaterialInstanceStore.h"
+#include "EluProcessor.h"
+#include "EluAssetRegistrySnapshot.h"
+
+#include "Hash/CityHash.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Materials/MaterialInstanceConstant.h"
+
+
+const uint32 FEluMaterialInstanceStore::StoreFileMagic = 0x454C4D49;	// 'ELMI'
+// Bump this whenever ComputeMaterialHash() changes, so that stale hashes are never matched
+const int32 FEluMaterialInstanceStore::StoreFileVersion = 1;
+
+
+FEluMaterialInstanceStore::FEluMaterialInstanceStore()
+{
+	NumReused = 0;
+	bDirty = false;
+}
+
+bool FEluMaterialInstanceStore::LoadFromFile(const FString& FilePath_Store)
+{
+	FString LogMessage;
+	Empty();
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *FilePath_Store, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Ar(FileData);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Ar << Magic;
+	Ar << Version;
+
+	if (Magic != StoreFileMagic || Version != StoreFileVersion)
+	{
+		LogMessage = FString("Discarding outdated material instance store: ") + FilePath_Store;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		return false;
+	}
+
+	Ar << ObjectPaths;
+
+	if (Ar.IsError())
+	{
+		LogMessage = FString("Material instance store is corrupted: ") + FilePath_Store;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		Empty();
+		return false;
+	}
+
+	return true;
+}
+
+bool FEluMaterialInstanceStore::SaveToFile(const FString& FilePath_Store)
+{
+	FString LogMessage = FString::Printf(TEXT("Material instance store entries: %d, material instances reused by hash: %d"), ObjectPaths.Num(), NumReused);
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+	if (!bDirty)
+	{
+		return true;
+	}
+
+	bool bResult = FEluMaterialInstanceStore::WriteStoreFile(FilePath_Store, ObjectPaths);
+	if (bResult)
+	{
+		bDirty = false;
+	}
+
+	return bResult;
+}
+
+bool FEluMaterialInstanceStore::SaveAddedToFile(const FString& FilePath_Store) const
+{
+	TMap<uint64, FString> AddedObjectPaths;
+	for (uint64 MaterialHash : AddedHashes)
+	{
+		const FString* ObjectPath = ObjectPaths.Find(MaterialHash);
+		if (ObjectPath)
+		{
+			AddedObjectPaths.Add(MaterialHash, *ObjectPath);
+		}
+	}
+
+	return FEluMaterialInstanceStore::WriteStoreFile(FilePath_Store, AddedObjectPaths);
+}
+
+bool FEluMaterialInstanceStore::WriteStoreFile(const FString& FilePath_Store, TMap<uint64, FString>& InObjectPaths)
+{
+	TArray<uint8> FileData;
+	FMemoryWriter Ar(FileData);
+
+	uint32 Magic = StoreFileMagic;
+	int32 Version = StoreFileVersion;
+	Ar << Magic;
+	Ar << Version;
+	Ar << InObjectPaths;
+
+	return FFileHelper::SaveArrayToFile(FileData, *FilePath_Store);
+}
+
+int32 FEluMaterialInstanceStore::ValidateAgainstAssetRegistry()
+{
+	FEluAssetRegistrySnapshot& AssetRegistrySnapshot = FEluAssetRegistrySnapshot::Get();
+	AssetRegistrySnapshot.Build();
+
+	// Material instances deleted or renamed in the editor since the last run must not be handed out again
+	TArray<uint64> StaleHashes;
+	for (const TPair<uint64, FString>& ObjectPathPair : ObjectPaths)
+	{
+		const FAssetData* AssetData = AssetRegistrySnapshot.FindMaterialInstance(FName(*FPackageName::ObjectPathToObjectName(ObjectPathPair.Value)));
+		if (!AssetData || AssetData->ObjectPath != FName(*ObjectPathPair.Value) || AssetData->AssetClass != UMaterialInstanceConstant::StaticClass()->GetFName())
+		{
+			StaleHashes.Add(ObjectPathPair.Key);
+		}
+	}
+
+	for (uint64 StaleHash : StaleHashes)
+	{
+		ObjectPaths.Remove(StaleHash);
+		LoadedMaterialInstances.Remove(StaleHash);
+	}
+
+	if (StaleHashes.Num() > 0)
+	{
+		bDirty = true;
+	}
+
+	return ObjectPaths.Num();
+}
+
+void FEluMaterialInstanceStore::Empty()
+{
+	ObjectPaths.Empty();
+	LoadedMaterialInstances.Empty();
+	AddedHashes.Empty();
+	NumReused = 0;
+	bDirty = false;
+}
+
+uint64 FEluMaterialInstanceStore::ComputeMaterialHash(const FEluMatInfo& MatInfo)
+{
+	// Only what ends up in the material instance takes part in the hash: the parent permutation, its textures, the glow scale and two sided.
+	// Texture names are compared as FNames by the material instance, hence case insensitive.
+	auto TextureKey = [](FName TextureName)
+	{
+		return TextureName.IsNone() ? FString() : TextureName.ToString().ToLower();
+	};
+
+	FString CanonicalString = UEluProcessor::GetEditorMatName(MatInfo);
+	CanonicalString += FString("|") + TextureKey(MatInfo.Texture_DiffuseMap);
+	CanonicalString += FString("|") + TextureKey(MatInfo.Texture_SpecularMap);
+	CanonicalString += FString("|") + TextureKey(MatInfo.Texture_NormalMap);
+	CanonicalString += FString("|") + TextureKey(MatInfo.Texture_SelfIlluminationMap);
+	CanonicalString += FString("|") + TextureKey(MatInfo.Texture_OpacityMap);
+	CanonicalString += FString("|") + TextureKey(MatInfo.Texture_ReflectMap);
+	CanonicalString += FString("|") + TextureKey(MatInfo.Texture_SSSMask);
+	CanonicalString += FString::Printf(TEXT("|%.6f|%d"), MatInfo.Scalar_SelfIllusionScale, MatInfo.bMaterialType_TwoSided ? 1 : 0);
+
+	FTCHARToUTF8 CanonicalStringUtf8(*CanonicalString);
+	return CityHash64(CanonicalStringUtf8.Get(), CanonicalStringUtf8.Length());
+}
+
+UMaterialInstanceConstant* FEluMaterialInstanceStore::FindMaterialInstance(uint64 MaterialHash)
+{
+	TWeakObjectPtr<UMaterialInstanceConstant>* LoadedMaterialInstance = LoadedMaterialInstances.Find(MaterialHash);
+	if (LoadedMaterialInstance && LoadedMaterialInstance->IsValid())
+	{
+		NumReused++;
+		return LoadedMaterialInstance->Get();
+	}
+
+	const FString* ObjectPath = ObjectPaths.Find(MaterialHash);
+	if (!ObjectPath)
+	{
+		return nullptr;
+	}
+
+	UMaterialInstanceConstant* MIConstant = Cast<UMaterialInstanceConstant>(FSoftObjectPath(*ObjectPath).TryLoad());
+	if (!MIConstant)
+	{
+		FString LogMessage = FString("Material instance registered in the store couldn't be loaded: ") + *ObjectPath;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+
+		ObjectPaths.Remove(MaterialHash);
+		LoadedMaterialInstances.Remove(MaterialHash);
+		bDirty = true;
+		return nullptr;
+	}
+
+	LoadedMaterialInstances.Add(MaterialHash, MIConstant);
+	NumReused++;
+	return MIConstant;
+}
+
+void FEluMaterialInstanceStore::AddMaterialInstance(uint64 MaterialHash, UMaterialInstanceConstant* MIConstant)
+{
+	if (!MIConstant)
+	{
+		return;
+	}
+
+	FString ObjectPath = MIConstant->GetPathName();
+	const FString* ExistingObjectPath = ObjectPaths.Find(MaterialHash);
+	if (!ExistingObjectPath || *ExistingObjectPath != ObjectPath)
+	{
+		ObjectPaths.Add(MaterialHash, ObjectPath);
+		AddedHashes.Add(MaterialHash);
+		bDirty = true;
+	}
+
+	LoadedMaterialInstances.Add(MaterialHash, MIConstant);
+}
+
+void FEluMaterialInstanceStore::RemoveMaterialInstance(const FString& ObjectPath)
+{
+	const uint64* MaterialHash = ObjectPaths.FindKey(ObjectPath);
+	if (MaterialHash)
+	{
+		uint64 HashToRemove = *MaterialHash;
+		ObjectPaths.Remove(HashToRemove);
+		LoadedMaterialInstances.Remove(HashToRemove);
+		bDirty = true;
+	}
+}
+
+void FEluMaterialInstanceStore::Append(const FEluMaterialInstanceStore& OtherStore)
+{
+	for (const TPair<uint64, FString>& ObjectPathPair : OtherStore.ObjectPaths)
+	{
+		if (!ObjectPaths.Contains(ObjectPathPair.Key))
+		{
+			ObjectPaths.Add(ObjectPathPair.Key, ObjectPathPair.Value);
+			bDirty = true;
+		}
+	}
+}
+
+bool FEluMaterialInstanceStore::Contains(uint64 MaterialHash) const
+{
+	return ObjectPaths.Contains(MaterialHash);
+}
+
+int32 FEluMaterialInstanceStore::Num() const
+{
+	return ObjectPaths.Num();
+}
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+struct FEluMatInfo;
+class UMaterialInstanceConstant;
+
+
+/**
+ * Maps a canonical hash of FEluMatInfo (parent material, textures, scalars, two sided) to the material instance created for it,
+ * so that identical materials share one material instance regardless of their names.
+ */
+class RAIDERZASSETS_API FEluMaterialInstanceStore
+{
+public:
+
+	FEluMaterialInstanceStore();
+
+	bool LoadFromFile(const FString& FilePath_Store);
+
+	bool SaveToFile(const FString& FilePath_Store);
+
+	/** Writes only the entries added or changed since the store was loaded or emptied, e.g., the material instances created by one import worker */
+	bool SaveAddedToFile(const FString& FilePath_Store) const;
+
+	/** Drops entries whose material instance no longer exists in the asset registry snapshot. Returns the number of entries left. */
+	int32 ValidateAgainstAssetRegistry();
+
+	void Empty();
+
+	static uint64 ComputeMaterialHash(const FEluMatInfo& MatInfo);
+
+	/** Returns the material instance registered for MaterialHash, loading only that object if it isn't in memory yet */
+	UMaterialInstanceConstant* FindMaterialInstance(uint64 MaterialHash);
+
+	void AddMaterialInstance(uint64 MaterialHash, UMaterialInstanceConstant* MIConstant);
+
+	/** Whether a material instance is registered for MaterialHash. Never loads anything, so it can be called from any thread */
+	bool Contains(uint64 MaterialHash) const;
+
+	void RemoveMaterialInstance(const FString& ObjectPath);
+
+	/** Adds the entries of OtherStore whose hash has no material instance here yet */
+	void Append(const FEluMaterialInstanceStore& OtherStore);
+
+	int32 Num() const;
+
+private:
+
+	static const uint32 StoreFileMagic;
+
+	static const int32 StoreFileVersion;
+
+	TMap<uint64, FString> ObjectPaths;
+
+	TMap<uint64, TWeakObjectPtr<UMaterialInstanceConstant>> LoadedMaterialInstances;
+
+	TSet<uint64> AddedHashes;
+
+	int32 NumReused;
+
+	bool bDirty;
+
+	static bool WriteStoreFile(const FString& FilePath_Store, TMap<uint64, FString>& InObjectPaths);
+
+};
@@ -0,0 +1,320 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluMaterialPermutation.h"
+
+#include "Misc/ScopeLock.h"
+#include "HAL/CriticalSection.h"
+
+
+namespace
+{
+	struct FEluPermutationToken
+	{
+		uint32 Permutation;
+		const TCHAR* Token;
+	};
+
+	//~ Parent material names are made of these tokens, in this order: <channels>_<opacity/reflect>_<animations>_mat
+	const FEluPermutationToken ChannelTokens[] =
+	{
+		{ EEluMatPermutation::Diffuse,			TEXT("D") },
+		{ EEluMatPermutation::Specular,			TEXT("S") },
+		{ EEluMatPermutation::Normal,			TEXT("N") },
+		{ EEluMatPermutation::Glow,				TEXT("G") },
+	};
+
+	const FEluPermutationToken AnimationTokens[] =
+	{
+		{ EEluMatPermutation::AnimatedAll,		TEXT("ZP") },
+		{ EEluMatPermutation::AnimatedDiffuse,	TEXT("DP") },
+		{ EEluMatPermutation::AnimatedGlow,		TEXT("GP") },
+		{ EEluMatPermutation::AnimatedNormal,	TEXT("NP") },
+		{ EEluMatPermutation::AnimatedOpacity,	TEXT("TP") },
+		{ EEluMatPermutation::AnimatedSpecular,	TEXT("SP") },
+	};
+
+	const FEluMatParameterDesc TextureParameters[] =
+	{
+		{ EEluMatParameter::Diffuse,		TEXT("Diffuse"),		&FEluMatInfo::Texture_DiffuseMap },
+		{ EEluMatParameter::Specular,		TEXT("Specular"),		&FEluMatInfo::Texture_SpecularMap },
+		{ EEluMatParameter::Normal,			TEXT("Normal"),			&FEluMatInfo::Texture_NormalMap },
+		{ EEluMatParameter::Glow,			TEXT("Glow"),			&FEluMatInfo::Texture_SelfIlluminationMap },
+		{ EEluMatParameter::OpacityMask,	TEXT("OpacityMask"),	&FEluMatInfo::Texture_OpacityMap },
+		{ EEluMatParameter::ReflectMap,		TEXT("ReflectMap"),		&FEluMatInfo::Texture_ReflectMap },
+		{ EEluMatParameter::SSSMask,		TEXT("SSSMask"),		&FEluMatInfo::Texture_SSSMask },
+	};
+
+	const uint32 FaceMatParameters = EEluMatParameter::Diffuse | EEluMatParameter::Specular | EEluMatParameter::Normal | EEluMatParameter::OpacityMask | EEluMatParameter::SSSMask;
+
+	const uint32 BodyMatParameters = EEluMatParameter::Diffuse | EEluMatParameter::Specular | EEluMatParameter::Normal;
+
+	/** Bits that don't select a different parent material */
+	const uint32 InstanceOnlyPermutations = EEluMatPermutation::TwoSided;
+}
+
+
+uint32 FEluMatPermutation::Compute(const FEluMatInfo& MatInfo)
+{
+	uint32 Permutation = EEluMatPermutation::None;
+
+	if (MatInfo.bMaterialType_HumanFace)
+	{
+		Permutation |= EEluMatPermutation::HumanFace;
+	}
+	else if (MatInfo.bMaterialType_HumanBody)
+	{
+		Permutation |= EEluMatPermutation::HumanBody;
+	}
+
+	if (!MatInfo.Texture_DiffuseMap.IsNone())
+	{
+		Permutation |= EEluMatPermutation::Diffuse;
+	}
+	if (!MatInfo.Texture_SpecularMap.IsNone())
+	{
+		Permutation |= EEluMatPermutation::Specular;
+	}
+	if (!MatInfo.Texture_NormalMap.IsNone())
+	{
+		Permutation |= EEluMatPermutation::Normal;
+	}
+	if (!MatInfo.Texture_SelfIlluminationMap.IsNone())
+	{
+		Permutation |= EEluMatPermutation::Glow;
+	}
+	if (!MatInfo.Texture_OpacityMap.IsNone())
+	{
+		Permutation |= EEluMatPermutation::Opacity;
+
+		// Blend model and mask channel only matter if there is an opacity map
+		if (MatInfo.bOpacityBlendModel_Translucent)
+		{
+			Permutation |= EEluMatPermutation::OpacityTranslucent;
+		}
+		if (MatInfo.bOpacityMaskChannel_Alpha)
+		{
+			Permutation |= EEluMatPermutation::OpacityAlpha;
+		}
+	}
+	if (!MatInfo.Texture_ReflectMap.IsNone())
+	{
+		Permutation |= EEluMatPermutation::Reflect;
+	}
+
+	if (MatInfo.bAnimatedTexture_AllTextures)
+	{
+		Permutation |= EEluMatPermutation::AnimatedAll;
+	}
+	if (MatInfo.bAnimatedTexture_Diffuse)
+	{
+		Permutation |= EEluMatPermutation::AnimatedDiffuse;
+	}
+	if (MatInfo.bAnimatedTexture_Glow)
+	{
+		Permutation |= EEluMatPermutation::AnimatedGlow;
+	}
+	if (MatInfo.bAnimatedTexture_Normal)
+	{
+		Permutation |= EEluMatPermutation::AnimatedNormal;
+	}
+	if (MatInfo.bAnimatedTexture_Opacity)
+	{
+		Permutation |= EEluMatPermutation::AnimatedOpacity;
+	}
+	if (MatInfo.bAnimatedTexture_Specular)
+	{
+		Permutation |= EEluMatPermutation::AnimatedSpecular;
+	}
+
+	if (MatInfo.bMaterialType_TwoSided)
+	{
+		Permutation |= EEluMatPermutation::TwoSided;
+	}
+
+	return Permutation;
+}
+
+FName FEluMatPermutation::GetParentMaterialName(uint32 Permutation)
+{
+	static FCriticalSection CriticalSection;
+	static TMap<uint32, FName> ParentMaterialNames;
+
+	Permutation &= ~InstanceOnlyPermutations;
+
+	FScopeLock Lock(&CriticalSection);
+
+	const FName* ParentMaterialName = ParentMaterialNames.Find(Permutation);
+	if (ParentMaterialName)
+	{
+		return *ParentMaterialName;
+	}
+
+	return ParentMaterialNames.Add(Permutation, FName(*FEluMatPermutation::BuildParentMaterialName(Permutation)));
+}
+
+uint32 FEluMatPermutation::GetRequiredParameters(uint32 Permutation)
+{
+	if (Permutation & EEluMatPermutation::HumanFace)
+	{
+		return FaceMatParameters;
+	}
+	else if (Permutation & EEluMatPermutation::HumanBody)
+	{
+		return BodyMatParameters;
+	}
+
+	uint32 Parameters = EEluMatParameter::None;
+
+	if (Permutation & EEluMatPermutation::Diffuse)
+	{
+		Parameters |= EEluMatParameter::Diffuse;
+	}
+	if (Permutation & EEluMatPermutation::Specular)
+	{
+		Parameters |= EEluMatParameter::Specular;
+	}
+	if (Permutation & EEluMatPermutation::Normal)
+	{
+		Parameters |= EEluMatParameter::Normal;
+	}
+	if (Permutation & EEluMatPermutation::Glow)
+	{
+		Parameters |= EEluMatParameter::Glow | EEluMatParameter::GlowIntensity;
+	}
+	if (Permutation & EEluMatPermutation::Opacity)
+	{
+		Parameters |= EEluMatParameter::OpacityMask;
+	}
+	if (Permutation & EEluMatPermutation::Reflect)
+	{
+		Parameters |= EEluMatParameter::ReflectMap;
+	}
+
+	return Parameters;
+}
+
+bool FEluMatPermutation::IsHumanPermutation(uint32 Permutation)
+{
+	return (Permutation & (EEluMatPermutation::HumanFace | EEluMatPermutation::HumanBody)) != 0;
+}
+
+void FEluMatPermutation::GetAllPermutations(TArray<uint32>& OutPermutations)
+{
+	// Human materials ignore every other bit
+	OutPermutations.Add(EEluMatPermutation::HumanFace);
+	OutPermutations.Add(EEluMatPermutation::HumanBody);
+
+	// Blend model and mask channel only exist along with an opacity map
+	const uint32 OpacityPermutations[] =
+	{
+		EEluMatPermutation::None,
+		EEluMatPermutation::Opacity,
+		EEluMatPermutation::Opacity | EEluMatPermutation::OpacityAlpha,
+		EEluMatPermutation::Opacity | EEluMatPermutation::OpacityTranslucent,
+		EEluMatPermutation::Opacity | EEluMatPermutation::OpacityTranslucent | EEluMatPermutation::OpacityAlpha,
+	};
+
+	const int32 NumChannelCombinations = 1 << ARRAY_COUNT(ChannelTokens);
+	const int32 NumAnimationCombinations = 1 << ARRAY_COUNT(AnimationTokens);
+	for (int32 ChannelBits = 0; ChannelBits < NumChannelCombinations; ChannelBits++)
+	{
+		uint32 ChannelPermutation = EEluMatPermutation::None;
+		for (int32 TokenIndex = 0; TokenIndex < ARRAY_COUNT(ChannelTokens); TokenIndex++)
+		{
+			ChannelPermutation |= (ChannelBits & (1 << TokenIndex)) ? ChannelTokens[TokenIndex].Permutation : 0;
+		}
+
+		for (uint32 OpacityPermutation : OpacityPermutations)
+		{
+			for (uint32 ReflectPermutation : { (uint32)EEluMatPermutation::None, (uint32)EEluMatPermutation::Reflect })
+			{
+				for (int32 AnimationBits = 0; AnimationBits < NumAnimationCombinations; AnimationBits++)
+				{
+					uint32 Permutation = ChannelPermutation | OpacityPermutation | ReflectPermutation;
+					for (int32 TokenIndex = 0; TokenIndex < ARRAY_COUNT(AnimationTokens); TokenIndex++)
+					{
+						Permutation |= (AnimationBits & (1 << TokenIndex)) ? AnimationTokens[TokenIndex].Permutation : 0;
+					}
+					OutPermutations.Add(Permutation);
+				}
+			}
+		}
+	}
+}
+
+TArrayView<const FEluMatParameterDesc> FEluMatPermutation::GetTextureParameters()
+{
+	return TArrayView<const FEluMatParameterDesc>(TextureParameters, ARRAY_COUNT(TextureParameters));
+}
+
+const FEluMatParameterDesc* FEluMatPermutation::FindTextureParameter(FName ParameterName)
+{
+	for (const FEluMatParameterDesc& ParameterDesc : TextureParameters)
+	{
+		if (ParameterName == ParameterDesc.ParameterName)
+		{
+			return &ParameterDesc;
+		}
+	}
+
+	return nullptr;
+}
+
+FString FEluMatPermutation::BuildParentMaterialName(uint32 Permutation)
+{
+	if (Permutation & EEluMatPermutation::HumanFace)
+	{
+		return FString("Face_mat");
+	}
+	else if (Permutation & EEluMatPermutation::HumanBody)
+	{
+		return FString("Body_mat");
+	}
+
+	FString ParentMaterialName;
+
+	for (const FEluPermutationToken& ChannelToken : ChannelTokens)
+	{
+		if (Permutation & ChannelToken.Permutation)
+		{
+			ParentMaterialName += ChannelToken.Token;
+		}
+	}
+	ParentMaterialName += TEXT("_");
+
+	if (Permutation & EEluMatPermutation::Opacity)
+	{
+		ParentMaterialName += (Permutation & EEluMatPermutation::OpacityTranslucent) ? TEXT("L") : TEXT("T");
+
+		if (Permutation & EEluMatPermutation::OpacityAlpha)
+		{
+			ParentMaterialName += TEXT("A");
+		}
+	}
+	if (Permutation & EEluMatPermutation::Reflect)
+	{
+		ParentMaterialName += TEXT("RA");
+	}
+
+	if (!ParentMaterialName.EndsWith(TEXT("_")))
+	{
+		ParentMaterialName += TEXT("_");
+	}
+
+	for (const FEluPermutationToken& AnimationToken : AnimationTokens)
+	{
+		if (Permutation & AnimationToken.Permutation)
+		{
+			ParentMaterialName += AnimationToken.Token;
+		}
+	}
+
+	if (!ParentMaterialName.EndsWith(TEXT("_")))
+	{
+		ParentMaterialName += TEXT("_");
+	}
+
+	ParentMaterialName += TEXT("mat");
+
+	return ParentMaterialName;
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EluProcessor.h"
+#include "Containers/ArrayView.h"
+
+
+/** Features of an elu material that select its parent material (and two sided, which is applied on the material instance itself) */
+namespace EEluMatPermutation
+{
+	enum Type : uint32
+	{
+		None				= 0,
+		Diffuse				= 1 << 0,
+		Specular			= 1 << 1,
+		Normal				= 1 << 2,
+		Glow				= 1 << 3,
+		Opacity				= 1 << 4,
+		OpacityTranslucent	= 1 << 5,
+		OpacityAlpha		= 1 << 6,
+		Reflect				= 1 << 7,
+		AnimatedAll			= 1 << 8,
+		AnimatedDiffuse		= 1 << 9,
+		AnimatedGlow		= 1 << 10,
+		AnimatedNormal		= 1 << 11,
+		AnimatedOpacity		= 1 << 12,
+		AnimatedSpecular	= 1 << 13,
+		HumanFace			= 1 << 14,
+		HumanBody			= 1 << 15,
+		TwoSided			= 1 << 16,
+	};
+}
+
+/** Material instance parameters that a parent material expects to be filled */
+namespace EEluMatParameter
+{
+	enum Type : uint32
+	{
+		None				= 0,
+		Diffuse				= 1 << 0,
+		Specular			= 1 << 1,
+		Normal				= 1 << 2,
+		Glow				= 1 << 3,
+		OpacityMask			= 1 << 4,
+		ReflectMap			= 1 << 5,
+		SSSMask				= 1 << 6,
+		GlowIntensity		= 1 << 7,
+	};
+}
+
+
+struct RAIDERZASSETS_API FEluMatParameterDesc
+{
+	EEluMatParameter::Type Parameter;
+
+	/** Parameter name on the parent material */
+	const TCHAR* ParameterName;
+
+	/** Texture of FEluMatInfo that fills the parameter */
+	FName FEluMatInfo::* Texture;
+};
+
+
+/**
+ * Maps the permutation bits of an elu material to its parent material name and to the parameters the parent material needs.
+ */
+struct RAIDERZASSETS_API FEluMatPermutation
+{
+	static uint32 Compute(const FEluMatInfo& MatInfo);
+
+	/** Name of the parent material asset, e.g. DSN_TA_mat. Names are built once per distinct permutation. */
+	static FName GetParentMaterialName(uint32 Permutation);
+
+	static uint32 GetRequiredParameters(uint32 Permutation);
+
+	static bool IsHumanPermutation(uint32 Permutation);
+
+	/** Every permutation Compute can return that selects a parent material of its own, i.e., without the instance only bits */
+	static void GetAllPermutations(TArray<uint32>& OutPermutations);
+
+	/** Texture parameters in the order they are filled */
+	static TArrayView<const FEluMatParameterDesc> GetTextureParameters();
+
+	static const FEluMatParameterDesc* FindTextureParameter(FName ParameterName);
+
+private:
+
+	static FString BuildParentMaterialName(uint32 Permutation);
+
+};
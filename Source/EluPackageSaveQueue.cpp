@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluPackageSaveQueue.h"
+
+#include "Misc/Paths.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+
+FEluPackageSaveQueue::FEluPackageSaveQueue()
+{
+	FlushInterval = 0;
+	NumPackagesSaved = 0;
+	NumSavesAvoided = 0;
+}
+
+void FEluPackageSaveQueue::Enqueue(UPackage* Package)
+{
+	if (!Package)
+	{
+		return;
+	}
+
+	FName PackageName = Package->GetFName();
+	if (PendingPackages.Contains(PackageName))
+	{
+		NumSavesAvoided++;
+		return;
+	}
+
+	PendingPackages.Add(PackageName, Package);
+
+	if (FlushInterval > 0 && PendingPackages.Num() >= FlushInterval)
+	{
+		Flush();
+	}
+}
+
+bool FEluPackageSaveQueue::IsPending(const FString& PackageName) const
+{
+	const TWeakObjectPtr<UPackage>* PendingPackage = PendingPackages.Find(FName(*PackageName));
+	return PendingPackage && PendingPackage->IsValid();
+}
+
+bool FEluPackageSaveQueue::DoesPackageExist(const FString& PackageName) const
+{
+	return IsPending(PackageName) || FPackageName::DoesPackageExist(PackageName);
+}
+
+UPackage* FEluPackageSaveQueue::FindOrLoadPackage(const FString& PackageName) const
+{
+	// A package that was never saved can't be loaded from disk, but it is still in memory
+	const TWeakObjectPtr<UPackage>* PendingPackage = PendingPackages.Find(FName(*PackageName));
+	if (PendingPackage && PendingPackage->IsValid())
+	{
+		return PendingPackage->Get();
+	}
+
+	return LoadPackage(nullptr, *PackageName, LOAD_None);
+}
+
+int32 FEluPackageSaveQueue::Num() const
+{
+	return PendingPackages.Num();
+}
+
+int32 FEluPackageSaveQueue::Flush()
+{
+	FString LogMessage;
+	int32 NumSaved = 0;
+
+	for (TPair<FName, TWeakObjectPtr<UPackage>>& PendingPackagePair : PendingPackages)
+	{
+		UPackage* Package = PendingPackagePair.Value.Get();
+		if (!Package)
+		{
+			continue;
+		}
+
+		FString PackageName = PendingPackagePair.Key.ToString();
+		FString FullPackagePath = FPaths::ProjectContentDir() + PackageName.Replace(TEXT("/Game/"), TEXT(""));
+
+		bool bSaved = UPackage::SavePackage(Package, nullptr, EObjectFlags::RF_Public | EObjectFlags::RF_Standalone,
+											*(FullPackagePath + FPackageName::GetAssetPackageExtension()));
+		if (bSaved)
+		{
+			NumSaved++;
+		}
+		else
+		{
+			LogMessage = FString("Failed to save package: ") + PackageName;
+			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		}
+	}
+
+	PendingPackages.Empty();
+	NumPackagesSaved += NumSaved;
+
+	if (NumSaved > 0)
+	{
+		LogMessage = FString::Printf(TEXT("Saved %d queued packages (total saved: %d, redundant saves avoided: %d)"), NumSaved, NumPackagesSaved, NumSavesAvoided);
+		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+	}
+
+	return NumSaved;
+}
+
+void FEluPackageSaveQueue::Empty()
+{
+	PendingPackages.Empty();
+}
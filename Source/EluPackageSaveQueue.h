@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UPackage;
+
+
+/**
+ * Collects dirty packages and saves each of them once when flushed, instead of saving them every time they are modified.
+ * Packages waiting to be saved are reported as existing, so that package lookups behave as if they were already on disk.
+ */
+class RAIDERZASSETS_API FEluPackageSaveQueue
+{
+public:
+
+	/** Number of pending packages that triggers an automatic flush. 0 means packages are only saved by an explicit Flush() */
+	int32 FlushInterval;
+
+	FEluPackageSaveQueue();
+
+	void Enqueue(UPackage* Package);
+
+	bool IsPending(const FString& PackageName) const;
+
+	/** Same as FPackageName::DoesPackageExist(), but also true for packages that are still waiting to be saved */
+	bool DoesPackageExist(const FString& PackageName) const;
+
+	/** Returns the in-memory package if it is still waiting to be saved, otherwise loads it from disk */
+	UPackage* FindOrLoadPackage(const FString& PackageName) const;
+
+	int32 Num() const;
+
+	/** Saves all pending packages and returns the number of packages written to disk */
+	int32 Flush();
+
+	void Empty();
+
+private:
+
+	TMap<FName, TWeakObjectPtr<UPackage>> PendingPackages;
+
+	int32 NumPackagesSaved;
+
+	int32 NumSavesAvoided;
+
+};
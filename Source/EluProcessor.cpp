@@ -2,12 +2,30 @@
 
 #include "EluProcessor.h"
 #include "EluLibrary.h"
+#include "EluFileIndex.h"
+#include "EluMatInfoCache.h"
+#include "EluXmlMaterialParser.h"
+#include "EluErrorJournal.h"
+#include "EluMaterialPermutation.h"
+#include "EluMatSlotResolver.h"
+#include "EluAssetRegistrySnapshot.h"
+#include "EluFbxPrefilter.h"
+#include "EluImportReport.h"
+#include "EluImportCheckpoint.h"
+#include "EluImportPlan.h"
+#include "EluFbxImportPreset.h"
 
 #include "XmlFile.h"
 #include "Misc/Paths.h"
 #include "ObjectTools.h"
 #include "PackageTools.h"
+#include "HAL/PlatformMemory.h"
+#include "UObject/UObjectGlobals.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "Animation/Skeleton.h"
 #include "MessageDialog.h"
+#include "Misc/App.h"
+#include "Misc/ScopeExit.h"
 #include "Engine/StaticMesh.h"
 #include "Engine/SkeletalMesh.h"
 #include "Editor/EditorEngine.h"
@@ -15,27 +33,64 @@
 #include "AssetRegistryModule.h"
 #include "Misc/FileHelper.h"
 #include "HAL/FileManagerGeneric.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/ParallelFor.h"
+#include "Animation/AnimSequence.h"
+#include "EditorFramework/AssetImportData.h"
 #include "Factories/FbxAnimSequenceImportData.h"
 #include "Materials/MaterialInstanceConstant.h"
 
-#include "Kismet/KismetStringLibrary.h"
 #include "Factories/FbxFactory.h"
+#include "Factories/FbxImportUI.h"
+#include "FbxMeshUtils.h"
+#include "LODUtilities.h"
+#include "MeshBoneReduction.h"
+#include "IMeshReductionInterfaces.h"
+#include "IMeshReductionManagerModule.h"
+#include "Rendering/SkeletalMeshModel.h"
+#include "Engine/SkeletalMeshSocket.h"
 #include "Factories/MaterialInstanceConstantFactoryNew.h"
 
 
 const FString UEluProcessor::DirName_EluAnimations = FString("elu_animations");
 const FString UEluProcessor::DirName_EluModels = FString("elu_model");
+const int32 UEluProcessor::NumObjectsTexturePreloaded = 8;
 
 const FString UEluProcessor::DirPath_AllModels = FString("F:/Game Dev/asset_dest/Model");
 
 const FString UEluProcessor::FilePath_ErrorFile = FString("F:/Game Dev/Unreal Projects/RaiderZAssets/data_files/errors.txt");
 
+const FString UEluProcessor::FilePath_FileIndex = FString("F:/Game Dev/Unreal Projects/RaiderZAssets/data_files/file_index.bin");
+
+const FString UEluProcessor::FilePath_MatInfoCache = FString("F:/Game Dev/Unreal Projects/RaiderZAssets/data_files/mat_info_cache.bin");
+
+const FString UEluProcessor::FilePath_MaterialInstanceStore = FString("F:/Game Dev/Unreal Projects/RaiderZAssets/data_files/mi_store.bin");
+
+const FString UEluProcessor::FilePath_FbxPrefilterCache = FString("F:/Game Dev/Unreal Projects/RaiderZAssets/data_files/fbx_prefilter.bin");
+
+const FString UEluProcessor::FilePath_ImportSummary = FString("F:/Game Dev/Unreal Projects/RaiderZAssets/data_files/import_summary.json");
+
+const FString UEluProcessor::FilePath_ImportReportFile = FString("F:/Game Dev/Unreal Projects/RaiderZAssets/data_files/import_report.json");
+
+const FString UEluProcessor::FilePath_CheckpointFile = FString("F:/Game Dev/Unreal Projects/RaiderZAssets/data_files/import_checkpoint.txt");
+
+const FString UEluProcessor::FilePath_ImportPlan = FString("F:/Game Dev/Unreal Projects/RaiderZAssets/data_files/import_plan.json");
+
+const FString UEluProcessor::DirPath_ImportShards = FString("F:/Game Dev/Unreal Projects/RaiderZAssets/data_files/shards");
+
+const FString UEluProcessor::DirName_SyntheticCorpus = FString("EluBenchmark");
+
 //~ Editor directories
 const FString UEluProcessor::EditorDir_Textures = FString("/Game/EOD/Texture");
 const FString UEluProcessor::EditorDir_SimpleMaterials = FString("/Game/EOD/Mats/RaiderZ_SimpleMats");
 const FString UEluProcessor::EditorDir_HumanSkinMaterials = FString("/Game/EOD/Mats/RaiderZ_HumanSkinMats");
 const FString UEluProcessor::EditorDir_MaterialInstances = FString("/Game/EOD/MIs");
 const FString UEluProcessor::EditorDir_AllModels = FString("/Game/EOD/Model");
+const FString UEluProcessor::EditorDir_SyntheticModels = FString("/Game/EluSynthetic/Model");
+const FString UEluProcessor::EditorDir_SyntheticTextures = FString("/Game/EluSynthetic/Texture");
+const FString UEluProcessor::EditorDir_SyntheticSimpleMaterials = FString("/Game/EluSynthetic/Mats/RaiderZ_SimpleMats");
+const FString UEluProcessor::EditorDir_SyntheticHumanSkinMaterials = FString("/Game/EluSynthetic/Mats/RaiderZ_HumanSkinMats");
+const FString UEluProcessor::EditorDir_SyntheticMaterialInstances = FString("/Game/EluSynthetic/MIs");
 
 
 FEluMatInfo::FEluMatInfo()
@@ -62,11 +117,87 @@ FEluMatInfo::FEluMatInfo()
 	bAnimatedTexture_Glow = false;
 	bAnimatedTexture_Opacity = false;
 
+	Permutation = 0;
 }
 
-FEluImportFilesInfo::FEluImportFilesInfo(const FString & FilePath_EluXml)
+uint16 FEluMatInfo::GetPackedFlags() const
 {
-	IFileManager& FileManager = IFileManager::Get();
+	uint16 PackedFlags = 0;
+	PackedFlags |= bMaterialType_TwoSided << 0;
+	PackedFlags |= bMaterialType_HumanBody << 1;
+	PackedFlags |= bMaterialType_HumanFace << 2;
+	PackedFlags |= bOpacityMaskChannel_Alpha << 3;
+	PackedFlags |= bOpacityBlendModel_Translucent << 4;
+	PackedFlags |= bAnimatedTexture_AllTextures << 5;
+	PackedFlags |= bAnimatedTexture_Diffuse << 6;
+	PackedFlags |= bAnimatedTexture_Specular << 7;
+	PackedFlags |= bAnimatedTexture_Normal << 8;
+	PackedFlags |= bAnimatedTexture_Glow << 9;
+	PackedFlags |= bAnimatedTexture_Opacity << 10;
+	return PackedFlags;
+}
+
+void FEluMatInfo::SetPackedFlags(uint16 PackedFlags)
+{
+	bMaterialType_TwoSided = (PackedFlags >> 0) & 1;
+	bMaterialType_HumanBody = (PackedFlags >> 1) & 1;
+	bMaterialType_HumanFace = (PackedFlags >> 2) & 1;
+	bOpacityMaskChannel_Alpha = (PackedFlags >> 3) & 1;
+	bOpacityBlendModel_Translucent = (PackedFlags >> 4) & 1;
+	bAnimatedTexture_AllTextures = (PackedFlags >> 5) & 1;
+	bAnimatedTexture_Diffuse = (PackedFlags >> 6) & 1;
+	bAnimatedTexture_Specular = (PackedFlags >> 7) & 1;
+	bAnimatedTexture_Normal = (PackedFlags >> 8) & 1;
+	bAnimatedTexture_Glow = (PackedFlags >> 9) & 1;
+	bAnimatedTexture_Opacity = (PackedFlags >> 10) & 1;
+}
+
+FArchive& operator<<(FArchive& Ar, FEluMatInfo& MatInfo)
+{
+	Ar << MatInfo.Texture_DiffuseMap;
+	Ar << MatInfo.Texture_SpecularMap;
+	Ar << MatInfo.Texture_NormalMap;
+	Ar << MatInfo.Texture_SelfIlluminationMap;
+	Ar << MatInfo.Texture_OpacityMap;
+	Ar << MatInfo.Texture_ReflectMap;
+	Ar << MatInfo.Texture_GlossMap;
+	Ar << MatInfo.Texture_SSSMask;
+
+	Ar << MatInfo.Vector_Diffuse;
+	Ar << MatInfo.Vector_Ambient;
+	Ar << MatInfo.Vector_Specular;
+
+	Ar << MatInfo.Scalar_SpecularLevel;
+	Ar << MatInfo.Scalar_Glossiness;
+	Ar << MatInfo.Scalar_SelfIllusionScale;
+
+	// Flags are bit fields, which can't be bound to the archive directly
+	uint16 PackedFlags = MatInfo.GetPackedFlags();
+	Ar << PackedFlags;
+	if (Ar.IsLoading())
+	{
+		MatInfo.SetPackedFlags(PackedFlags);
+	}
+
+	Ar << MatInfo.Permutation;
+
+	return Ar;
+}
+
+static void FindFilesInDirectory(TArray<FString>& OutFileNames, const FString& DirPath, const FString& Extension, const FEluFileIndex* FileIndex)
+{
+	// Directories outside of the indexed tree (or a missing index) fall back to the file system
+	if (FileIndex && FileIndex->FindFiles(OutFileNames, DirPath, Extension))
+	{
+		return;
+	}
+
+	IFileManager::Get().FindFiles(OutFileNames, *DirPath, *Extension);
+}
+
+FEluImportFilesInfo::FEluImportFilesInfo(const FString & FilePath_EluXml, const FEluFileIndex* FileIndex, FEluMatInfoCache* MatInfoCache)
+{
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::Discovery);
 
 	this->FilePath_EluXml = FilePath_EluXml;
 	FString XmlDirPath = FPaths::GetPath(FilePath_EluXml);
@@ -77,7 +208,7 @@ FEluImportFilesInfo::FEluImportFilesInfo(const FString & FilePath_EluXml)
 	FString EluModelDirPath = this->DirPath_EluObject + FString("/") + UEluProcessor::DirName_EluModels;
 	TArray<FString> FileNames_EluModels;
 
-	FileManager.FindFiles(FileNames_EluModels, *EluModelDirPath, *FString("fbx"));
+	FindFilesInDirectory(FileNames_EluModels, EluModelDirPath, FString("fbx"), FileIndex);
 
 	for (FString& EluModelFileName : FileNames_EluModels)
 	{
@@ -87,8 +218,45 @@ FEluImportFilesInfo::FEluImportFilesInfo(const FString & FilePath_EluXml)
 
 	FileNames_EluModels.Empty();
 
+	// The converter writes static meshes as _LOD0 to _LODn files. The ones after _LOD0 become further LODs of the _LOD0 mesh
+	TMap<FString, FString> FilePaths_BaseLODs;
+	TMap<FString, TMap<int32, FString>> FilePaths_HigherLODs;
+	for (const FString& FilePath_EluModel : this->FilePaths_EluModels)
+	{
+		FString BaseName_EluModel;
+		int32 LODIndex = 0;
+		if (!UEluProcessor::ParseStaticMeshLODFileName(FPaths::GetBaseFilename(FilePath_EluModel), BaseName_EluModel, LODIndex))
+		{
+			continue;
+		}
+
+		if (LODIndex == 0)
+		{
+			FilePaths_BaseLODs.Add(BaseName_EluModel, FilePath_EluModel);
+		}
+		else if (LODIndex > 0)
+		{
+			FilePaths_HigherLODs.FindOrAdd(BaseName_EluModel).Add(LODIndex, FilePath_EluModel);
+		}
+	}
+
+	for (const TPair<FString, TMap<int32, FString>>& HigherLODsPair : FilePaths_HigherLODs)
+	{
+		const FString* FilePath_BaseLOD = FilePaths_BaseLODs.Find(HigherLODsPair.Key);
+		if (!FilePath_BaseLOD)
+		{
+			continue;
+		}
+
+		TArray<FString>& FilePaths_LODs = this->Map_StaticMeshLODs.Add(*FilePath_BaseLOD);
+		for (int32 LODIndex = 1; HigherLODsPair.Value.Contains(LODIndex); LODIndex++)
+		{
+			FilePaths_LODs.Add(HigherLODsPair.Value[LODIndex]);
+		}
+	}
+
 	TArray<FString> FileNames_Xml;
-	FileManager.FindFiles(FileNames_Xml, *XmlDirPath, *FString("xml"));
+	FindFilesInDirectory(FileNames_Xml, XmlDirPath, FString("xml"), FileIndex);
 
 	for (FString& FileName_Xml : FileNames_Xml)
 	{
@@ -127,7 +295,7 @@ FEluImportFilesInfo::FEluImportFilesInfo(const FString & FilePath_EluXml)
 	FString DirPath_EluAnimations = this->DirPath_EluObject + FString("/") + UEluProcessor::DirName_EluAnimations;
 	TArray<FString> FileNames_EluAnimations;
 
-	FileManager.FindFiles(FileNames_EluAnimations, *DirPath_EluAnimations, *FString("fbx"));
+	FindFilesInDirectory(FileNames_EluAnimations, DirPath_EluAnimations, FString("fbx"), FileIndex);
 
 	for (FString& FileName_EluAnimation: FileNames_EluAnimations)
 	{
@@ -137,7 +305,14 @@ FEluImportFilesInfo::FEluImportFilesInfo(const FString & FilePath_EluXml)
 
 	FileNames_EluAnimations.Empty();
 
-	UEluProcessor::ParseEluXmlForMaterials(this->FilePath_EluXml, this->Map_EluMatsInfo);
+	if (MatInfoCache)
+	{
+		MatInfoCache->FindOrParse(this->FilePath_EluXml, this->Map_EluMatsInfo);
+	}
+	else
+	{
+		UEluProcessor::ParseEluXmlForMaterials(this->FilePath_EluXml, this->Map_EluMatsInfo);
+	}
 
 }
 
@@ -146,52 +321,83 @@ UEluProcessor::UEluProcessor(const FObjectInitializer & ObjectInitializer) : Sup
 	SkeletalFbxFactory = nullptr;
 	StaticFbxFactory = nullptr;
 	MIConstantFactoryNew = nullptr;
+
+	bUnattended = false;
+	DefaultErrorPolicy = EEluErrorPolicy::Ask;
+	FilePath_ErrorJournal = UEluProcessor::FilePath_ErrorFile;
+	DirPath_ModelsRoot = UEluProcessor::DirPath_AllModels;
+	EditorDir_ModelsRoot = UEluProcessor::EditorDir_AllModels;
+	EditorDir_MIs = UEluProcessor::EditorDir_MaterialInstances;
+	FilePath_ImportReport = UEluProcessor::FilePath_ImportReportFile;
+	FilePath_Checkpoint = UEluProcessor::FilePath_CheckpointFile;
+	bResume = false;
+	bPersistentCaches = true;
+	bReadOnlyCaches = false;
+	MemoryBudgetMB = 0;
+	NumObjectsTexturesRequested = 0;
+	bSaveEachObject = false;
+	bApplyFbxImportPresets = true;
+	bGenerateSkeletalLODs = false;
+	FEluFbxImportPreset::GetDefaultPresets(FbxImportPresets);
+	NumMeshesImported = 0;
+	NumAnimationsImported = 0;
 }
 
 void UEluProcessor::Initialize()
 {
 	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
 
-	TArray<FAssetData> AssetData_Temp;
-	bool bFoundAssets;
-	FName EditorPathToAssets;
+	// Kept up to date by the asset registry events until Uninitialize, so that batches don't query the registry again
+	FEluAssetRegistrySnapshot::Get().Build();
+
+	FEluErrorJournal::Get().Open(FilePath_ErrorJournal);
 
-	AssetDataMap_Textures.Empty();
-	AssetDataMap_SimpleMaterials.Empty();
-	AssetDataMap_HumanSkinMaterials.Empty();
+	// Up-to-date checks of imported models rely on the registry data of everything under EditorDir_ModelsRoot
+	TArray<FString> EditorPathsToScan;
+	EditorPathsToScan.Add(EditorDir_ModelsRoot);
+	AssetRegistryModule.Get().ScanPathsSynchronous(EditorPathsToScan);
 
-	EditorPathToAssets = FName(*PackageTools::SanitizePackageName(UEluProcessor::EditorDir_SimpleMaterials));
-	bFoundAssets = AssetRegistryModule.Get().GetAssetsByPath(EditorPathToAssets, AssetData_Temp, true);
-	if (bFoundAssets)
+	// Index the whole model tree once, so that FEluImportFilesInfo never has to list directories itself
+	if (FileIndex.IsEmpty() && bPersistentCaches)
 	{
-		for (FAssetData AssetData : AssetData_Temp)
-		{
-			AssetDataMap_SimpleMaterials.Add(AssetData.AssetName, AssetData);
-		}
+		FileIndex.LoadFromFile(UEluProcessor::FilePath_FileIndex);
+	}
+	FileIndex.Refresh(DirPath_ModelsRoot);
+	if (bPersistentCaches && !bReadOnlyCaches)
+	{
+		FileIndex.SaveToFile(UEluProcessor::FilePath_FileIndex);
 	}
-	AssetData_Temp.Empty();
 
-	EditorPathToAssets = FName(*PackageTools::SanitizePackageName(UEluProcessor::EditorDir_HumanSkinMaterials));
-	bFoundAssets = AssetRegistryModule.Get().GetAssetsByPath(EditorPathToAssets, AssetData_Temp, true);
-	if (bFoundAssets)
+	if (!MatInfoCache.IsValid())
 	{
-		for (FAssetData AssetData : AssetData_Temp)
+		MatInfoCache = MakeShared<FEluMatInfoCache>();
+		if (bPersistentCaches)
 		{
-			AssetDataMap_HumanSkinMaterials.Add(AssetData.AssetName, AssetData);
+			MatInfoCache->LoadFromFile(UEluProcessor::FilePath_MatInfoCache);
 		}
 	}
-	AssetData_Temp.Empty();
 
-	EditorPathToAssets = FName(*PackageTools::SanitizePackageName(UEluProcessor::EditorDir_Textures));
-	bFoundAssets = AssetRegistryModule.Get().GetAssetsByPath(EditorPathToAssets, AssetData_Temp, true);
-	if (bFoundAssets)
+	// Every permutation seen so far must have a parent material, otherwise its material instances can't be created, and every parent material must fit the permutation table
+	TMap<uint32, int32> PermutationUseCounts;
+	MatInfoCache->GetPermutationUseCounts(PermutationUseCounts);
+	ValidateParentMaterialPermutations(PermutationUseCounts);
+
+	// Material instances have no tags of their own, so the hashes are kept in a side file and checked against the registry
+	TArray<FString> MIPathsToScan;
+	MIPathsToScan.Add(FEluAssetRegistrySnapshot::Get().EditorDir_MaterialInstances);
+	MIPathsToScan.AddUnique(EditorDir_MIs);
+	AssetRegistryModule.Get().ScanPathsSynchronous(MIPathsToScan);
+
+	if (MIStore.Num() == 0 && bPersistentCaches)
 	{
-		for (FAssetData AssetData : AssetData_Temp)
-		{
-			AssetDataMap_Textures.Add(AssetData.AssetName, AssetData);
-		}
+		MIStore.LoadFromFile(UEluProcessor::FilePath_MaterialInstanceStore);
+	}
+	MIStore.ValidateAgainstAssetRegistry();
+
+	if (bPersistentCaches)
+	{
+		FbxPrefilter.LoadFromFile(UEluProcessor::FilePath_FbxPrefilterCache);
 	}
-	AssetData_Temp.Empty();
 
 	//~ begin new code
 	if (SkeletalFbxFactory)
@@ -200,7 +406,6 @@ void UEluProcessor::Initialize()
 		SkeletalFbxFactory->ConditionalBeginDestroy();
 	}
 	SkeletalFbxFactory = NewObject<UFbxFactory>();
-	SkeletalFbxFactory->EnableShowOption();
 
 	if (StaticFbxFactory)
 	{
@@ -208,7 +413,46 @@ void UEluProcessor::Initialize()
 		StaticFbxFactory->ConditionalBeginDestroy();
 	}
 	StaticFbxFactory = NewObject<UFbxFactory>();
-	StaticFbxFactory->EnableShowOption();
+
+	if (bUnattended)
+	{
+		// Without the options dialog the mesh type can't be picked by hand, so it's fixed per factory
+		SkeletalFbxFactory->ImportUI->bAutomatedImportShouldDetectType = false;
+		SkeletalFbxFactory->ImportUI->MeshTypeToImport = FBXIT_SkeletalMesh;
+		SkeletalFbxFactory->ImportUI->bImportAsSkeletal = true;
+		SkeletalFbxFactory->ImportUI->bImportAnimations = false;
+
+		StaticFbxFactory->ImportUI->bAutomatedImportShouldDetectType = false;
+		StaticFbxFactory->ImportUI->MeshTypeToImport = FBXIT_StaticMesh;
+		StaticFbxFactory->ImportUI->bImportAsSkeletal = false;
+		StaticFbxFactory->ImportUI->bImportAnimations = false;
+	}
+	else
+	{
+		SkeletalFbxFactory->EnableShowOption();
+		StaticFbxFactory->EnableShowOption();
+	}
+
+	if (bGenerateSkeletalLODs)
+	{
+		IMeshReductionManagerModule& ReductionManagerModule = FModuleManager::Get().LoadModuleChecked<IMeshReductionManagerModule>("MeshReductionInterface");
+		IMeshReduction* SkeletalMeshReduction = ReductionManagerModule.GetSkeletalMeshReductionInterface();
+		if (!SkeletalMeshReduction || !SkeletalMeshReduction->IsSupported())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("No skeletal mesh reduction is available. Skeletal meshes are imported without generated LODs"));
+			bGenerateSkeletalLODs = false;
+		}
+	}
+
+	if (bApplyFbxImportPresets)
+	{
+		UEnum* ModelTypeEnum = FindObject<UEnum>(ANY_PACKAGE, TEXT("EEluModelType"), true);
+		for (const TPair<EEluModelType, FEluFbxImportPreset>& PresetPair : FbxImportPresets)
+		{
+			FString LogMessage = FString("Fbx import preset for ") + (ModelTypeEnum ? ModelTypeEnum->GetNameStringByValue((int64)PresetPair.Key) : FString()) + FString(": ") + PresetPair.Value.ToString();
+			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+		}
+	}
 
 	if (!MIConstantFactoryNew)
 	{
@@ -237,9 +481,44 @@ void UEluProcessor::Initialize()
 
 void UEluProcessor::Uninitialize()
 {
-	AssetDataMap_Textures.Empty();
-	AssetDataMap_SimpleMaterials.Empty();
-	AssetDataMap_HumanSkinMaterials.Empty();
+	// Packages may still be pending if the last batch was cancelled
+	MISaveQueue.Flush();
+
+	CurrentObjectPackages.Empty();
+	FinishedObjectPackages.Empty();
+
+	ReleaseBatchTextures();
+
+	FEluErrorJournal::Get().Close();
+
+	Checkpoint.Close();
+
+	// Keeps the files re-stat'ed by the batches, so that the next Refresh starts from their current sizes and mtimes
+	if (bPersistentCaches && !bReadOnlyCaches)
+	{
+		FileIndex.SaveToFile(UEluProcessor::FilePath_FileIndex);
+	}
+	FileIndex.Empty();
+
+	if (bPersistentCaches && !bReadOnlyCaches)
+	{
+		if (MatInfoCache.IsValid())
+		{
+			MatInfoCache->SaveToFile(UEluProcessor::FilePath_MatInfoCache);
+		}
+
+		MIStore.SaveToFile(UEluProcessor::FilePath_MaterialInstanceStore);
+		FbxPrefilter.SaveToFile(UEluProcessor::FilePath_FbxPrefilterCache);
+	}
+
+	if (!FilePath_ExportedMIStore.IsEmpty())
+	{
+		MIStore.SaveAddedToFile(FilePath_ExportedMIStore);
+	}
+
+	MatInfoCache.Reset();
+	MIStore.Empty();
+	FbxPrefilter.Empty();
 
 	if (SkeletalFbxFactory)
 	{
@@ -260,7 +539,7 @@ void UEluProcessor::Uninitialize()
 	}
 }
 
-UStaticMesh * UEluProcessor::ImportStaticMesh(const FString& FilePath_EluModel, const FString& EditorDir_ModelPackage, EImportResult& Result)
+UStaticMesh * UEluProcessor::ImportStaticMesh(const FString & FilePath_EluModel, const TArray<FString>& FilePaths_EluModelLODs, const FString & EditorDir_ModelPackage, const FString & FilePath_EluXml, EImportResult& Result)
 {
 	FString LogMessage;
 	UStaticMesh* StaticMesh = nullptr;
@@ -271,6 +550,25 @@ UStaticMesh * UEluProcessor::ImportStaticMesh(const FString& FilePath_EluModel,
 	FString ModelPackageName = EditorDir_ModelPackage + FString("/") + StaticMeshName;
 	ModelPackageName = PackageTools::SanitizePackageName(ModelPackageName);
 
+	FString ModelObjectPath = ModelPackageName + FString(".") + StaticMeshName;
+	if (IsImportedAssetUpToDate(ModelObjectPath, FilePath_EluModel, FilePath_EluXml, FilePaths_EluModelLODs))
+	{
+		LogMessage = ModelPackageName + FString(" is up to date. Skipping import.");
+		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+		Result = EImportResult::Skipped;
+		return StaticMesh;
+	}
+
+	// Files the pre-pass found no mesh in would only get a package created and destroyed again
+	const FEluFbxSceneInfo* SceneInfo = FbxPrefilter.FindSceneInfo(GetSourceFileHash(FilePath_EluModel));
+	if (SceneInfo && SceneInfo->IsKnownToHaveNoMesh())
+	{
+		LogMessage = FString::Printf(TEXT("Fbx file has no mesh (%s, %d nodes). Skipping import of static model: %s"), FEluFbxPrefilter::GetSceneKindName(SceneInfo->SceneKind), SceneInfo->NumNodes, *FileName_EluModel);
+		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+		Result = EImportResult::Failure;
+		return StaticMesh;
+	}
+
 	UPackage* ModelPackage = nullptr;
 	if (FPackageName::DoesPackageExist(ModelPackageName))
 	{
@@ -289,13 +587,22 @@ UStaticMesh * UEluProcessor::ImportStaticMesh(const FString& FilePath_EluModel,
 		ModelPackage->FullyLoad();
 	}
 
+	if (bApplyFbxImportPresets)
+	{
+		GetFbxImportPreset(UEluProcessor::GetEluModelType(FilePath_EluXml)).ApplyToStaticMesh(StaticFbxFactory->ImportUI);
+	}
+
 	bool bImportCancelled = false;
-	UObject* ImportedModel = StaticFbxFactory->ImportObject(UStaticMesh::StaticClass(),
-															ModelPackage, FName(*StaticMeshName),
-															EObjectFlags::RF_Standalone | EObjectFlags::RF_Public,
-															FilePath_EluModel,
-															nullptr,
-															bImportCancelled);
+	UObject* ImportedModel = nullptr;
+	{
+		FEluImportPhaseScope PhaseScope(EEluImportPhase::FbxImport);
+		ImportedModel = StaticFbxFactory->ImportObject(UStaticMesh::StaticClass(),
+														ModelPackage, FName(*StaticMeshName),
+														EObjectFlags::RF_Standalone | EObjectFlags::RF_Public,
+														FilePath_EluModel,
+														nullptr,
+														bImportCancelled);
+	}
 
 	// If user cancelled import, stop further processing
 	if (bImportCancelled)
@@ -333,15 +640,87 @@ UStaticMesh * UEluProcessor::ImportStaticMesh(const FString& FilePath_EluModel,
 	if (!StaticMesh)
 	{
 		LogMessage = FString("Unabled to cast imported mesh to static mesh. Imported model name: ") + FilePath_EluModel;
-		UEluProcessor::AddError(LogMessage);
+		UEluProcessor::AddError(EEluErrorKind::MeshCastFailed, FilePath_EluXml, StaticMeshName, FString(), LogMessage);
 		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
 		Result = EImportResult::Failure;
 	}
+	else
+	{
+		ImportStaticMeshLODs(StaticMesh, FilePaths_EluModelLODs, FilePath_EluXml);
+	}
 
 	return StaticMesh;
 }
 
-USkeletalMesh * UEluProcessor::ImportSkeletalMesh(const FString & FilePath_EluModel, const FString & EditorDir_ModelPackage, EImportResult& Result)
+int32 UEluProcessor::ImportStaticMeshLODs(UStaticMesh* StaticMesh, const TArray<FString>& FilePaths_EluModelLODs, const FString& FilePath_EluXml)
+{
+	check(StaticMesh);
+
+	FString LogMessage;
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::FbxImport);
+
+	// Reimporting LOD0 keeps the LODs of the previous import, which may have come from more LOD files
+	bool bRemovedLODs = StaticMesh->SourceModels.Num() > 1;
+	if (bRemovedLODs)
+	{
+		StaticMesh->SetNumSourceModels(1);
+	}
+
+	const FEluFbxImportPreset& Preset = GetFbxImportPreset(UEluProcessor::GetEluModelType(FilePath_EluXml));
+	if (FilePaths_EluModelLODs.Num() > 0)
+	{
+		StaticMesh->bAutoComputeLODScreenSize = !bApplyFbxImportPresets || Preset.LODScreenSizes.Num() == 0;
+	}
+
+	int32 NumLODsImported = 0;
+	for (const FString& FilePath_EluModelLOD : FilePaths_EluModelLODs)
+	{
+		int32 LODIndex = NumLODsImported + 1;
+
+		const FEluFbxSceneInfo* SceneInfo = FbxPrefilter.FindSceneInfo(GetSourceFileHash(FilePath_EluModelLOD));
+		if (SceneInfo && SceneInfo->IsKnownToHaveNoMesh())
+		{
+			LogMessage = FString::Printf(TEXT("Fbx file has no mesh. Static model keeps %d LODs: "), LODIndex) + FPaths::GetBaseFilename(FilePath_EluModelLOD);
+			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+			break;
+		}
+
+		// The source model is added before the LOD is imported, so that the build at the end of the LOD import already uses its screen size
+		StaticMesh->SetNumSourceModels(LODIndex + 1);
+		if (!StaticMesh->bAutoComputeLODScreenSize)
+		{
+			StaticMesh->SourceModels[LODIndex].ScreenSize = Preset.GetLODScreenSize(LODIndex);
+		}
+
+		if (!FbxMeshUtils::ImportStaticMeshLOD(StaticMesh, FilePath_EluModelLOD, LODIndex))
+		{
+			// LODs can't have gaps, the rest of the chain is left out
+			StaticMesh->SetNumSourceModels(LODIndex);
+
+			LogMessage = FString::Printf(TEXT("Unable to import LOD %d. Static model keeps %d LODs: "), LODIndex, LODIndex) + FPaths::GetBaseFilename(FilePath_EluModelLOD);
+			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+			break;
+		}
+
+		NumLODsImported++;
+	}
+
+	// Every imported LOD rebuilt the mesh already
+	if (NumLODsImported == 0 && bRemovedLODs)
+	{
+		StaticMesh->PostEditChange();
+	}
+
+	if (NumLODsImported > 0)
+	{
+		LogMessage = FString::Printf(TEXT("Imported %d LODs of static mesh: "), NumLODsImported) + StaticMesh->GetName();
+		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+	}
+
+	return NumLODsImported;
+}
+
+USkeletalMesh * UEluProcessor::ImportSkeletalMesh(const FString & FilePath_EluModel, const FString & EditorDir_ModelPackage, const FString & FilePath_EluXml, EImportResult& Result)
 {
 	FString LogMessage;
 	USkeletalMesh* SkeletalMesh = nullptr;
@@ -352,6 +731,31 @@ USkeletalMesh * UEluProcessor::ImportSkeletalMesh(const FString & FilePath_EluMo
 	FString ModelPackageName = EditorDir_ModelPackage + FString("/") + SkeletalMeshName;
 	ModelPackageName = PackageTools::SanitizePackageName(ModelPackageName);
 
+	FString ModelObjectPath = ModelPackageName + FString(".") + SkeletalMeshName;
+	if (IsImportedAssetUpToDate(ModelObjectPath, FilePath_EluModel, FilePath_EluXml))
+	{
+		LogMessage = ModelPackageName + FString(" is up to date. Skipping import.");
+		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+		Result = EImportResult::Skipped;
+
+		// The LOD stage runs after the import, so an up to date mesh may still miss the LODs of the current preset
+		if (bGenerateSkeletalLODs)
+		{
+			SkeletalMesh = LoadObject<USkeletalMesh>(nullptr, *ModelObjectPath);
+		}
+		return SkeletalMesh;
+	}
+
+	// Files the pre-pass found no mesh in would only get a package created and destroyed again
+	const FEluFbxSceneInfo* SceneInfo = FbxPrefilter.FindSceneInfo(GetSourceFileHash(FilePath_EluModel));
+	if (SceneInfo && SceneInfo->IsKnownToHaveNoMesh())
+	{
+		LogMessage = FString::Printf(TEXT("Fbx file has no mesh (%s, %d nodes). Skipping import of skeletal model: %s"), FEluFbxPrefilter::GetSceneKindName(SceneInfo->SceneKind), SceneInfo->NumNodes, *FileName_EluModel);
+		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+		Result = EImportResult::Failure;
+		return SkeletalMesh;
+	}
+
 	UPackage* ModelPackage = nullptr;
 	if (FPackageName::DoesPackageExist(ModelPackageName))
 	{
@@ -370,13 +774,38 @@ USkeletalMesh * UEluProcessor::ImportSkeletalMesh(const FString & FilePath_EluMo
 		ModelPackage->FullyLoad();
 	}
 
+	USkeleton* ReusedSkeleton = nullptr;
+	if (bApplyFbxImportPresets)
+	{
+		const FEluFbxImportPreset& Preset = GetFbxImportPreset(UEluProcessor::GetEluModelType(FilePath_EluXml));
+		if (Preset.bReuseSkeleton)
+		{
+			ReusedSkeleton = FindObjectSkeleton(EditorDir_ModelPackage, SkeletalMeshName);
+		}
+
+		// The fbx factory fails the whole import if the bone hierarchy doesn't fit, so a mesh that doesn't gets a skeleton of its own right away
+		if (ReusedSkeleton && !(SceneInfo && UEluProcessor::IsSkeletonCompatible(*SceneInfo, ReusedSkeleton)))
+		{
+			LogMessage = FString("Skeletal model doesn't fit the skeleton of its elu object, importing it with a new skeleton: ") + FileName_EluModel;
+			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+			ReusedSkeleton = nullptr;
+		}
+
+		Preset.ApplyToSkeletalMesh(SkeletalFbxFactory->ImportUI, ReusedSkeleton);
+	}
+
 	bool bImportCancelled = false;
-	UObject* ImportedModel = SkeletalFbxFactory->ImportObject(UStaticMesh::StaticClass(),
-															  ModelPackage, FName(*SkeletalMeshName),
-															  EObjectFlags::RF_Standalone | EObjectFlags::RF_Public,
-															  FilePath_EluModel,
-															  nullptr,
-															  bImportCancelled);
+	UObject* ImportedModel = nullptr;
+	{
+		FEluImportPhaseScope PhaseScope(EEluImportPhase::FbxImport);
+		ImportedModel = SkeletalFbxFactory->ImportObject(UStaticMesh::StaticClass(),
+														  ModelPackage, FName(*SkeletalMeshName),
+														  EObjectFlags::RF_Standalone | EObjectFlags::RF_Public,
+														  FilePath_EluModel,
+														  nullptr,
+														  bImportCancelled);
+
+	}
 
 	// If user cancelled import, stop further processing
 	if (bImportCancelled)
@@ -414,186 +843,375 @@ USkeletalMesh * UEluProcessor::ImportSkeletalMesh(const FString & FilePath_EluMo
 	if (!SkeletalMesh)
 	{
 		LogMessage = FString("Unabled to cast imported mesh to skeletal mesh. Imported model name: ") + FilePath_EluModel;
-		UEluProcessor::AddError(LogMessage);
+		UEluProcessor::AddError(EEluErrorKind::MeshCastFailed, FilePath_EluXml, SkeletalMeshName, FString(), LogMessage);
 		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
 		Result = EImportResult::Failure;
 	}
+	else if (SkeletalMesh->Skeleton)
+	{
+		TWeakObjectPtr<USkeleton>& ObjectSkeleton = ObjectSkeletons.FindOrAdd(EditorDir_ModelPackage);
+		if (!ObjectSkeleton.IsValid())
+		{
+			ObjectSkeleton = SkeletalMesh->Skeleton;
+		}
+	}
 
 	return SkeletalMesh;
 }
 
-FString UEluProcessor::GetTextureNameFromXmlNode(FXmlNode* XmlNode)
+const FEluFbxImportPreset& UEluProcessor::GetFbxImportPreset(EEluModelType ModelType) const
 {
-	FString TextureName;
-
-	if (XmlNode)
-	{
-		FString ChildContent = XmlNode->GetContent();
-		TArray<FString> ChildContentSplitArray;
-		ChildContent.ParseIntoArray(ChildContentSplitArray, *FString("."));
-		if (ChildContentSplitArray.Num() > 0)
-		{
-			TextureName = FString("T_") + ObjectTools::SanitizeObjectName(ChildContentSplitArray[0]);
-		}
-	}
+	static const FEluFbxImportPreset DefaultPreset;
 
-	return TextureName;
+	const FEluFbxImportPreset* Preset = FbxImportPresets.Find(ModelType);
+	return Preset ? *Preset : DefaultPreset;
 }
 
-FString UEluProcessor::GetEditorMatName(FEluMatInfo MatInfo)
+bool UEluProcessor::IsSkeletonCompatible(const FEluFbxSceneInfo& SceneInfo, const USkeleton* Skeleton)
 {
-	if (MatInfo.bMaterialType_HumanFace)
+	const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+	if (SceneInfo.RootBoneName.IsNone() || RefSkeleton.GetRawBoneNum() == 0 || RefSkeleton.GetBoneName(0) != SceneInfo.RootBoneName)
 	{
-		return FString("Face_mat");
+		return false;
 	}
-	else if (MatInfo.bMaterialType_HumanBody)
+
+	// Same rule as USkeleton::IsCompatibleMesh: bones the skeleton has must hang from the same parent, the others are merged into it
+	for (int32 BoneIndex = 0; BoneIndex < SceneInfo.BoneNames.Num(); BoneIndex++)
 	{
-		return FString("Body_mat");
+		int32 SkeletonBoneIndex = RefSkeleton.FindBoneIndex(SceneInfo.BoneNames[BoneIndex]);
+		if (SkeletonBoneIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		int32 SkeletonParentIndex = RefSkeleton.GetParentIndex(SkeletonBoneIndex);
+		FName SkeletonParentName = SkeletonParentIndex != INDEX_NONE ? RefSkeleton.GetBoneName(SkeletonParentIndex) : NAME_None;
+		if (SkeletonParentName != SceneInfo.BoneParentNames[BoneIndex])
+		{
+			return false;
+		}
 	}
 
-	FString EditorMatName = FString("");
+	return true;
+}
 
-	if (!MatInfo.Texture_DiffuseMap.IsEmpty())
-	{
-		EditorMatName += FString("D");
-	}
-	if (!MatInfo.Texture_SpecularMap.IsEmpty())
-	{
-		EditorMatName += FString("S");
-	}
-	if (!MatInfo.Texture_NormalMap.IsEmpty())
-	{
-		EditorMatName += FString("N");
-	}
-	if (!MatInfo.Texture_SelfIlluminationMap.IsEmpty())
+USkeleton* UEluProcessor::FindObjectSkeleton(const FString& EditorDir_ModelPackage, const FString& SkeletalMeshName)
+{
+	TWeakObjectPtr<USkeleton>& ObjectSkeleton = ObjectSkeletons.FindOrAdd(EditorDir_ModelPackage);
+	if (ObjectSkeleton.IsValid())
 	{
-		EditorMatName += FString("G");
+		return ObjectSkeleton.Get();
 	}
-	EditorMatName += "_";
 
-	if (!MatInfo.Texture_OpacityMap.IsEmpty())
+	// Skeletons of earlier imports, e.g., when only some of the meshes of the elu object changed
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	TArray<FAssetData> AssetDatas;
+	AssetRegistryModule.Get().GetAssetsByPath(FName(*EditorDir_ModelPackage), AssetDatas);
+
+	FName OwnSkeletonName = FName(*(SkeletalMeshName + FString("_Skeleton")));
+	const FAssetData* SkeletonAssetData = nullptr;
+	for (const FAssetData& AssetData : AssetDatas)
 	{
-		if (MatInfo.bOpacityBlendModel_Translucent)
+		if (AssetData.AssetClass != USkeleton::StaticClass()->GetFName())
 		{
-			EditorMatName += FString("L");
+			continue;
 		}
-		else
+
+		if (AssetData.AssetName == OwnSkeletonName)
 		{
-			EditorMatName += FString("T");
+			SkeletonAssetData = &AssetData;
+			break;
 		}
 
-		if (MatInfo.bOpacityMaskChannel_Alpha)
+		if (!SkeletonAssetData || AssetData.AssetName.ToString() < SkeletonAssetData->AssetName.ToString())
 		{
-			EditorMatName += FString("A");
+			SkeletonAssetData = &AssetData;
 		}
 	}
-	if (!MatInfo.Texture_ReflectMap.IsEmpty())
+
+	if (SkeletonAssetData)
 	{
-		EditorMatName += FString("RA");
+		ObjectSkeleton = Cast<USkeleton>(SkeletonAssetData->GetAsset());
 	}
 
-	if (!EditorMatName.EndsWith(FString("_")))
+	return ObjectSkeleton.Get();
+}
+
+FString UEluProcessor::GetTextureNameFromXmlNode(FXmlNode* XmlNode)
+{
+	FString TextureName;
+
+	if (XmlNode)
 	{
-		EditorMatName += "_";
+		FString ChildContent = XmlNode->GetContent();
+		TArray<FString> ChildContentSplitArray;
+		ChildContent.ParseIntoArray(ChildContentSplitArray, *FString("."));
+		if (ChildContentSplitArray.Num() > 0)
+		{
+			TextureName = FString("T_") + ObjectTools::SanitizeObjectName(ChildContentSplitArray[0]);
+		}
 	}
 
-	if (MatInfo.bAnimatedTexture_AllTextures)
+	return TextureName;
+}
+
+FString UEluProcessor::GetEditorMatName(const FEluMatInfo & MatInfo)
+{
+	return FEluMatPermutation::GetParentMaterialName(MatInfo.Permutation).ToString();
+}
+
+EEluModelType UEluProcessor::GetEluModelType(const FString & FilePath_EluXml)
+{
+	if (FilePath_EluXml.Contains("/Model/MapObject/"))
 	{
-		EditorMatName += FString("ZP");
+		return EEluModelType::MapObject;
 	}
-	if(MatInfo.bAnimatedTexture_Diffuse)
+	else if (FilePath_EluXml.Contains("/Model/Monster/"))
 	{
-		EditorMatName += FString("DP");
+		return EEluModelType::Monster;
+	}
+	else if (FilePath_EluXml.Contains("/Model/Player/hf/"))
+	{
+		return EEluModelType::Female;
+	}
+	else if (FilePath_EluXml.Contains("/Model/Player/hm/"))
+	{
+		return EEluModelType::Male;
+	}
+	else if (FilePath_EluXml.Contains("/Model/Ride/"))
+	{
+		return EEluModelType::Ride;
+	}
+	else if (FilePath_EluXml.Contains("/Model/Sky/"))
+	{
+		return EEluModelType::Sky;
+	}
+	else if (FilePath_EluXml.Contains("/Model/weapons/"))
+	{
+		return EEluModelType::Weapon;
 	}
-	if (MatInfo.bAnimatedTexture_Glow)
+	else if (FilePath_EluXml.Contains("/Model/NPC/"))
 	{
-		EditorMatName += FString("GP");
+		return EEluModelType::NPC;
 	}
-	if (MatInfo.bAnimatedTexture_Normal)
+	else if (FilePath_EluXml.Contains("/SFX/"))
 	{
-		EditorMatName += FString("NP");
+		return EEluModelType::SFX;
 	}
-	if (MatInfo.bAnimatedTexture_Opacity)
+
+	return EEluModelType::Unknown;
+}
+
+bool UEluProcessor::ParseStaticMeshLODFileName(const FString& FileName_EluModel, FString& OutBaseName, int32& OutLODIndex)
+{
+	if (!FileName_EluModel.StartsWith(TEXT("S_")))
 	{
-		EditorMatName += FString("TP");
+		return false;
 	}
-	if (MatInfo.bAnimatedTexture_Specular)
+
+	int32 LODSuffixIndex = FileName_EluModel.Find(TEXT("_LOD"), ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+	if (LODSuffixIndex == INDEX_NONE)
 	{
-		EditorMatName += FString("SP");
+		return false;
 	}
 
-	if (!EditorMatName.EndsWith(FString("_")))
+	FString LODNumber = FileName_EluModel.Mid(LODSuffixIndex + 4);
+	if (LODNumber.IsEmpty() || !LODNumber.IsNumeric())
 	{
-		EditorMatName += "_";
+		return false;
 	}
 
-	EditorMatName += "mat";
+	OutBaseName = FileName_EluModel.Left(LODSuffixIndex);
+	OutLODIndex = FCString::Atoi(*LODNumber);
+	return true;
+}
 
-	return EditorMatName;
+void UEluProcessor::AddError(const FString & ErrorMessage)
+{
+	FEluErrorRecord ErrorRecord;
+	ErrorRecord.ErrorMessage = ErrorMessage;
+	FEluErrorJournal::Get().Add(ErrorRecord);
 }
 
-EEluModelType UEluProcessor::GetEluModelType(const FString & FilePath_EluXml)
+void UEluProcessor::AddError(EEluErrorKind ErrorKind, const FString & FilePath_EluXml, const FString & MeshName, const FString & MaterialName, const FString & ErrorMessage)
 {
-	if (FilePath_EluXml.Contains("/Model/MapObject/"))
+	FEluErrorRecord ErrorRecord;
+	ErrorRecord.ErrorKind = ErrorKind;
+	ErrorRecord.FilePath_EluXml = FilePath_EluXml;
+	ErrorRecord.MeshName = MeshName;
+	ErrorRecord.MaterialName = MaterialName;
+	ErrorRecord.ErrorMessage = ErrorMessage;
+	FEluErrorJournal::Get().Add(ErrorRecord);
+}
+
+EEluErrorPolicy UEluProcessor::GetErrorPolicy(EEluErrorKind ErrorKind) const
+{
+	const EEluErrorPolicy* ErrorPolicy = ErrorPolicies.Find(ErrorKind);
+	return ErrorPolicy ? *ErrorPolicy : DefaultErrorPolicy;
+}
+
+EEluErrorPolicy UEluProcessor::HandleError(EEluErrorKind ErrorKind, const FString & FilePath_EluXml, const FString & MeshName, const FString & MaterialName, const FString & ErrorMessage, bool bCanRetry)
+{
+	UE_LOG(LogTemp, Warning, TEXT("%s"), *ErrorMessage);
+	UEluProcessor::AddError(ErrorKind, FilePath_EluXml, MeshName, MaterialName, ErrorMessage);
+	ErrorCounts.FindOrAdd(ErrorKind)++;
+
+	EEluErrorPolicy ErrorPolicy = GetErrorPolicy(ErrorKind);
+	if (ErrorPolicy == EEluErrorPolicy::Ask)
 	{
-		return EEluModelType::MapObject;
+		if (bUnattended || FApp::IsUnattended())
+		{
+			return EEluErrorPolicy::Skip;
+		}
+
+		FString DialogMessage = ErrorMessage + FString("\nDo you want to cancel further import?");
+		FText DialogText = FText::FromString(DialogMessage);
+		EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::YesNo, DialogText);
+
+		return AppReturnType == EAppReturnType::Yes ? EEluErrorPolicy::Abort : EEluErrorPolicy::Skip;
 	}
-	else if (FilePath_EluXml.Contains("/Model/Monster/"))
+	else if (ErrorPolicy == EEluErrorPolicy::Retry && !bCanRetry)
 	{
-		return EEluModelType::Monster;
+		return EEluErrorPolicy::Skip;
 	}
-	else if (FilePath_EluXml.Contains("/Model/Player/hf/"))
+
+	return ErrorPolicy;
+}
+
+void UEluProcessor::RescanEditorDir(const FString & EditorDir)
+{
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+
+	TArray<FString> PathsToScan;
+	PathsToScan.Add(EditorDir);
+	AssetRegistryModule.Get().ScanPathsSynchronous(PathsToScan, true);
+}
+
+FMD5Hash UEluProcessor::HashSourceFile(const FString & FilePath_Source)
+{
+	FMD5Hash FileHash;
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	// Memory mapping avoids copying the whole fbx file through a read buffer just to hash it
+	TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*FilePath_Source));
+	if (MappedFile)
 	{
-		return EEluModelType::Female;
+		TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile->MapRegion());
+		if (MappedRegion)
+		{
+			FMD5 MD5;
+			MD5.Update(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+			FileHash.Set(MD5);
+			return FileHash;
+		}
 	}
-	else if (FilePath_EluXml.Contains("/Model/Player/hm/"))
+
+	return FMD5Hash::HashFile(*FilePath_Source);
+}
+
+const FMD5Hash & UEluProcessor::GetSourceFileHash(const FString & FilePath_Source)
+{
+	FMD5Hash* FileHash = SourceFileHashes.Find(FilePath_Source);
+	if (FileHash)
 	{
-		return EEluModelType::Male;
+		return *FileHash;
 	}
-	else if (FilePath_EluXml.Contains("/Model/Ride/"))
+
+	return SourceFileHashes.Add(FilePath_Source, UEluProcessor::HashSourceFile(FilePath_Source));
+}
+
+bool UEluProcessor::IsImportedAssetUpToDate(const FString & ObjectPath, const FString & FilePath_Source, const FString & FilePath_EluXml, const TArray<FString>& FilePaths_LODs)
+{
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+
+	FAssetData AssetData = AssetRegistryModule.Get().GetAssetByObjectPath(FName(*ObjectPath));
+	if (!AssetData.IsValid())
 	{
-		return EEluModelType::Ride;
+		return false;
 	}
-	else if (FilePath_EluXml.Contains("/Model/Sky/"))
+
+	FString ImportInfoJson;
+	if (!AssetData.GetTagValue(UObject::SourceFileTagName(), ImportInfoJson))
 	{
-		return EEluModelType::Sky;
+		return false;
 	}
-	else if (FilePath_EluXml.Contains("/Model/weapons/"))
+
+	TOptional<FAssetImportInfo> ImportInfo = FAssetImportInfo::FromJson(ImportInfoJson);
+	if (!ImportInfo.IsSet())
 	{
-		return EEluModelType::Weapon;
+		return false;
 	}
-	else if (FilePath_EluXml.Contains("/Model/NPC/"))
+
+	TArray<FString> FilePaths_Required;
+	FilePaths_Required.Add(FilePath_Source);
+	if (!FilePath_EluXml.IsEmpty())
 	{
-		return EEluModelType::NPC;
+		FilePaths_Required.Add(FilePath_EluXml);
 	}
-	else if (FilePath_EluXml.Contains("/SFX/"))
+	FilePaths_Required.Append(FilePaths_LODs);
+
+	// LOD files that were imported but have been deleted since
+	if (ImportInfo.GetValue().SourceFiles.Num() != FilePaths_Required.Num())
 	{
-		return EEluModelType::SFX;
+		return false;
 	}
 
-	return EEluModelType::Unknown;
+	for (const FString& FilePath_Required : FilePaths_Required)
+	{
+		FString FileName_Required = FPaths::GetCleanFilename(FilePath_Required);
+
+		const FAssetImportInfo::FSourceFile* SourceFile = ImportInfo.GetValue().SourceFiles.FindByPredicate([&FileName_Required](const FAssetImportInfo::FSourceFile& File)
+		{
+			return FPaths::GetCleanFilename(File.RelativeFilename) == FileName_Required;
+		});
+
+		if (!SourceFile || !SourceFile->FileHash.IsValid() || SourceFile->FileHash != GetSourceFileHash(FilePath_Required))
+		{
+			return false;
+		}
+	}
+
+	return true;
 }
 
-void UEluProcessor::AddError(const FString & ErrorMessage)
+void UEluProcessor::RecordSourceFileHashes(UAssetImportData * AssetImportData, const FString & FilePath_Source, const FString & FilePath_EluXml, const TArray<FString>& FilePaths_LODs)
 {
-	TArray<FString> OldErrorsArray;
-	FFileHelper::LoadFileToStringArray(OldErrorsArray, *UEluProcessor::FilePath_ErrorFile);
+	if (!AssetImportData)
+	{
+		return;
+	}
 
-	if (!OldErrorsArray.Contains(ErrorMessage))
+	IFileManager& FileManager = IFileManager::Get();
+
+	FAssetImportInfo ImportInfo;
+	ImportInfo.SourceFiles.Add(FAssetImportInfo::FSourceFile(AssetImportData->SanitizeImportFilename(FilePath_Source),
+															 FileManager.GetTimeStamp(*FilePath_Source),
+															 GetSourceFileHash(FilePath_Source)));
+
+	// The fbx file stays the first source file, so that reimporting the asset keeps working as usual
+	if (!FilePath_EluXml.IsEmpty())
 	{
-		OldErrorsArray.Add(ErrorMessage);
+		ImportInfo.SourceFiles.Add(FAssetImportInfo::FSourceFile(AssetImportData->SanitizeImportFilename(FilePath_EluXml),
+																 FileManager.GetTimeStamp(*FilePath_EluXml),
+																 GetSourceFileHash(FilePath_EluXml)));
 	}
 
-	FFileHelper::SaveStringArrayToFile(OldErrorsArray, *UEluProcessor::FilePath_ErrorFile);
+	for (const FString& FilePath_LOD : FilePaths_LODs)
+	{
+		ImportInfo.SourceFiles.Add(FAssetImportInfo::FSourceFile(AssetImportData->SanitizeImportFilename(FilePath_LOD),
+																 FileManager.GetTimeStamp(*FilePath_LOD),
+																 GetSourceFileHash(FilePath_LOD)));
+	}
 
+	AssetImportData->SourceData = ImportInfo;
+	AssetImportData->MarkPackageDirty();
 }
 
-bool UEluProcessor::AreMaterialInstanceParametersSame(UMaterialInstanceConstant * MIConstant, FEluMatInfo MatInfo)
+bool UEluProcessor::AreMaterialInstanceParametersSame(UMaterialInstanceConstant * MIConstant, const FEluMatInfo & MatInfo)
 {
-	FString MatInfoParentName = UEluProcessor::GetEditorMatName(MatInfo);
-	FString MIConstantParentName = MIConstant->Parent->GetName();
+	FName MatInfoParentName = FEluMatPermutation::GetParentMaterialName(MatInfo.Permutation);
 
-	if (MIConstantParentName == MatInfoParentName)
+	if (MIConstant->Parent && MIConstant->Parent->GetFName() == MatInfoParentName)
 	{
 		if (MatInfo.bMaterialType_TwoSided != MIConstant->TwoSided)
 		{
@@ -602,54 +1220,10 @@ bool UEluProcessor::AreMaterialInstanceParametersSame(UMaterialInstanceConstant
 
 		for (FTextureParameterValue& TPV : MIConstant->TextureParameterValues)
 		{
-			if (TPV.ParameterInfo.Name == FName("Diffuse"))
-			{
-				if (!TPV.ParameterValue || TPV.ParameterValue->GetName() != MatInfo.Texture_DiffuseMap)
-				{
-					return false;
-				}
-			}
-			else if (TPV.ParameterInfo.Name == FName("Specular"))
-			{
-				if (!TPV.ParameterValue || TPV.ParameterValue->GetName() != MatInfo.Texture_SpecularMap)
-				{
-					return false;
-				}
-			}
-			else if (TPV.ParameterInfo.Name == FName("Normal"))
-			{
-				if (!TPV.ParameterValue || TPV.ParameterValue->GetName() != MatInfo.Texture_NormalMap)
-				{
-					return false;
-				}
-			}
-			else if (TPV.ParameterInfo.Name == FName("Glow"))
-			{
-				if (!TPV.ParameterValue || TPV.ParameterValue->GetName() != MatInfo.Texture_SelfIlluminationMap)
-				{
-					return false;
-				}
-			}
-			else if (TPV.ParameterInfo.Name == FName("OpacityMask"))
-			{
-				if (!TPV.ParameterValue || TPV.ParameterValue->GetName() != MatInfo.Texture_OpacityMap)
-				{
-					return false;
-				}
-			}
-			else if (TPV.ParameterInfo.Name == FName("ReflectMap"))
-			{
-				if (!TPV.ParameterValue || TPV.ParameterValue->GetName() != MatInfo.Texture_ReflectMap)
-				{
-					return false;
-				}
-			}
-			else if (TPV.ParameterInfo.Name == FName("SSSMask"))
+			const FEluMatParameterDesc* ParameterDesc = FEluMatPermutation::FindTextureParameter(TPV.ParameterInfo.Name);
+			if (ParameterDesc && (!TPV.ParameterValue || TPV.ParameterValue->GetFName() != MatInfo.*ParameterDesc->Texture))
 			{
-				if (!TPV.ParameterValue || TPV.ParameterValue->GetName() != MatInfo.Texture_SSSMask)
-				{
-					return false;
-				}
+				return false;
 			}
 		}
 
@@ -672,11 +1246,33 @@ bool UEluProcessor::AreMaterialInstanceParametersSame(UMaterialInstanceConstant
 }
 
 void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMap<FString, FEluMatInfo>& OutMap_EluMatsInfo)
+{
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::XmlParse);
+
+	FEluXmlMaterialParser Parser;
+	if (!Parser.LoadFile(FilePath_EluXml))
+	{
+		FString LogMessage = FString("Unable to read elu xml file: ") + FilePath_EluXml;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		return;
+	}
+
+	Parser.Parse(OutMap_EluMatsInfo);
+}
+
+void UEluProcessor::ParseEluXmlForMaterialsWithDom(const FString & FilePath_EluXml, TMap<FString, FEluMatInfo>& OutMap_EluMatsInfo)
 {
 	FXmlFile EluXmlFileObj(FilePath_EluXml);
 	FXmlNode* RootNode = EluXmlFileObj.GetRootNode();
 	TArray<FXmlNode*> ChildrenNodes;				// for holding temporary children nodes
 
+	if (!RootNode)
+	{
+		FString LogMessage = FString("Unable to parse elu xml file: ") + FilePath_EluXml;
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		return;
+	}
+
 	ChildrenNodes = RootNode->GetChildrenNodes();
 	TArray<FXmlNode*> Xml_MATERIALLISTs;
 	for (FXmlNode* ChildNode : ChildrenNodes)
@@ -753,7 +1349,7 @@ void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMa
 
 				if (Xml_DIFFUSEMAP)
 				{
-					MatInfo.Texture_DiffuseMap = UEluProcessor::GetTextureNameFromXmlNode(Xml_DIFFUSEMAP);
+					MatInfo.Texture_DiffuseMap = FName(*UEluProcessor::GetTextureNameFromXmlNode(Xml_DIFFUSEMAP));
 
 					if (Xml_TEXANIMATION)
 					{
@@ -763,7 +1359,7 @@ void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMa
 
 				if (Xml_SPECULARMAP)
 				{
-					MatInfo.Texture_SpecularMap = UEluProcessor::GetTextureNameFromXmlNode(Xml_SPECULARMAP);
+					MatInfo.Texture_SpecularMap = FName(*UEluProcessor::GetTextureNameFromXmlNode(Xml_SPECULARMAP));
 
 					if (Xml_TEXANIMATION)
 					{
@@ -773,7 +1369,7 @@ void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMa
 
 				if (Xml_NORMALMAP)
 				{
-					MatInfo.Texture_NormalMap = UEluProcessor::GetTextureNameFromXmlNode(Xml_NORMALMAP);
+					MatInfo.Texture_NormalMap = FName(*UEluProcessor::GetTextureNameFromXmlNode(Xml_NORMALMAP));
 
 					if (Xml_TEXANIMATION)
 					{
@@ -783,7 +1379,7 @@ void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMa
 
 				if (Xml_SELFILLUMINATIONMAP)
 				{
-					MatInfo.Texture_SelfIlluminationMap = UEluProcessor::GetTextureNameFromXmlNode(Xml_SELFILLUMINATIONMAP);
+					MatInfo.Texture_SelfIlluminationMap = FName(*UEluProcessor::GetTextureNameFromXmlNode(Xml_SELFILLUMINATIONMAP));
 
 					if (Xml_TEXANIMATION)
 					{
@@ -793,10 +1389,11 @@ void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMa
 
 				if (Xml_OPACITYMAP)
 				{
-					MatInfo.Texture_OpacityMap = UEluProcessor::GetTextureNameFromXmlNode(Xml_OPACITYMAP);
+					FString OpacityMapName = UEluProcessor::GetTextureNameFromXmlNode(Xml_OPACITYMAP);
+					MatInfo.Texture_OpacityMap = FName(*OpacityMapName);
 
-					if (MatInfo.Texture_OpacityMap.EndsWith(TEXT("_m")) || MatInfo.Texture_OpacityMap.EndsWith(TEXT("_M")) ||
-						MatInfo.Texture_OpacityMap.EndsWith(TEXT("_s")))
+					if (OpacityMapName.EndsWith(TEXT("_m")) || OpacityMapName.EndsWith(TEXT("_M")) ||
+						OpacityMapName.EndsWith(TEXT("_s")))
 						// MatInfo.Texture_OpacityMap.EndsWith(TEXT("_s")) || MatInfo.Texture_OpacityMap.EndsWith(TEXT("_sp")))
 					{
 						MatInfo.bOpacityMaskChannel_Alpha = false;
@@ -810,17 +1407,17 @@ void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMa
 
 				if (Xml_REFLECTMAP)
 				{
-					MatInfo.Texture_ReflectMap = UEluProcessor::GetTextureNameFromXmlNode(Xml_REFLECTMAP);
+					MatInfo.Texture_ReflectMap = FName(*UEluProcessor::GetTextureNameFromXmlNode(Xml_REFLECTMAP));
 				}
 
 				if (Xml_GLOSSMAP)
 				{
-					MatInfo.Texture_GlossMap = UEluProcessor::GetTextureNameFromXmlNode(Xml_GLOSSMAP);
+					MatInfo.Texture_GlossMap = FName(*UEluProcessor::GetTextureNameFromXmlNode(Xml_GLOSSMAP));
 				}
 
 				if (Xml_SSSMask)
 				{
-					MatInfo.Texture_SSSMask = UEluProcessor::GetTextureNameFromXmlNode(Xml_SSSMask);
+					MatInfo.Texture_SSSMask = FName(*UEluProcessor::GetTextureNameFromXmlNode(Xml_SSSMask));
 				}
 			}
 		}
@@ -831,11 +1428,14 @@ void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMa
 			TArray<FString> StringArray;
 			FString AmbientString = Xml_Ambient->GetContent();
 			AmbientString.ParseIntoArray(StringArray, TEXT(" "));
-			float Ambient_X = FCString::Atof(*StringArray[0]);
-			float Ambient_Y = FCString::Atof(*StringArray[1]);
-			float Ambient_Z = FCString::Atof(*StringArray[2]);
+			if (StringArray.Num() >= 3)
+			{
+				float Ambient_X = FCString::Atof(*StringArray[0]);
+				float Ambient_Y = FCString::Atof(*StringArray[1]);
+				float Ambient_Z = FCString::Atof(*StringArray[2]);
 
-			MatInfo.Vector_Ambient = FVector(Ambient_X / 255.f, Ambient_Y / 255.f, Ambient_Z / 255.f);
+				MatInfo.Vector_Ambient = FVector(Ambient_X / 255.f, Ambient_Y / 255.f, Ambient_Z / 255.f);
+			}
 		}
 
 		FXmlNode* Xml_Diffuse = Xml_MATERIAL->FindChildNode(FString("DIFFUSE"));
@@ -844,11 +1444,14 @@ void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMa
 			TArray<FString> StringArray;
 			FString DiffuseString = Xml_Diffuse->GetContent();
 			DiffuseString.ParseIntoArray(StringArray, TEXT(" "));
-			float Diffuse_X = FCString::Atof(*StringArray[0]);
-			float Diffuse_Y = FCString::Atof(*StringArray[1]);
-			float Diffuse_Z = FCString::Atof(*StringArray[2]);
+			if (StringArray.Num() >= 3)
+			{
+				float Diffuse_X = FCString::Atof(*StringArray[0]);
+				float Diffuse_Y = FCString::Atof(*StringArray[1]);
+				float Diffuse_Z = FCString::Atof(*StringArray[2]);
 
-			MatInfo.Vector_Diffuse = FVector(Diffuse_X / 255.f, Diffuse_Y / 255.f, Diffuse_Z / 255.f);
+				MatInfo.Vector_Diffuse = FVector(Diffuse_X / 255.f, Diffuse_Y / 255.f, Diffuse_Z / 255.f);
+			}
 		}
 
 		FXmlNode* Xml_Specular = Xml_MATERIAL->FindChildNode(FString("SPECULAR"));
@@ -857,11 +1460,14 @@ void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMa
 			TArray<FString> StringArray;
 			FString SpecularString = Xml_Specular->GetContent();
 			SpecularString.ParseIntoArray(StringArray, TEXT(" "));
-			float Specular_X = FCString::Atof(*StringArray[0]);
-			float Specular_Y = FCString::Atof(*StringArray[1]);
-			float Specular_Z = FCString::Atof(*StringArray[2]);
+			if (StringArray.Num() >= 3)
+			{
+				float Specular_X = FCString::Atof(*StringArray[0]);
+				float Specular_Y = FCString::Atof(*StringArray[1]);
+				float Specular_Z = FCString::Atof(*StringArray[2]);
 
-			MatInfo.Vector_Specular = FVector(Specular_X / 255.f, Specular_Y / 255.f, Specular_Z / 255.f);
+				MatInfo.Vector_Specular = FVector(Specular_X / 255.f, Specular_Y / 255.f, Specular_Z / 255.f);
+			}
 		}
 
 		FXmlNode* Xml_TWOSIDED = Xml_MATERIAL->FindChildNode(FString("TWOSIDED"));
@@ -907,247 +1513,538 @@ void UEluProcessor::ParseEluXmlForMaterials(const FString & FilePath_EluXml, TMa
 			}
 		}
 
-		OutMap_EluMatsInfo.Add(MatName, MatInfo);
-	}
-}
-
-bool UEluProcessor::FillMaterialInstanceTextureParameter(UMaterialInstanceConstant * MIConstant, FName ParamName, FName TextureName)
-{
-	FString LogMessage;
-
-	if (AssetDataMap_Textures.Contains(TextureName))
-	{
-		FTextureParameterValue TexParam;
-		TexParam.ParameterInfo.Name = ParamName;
-		TexParam.ParameterValue = Cast<UTexture>(AssetDataMap_Textures[TextureName].GetAsset());
-		MIConstant->TextureParameterValues.Add(TexParam);
-		return true;
-	}
-	else
-	{
-		LogMessage = FString("Couldn't find the texture: ") + TextureName.ToString() +
-			FString(", required by parameter: ") + ParamName.ToString() + FString(", on material instance: ") +
-			MIConstant->GetName();
-		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-		return false;
+		MatInfo.Permutation = FEluMatPermutation::Compute(MatInfo);
+		OutMap_EluMatsInfo.Add(MoveTemp(MatName), MatInfo);
 	}
 }
 
-bool UEluProcessor::FillMaterialInstanceParameters(UMaterialInstanceConstant * MIConstant, const FString & EditorMatName, const FEluMatInfo & MatInfo)
+EImportResult UEluProcessor::ValidateBatchMaterials(TArray<FString>& InOutPaths_EluXml, TArray<FString>& OutPaths_Rejected, TMap<FString, TArray<FName>>& OutObjectTextureNames)
 {
 	FString LogMessage;
-	LogMessage = FString("Filling material instance parameters for material instance: ") + MIConstant->GetName();
-	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+	MissingTexturesReported.Empty();
+	MissingParentMatsReported.Empty();
 
-	if (!IsValid(MIConstant))
-	{
-		return false;
-	}
+	// Material name -> parent material and required textures, per elu object
+	TArray<TMap<FString, TArray<FName>>> ObjectTextureNames;
+	TArray<TMap<FString, FName>> ObjectParentMatNames;
+	ObjectTextureNames.SetNum(InOutPaths_EluXml.Num());
+	ObjectParentMatNames.SetNum(InOutPaths_EluXml.Num());
 
-	if (EditorMatName == FString("Face_mat"))
+	TSet<FName> TextureNames;
+	TSet<FName> ParentMatNames;
+	for (int32 Index = 0; Index < InOutPaths_EluXml.Num(); Index++)
 	{
-		if (!MatInfo.Texture_DiffuseMap.IsEmpty())
+		// Material tables come from the cache, so reading them here ahead of the import is cheap
+		TMap<FString, FEluMatInfo> Map_EluMatsInfo;
+		if (MatInfoCache.IsValid())
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("Diffuse"), FName(*MatInfo.Texture_DiffuseMap));
-			if (!bResult)
-			{
-				return bResult;
-			}
+			MatInfoCache->FindOrParse(InOutPaths_EluXml[Index], Map_EluMatsInfo);
 		}
 		else
 		{
-			LogMessage = FString("Required texture parameter `Diffuse` (Face_mat) is missing. Cancelling parameter fill");
-			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-			return false;
+			UEluProcessor::ParseEluXmlForMaterials(InOutPaths_EluXml[Index], Map_EluMatsInfo);
 		}
 
-		if (!MatInfo.Texture_SpecularMap.IsEmpty())
+		for (const TPair<FString, FEluMatInfo>& EluMatInfoPair : Map_EluMatsInfo)
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("Specular"), FName(*MatInfo.Texture_SpecularMap));
-			if (!bResult)
+			const FEluMatInfo& MatInfo = EluMatInfoPair.Value;
+			uint32 RequiredParameters = FEluMatPermutation::GetRequiredParameters(MatInfo.Permutation);
+
+			FName ParentMatName = FName(*UEluProcessor::GetEditorMatName(MatInfo));
+			ObjectParentMatNames[Index].Add(EluMatInfoPair.Key, ParentMatName);
+			ParentMatNames.Add(ParentMatName);
+
+			TArray<FName>& MatTextureNames = ObjectTextureNames[Index].Add(EluMatInfoPair.Key);
+			for (const FEluMatParameterDesc& ParameterDesc : FEluMatPermutation::GetTextureParameters())
 			{
-				return bResult;
+				FName TextureName = MatInfo.*ParameterDesc.Texture;
+				if ((RequiredParameters & ParameterDesc.Parameter) && !TextureName.IsNone())
+				{
+					MatTextureNames.AddUnique(TextureName);
+					TextureNames.Add(TextureName);
+				}
 			}
 		}
-		else
+	}
+
+	auto FindMissingAssets = [&TextureNames, &ParentMatNames](TSet<FName>& OutMissingTextures, TSet<FName>& OutMissingParentMats)
+	{
+		const FEluAssetRegistrySnapshot& AssetRegistrySnapshot = FEluAssetRegistrySnapshot::Get();
+
+		OutMissingTextures.Empty();
+		for (FName TextureName : TextureNames)
 		{
-			LogMessage = FString("Required texture parameter `Specular` (Face_mat) is missing. Cancelling parameter fill");
-			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-			return false;
+			if (!AssetRegistrySnapshot.FindTexture(TextureName))
+			{
+				OutMissingTextures.Add(TextureName);
+			}
 		}
 
-		if (!MatInfo.Texture_NormalMap.IsEmpty())
+		OutMissingParentMats.Empty();
+		for (FName ParentMatName : ParentMatNames)
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("Normal"), FName(*MatInfo.Texture_NormalMap));
-			if (!bResult)
+			if (!AssetRegistrySnapshot.FindParentMaterial(ParentMatName))
 			{
-				return bResult;
+				OutMissingParentMats.Add(ParentMatName);
 			}
 		}
-		else
+	};
+
+	TSet<FName> MissingTextures;
+	TSet<FName> MissingParentMats;
+	FindMissingAssets(MissingTextures, MissingParentMats);
+
+	EEluErrorPolicy TexturePolicy = GetErrorPolicy(EEluErrorKind::TextureMissing);
+	EEluErrorPolicy ParentMatPolicy = GetErrorPolicy(EEluErrorKind::ParentMaterialMissing);
+
+	// Assets may have been added since the asset registry last scanned their directories
+	bool bRetryTextures = MissingTextures.Num() > 0 && TexturePolicy == EEluErrorPolicy::Retry;
+	bool bRetryParentMats = MissingParentMats.Num() > 0 && ParentMatPolicy == EEluErrorPolicy::Retry;
+	if (bRetryTextures)
+	{
+		UEluProcessor::RescanEditorDir(FEluAssetRegistrySnapshot::Get().EditorDir_Textures);
+	}
+	if (bRetryParentMats)
+	{
+		UEluProcessor::RescanEditorDir(FEluAssetRegistrySnapshot::Get().EditorDir_SimpleMaterials);
+		UEluProcessor::RescanEditorDir(FEluAssetRegistrySnapshot::Get().EditorDir_HumanSkinMaterials);
+	}
+	if (bRetryTextures || bRetryParentMats)
+	{
+		FindMissingAssets(MissingTextures, MissingParentMats);
+	}
+
+	// Every missing asset is journaled for every elu object that needs it, but nobody is asked about it yet
+	TArray<bool> ObjectsAffected;
+	ObjectsAffected.SetNumZeroed(InOutPaths_EluXml.Num());
+	int32 NumAffected = 0;
+	for (int32 Index = 0; Index < InOutPaths_EluXml.Num(); Index++)
+	{
+		const FString& FilePath_EluXml = InOutPaths_EluXml[Index];
+
+		for (const TPair<FString, FName>& ParentMatPair : ObjectParentMatNames[Index])
 		{
-			LogMessage = FString("Required texture parameter `Normal` (Face_mat) is missing. Cancelling parameter fill");
-			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-			return false;
+			if (MissingParentMats.Contains(ParentMatPair.Value))
+			{
+				LogMessage = FString("Couldn't find the base material named `") + ParentMatPair.Value.ToString() + FString("` needed for material: ") + ParentMatPair.Key;
+				UEluProcessor::AddError(EEluErrorKind::ParentMaterialMissing, FilePath_EluXml, FString(), ParentMatPair.Key, LogMessage);
+				ErrorCounts.FindOrAdd(EEluErrorKind::ParentMaterialMissing)++;
+				ObjectsAffected[Index] = true;
+			}
 		}
 
-		if (!MatInfo.Texture_OpacityMap.IsEmpty())
+		for (const TPair<FString, TArray<FName>>& TextureNamesPair : ObjectTextureNames[Index])
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("OpacityMask"), FName(*MatInfo.Texture_OpacityMap));
-			if (!bResult)
+			for (FName TextureName : TextureNamesPair.Value)
 			{
-				return bResult;
+				if (MissingTextures.Contains(TextureName))
+				{
+					LogMessage = FString("Couldn't find the texture `") + TextureName.ToString() + FString("` needed for material: ") + TextureNamesPair.Key;
+					UEluProcessor::AddError(EEluErrorKind::TextureMissing, FilePath_EluXml, FString(), TextureNamesPair.Key, LogMessage);
+					ErrorCounts.FindOrAdd(EEluErrorKind::TextureMissing)++;
+					ObjectsAffected[Index] = true;
+				}
 			}
 		}
-		else
+
+		NumAffected += ObjectsAffected[Index] ? 1 : 0;
+	}
+
+	bool bRejectAffected = true;
+	if (NumAffected > 0)
+	{
+		for (FName TextureName : MissingTextures)
 		{
-			LogMessage = FString("Required texture parameter `OpacityMask` (Face_mat) is missing. Cancelling parameter fill");
-			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-			return false;
+			LogMessage = FString("Texture is missing: ") + TextureName.ToString();
+			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
 		}
 
-		if (!MatInfo.Texture_SSSMask.IsEmpty())
+		for (FName ParentMatName : MissingParentMats)
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("SSSMask"), FName(*MatInfo.Texture_SSSMask));
-			if (!bResult)
-			{
-				return bResult;
-			}
+			LogMessage = FString("Parent material is missing: ") + ParentMatName.ToString();
+			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
 		}
-		else
+
+		LogMessage = FString::Printf(TEXT("%d of %d elu objects use %d missing textures and %d missing parent materials"),
+			NumAffected, InOutPaths_EluXml.Num(), MissingTextures.Num(), MissingParentMats.Num());
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+
+		bool bTexturesAsk = MissingTextures.Num() > 0 && TexturePolicy == EEluErrorPolicy::Ask;
+		bool bParentMatsAsk = MissingParentMats.Num() > 0 && ParentMatPolicy == EEluErrorPolicy::Ask;
+
+		if ((MissingTextures.Num() > 0 && TexturePolicy == EEluErrorPolicy::Abort) || (MissingParentMats.Num() > 0 && ParentMatPolicy == EEluErrorPolicy::Abort))
 		{
-			LogMessage = FString("Required texture parameter `SSSMask` (Face_mat) is missing. Cancelling parameter fill");
-			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-			return false;
+			return EImportResult::Cancelled;
 		}
-	}
-	else if (EditorMatName == FString("Body_mat"))
-	{
-		if (!MatInfo.Texture_DiffuseMap.IsEmpty())
+		else if ((bTexturesAsk || bParentMatsAsk) && !bUnattended && !FApp::IsUnattended())
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("Diffuse"), FName(*MatInfo.Texture_DiffuseMap));
-			if (!bResult)
+			// One question for the whole batch, instead of one per material slot in the middle of the import
+			FString DialogMessage = LogMessage + FString(". See the log for the list.\n\n") +
+				FString("Yes: skip these elu objects\nNo: import them anyway, after all the others\nCancel: cancel the import");
+			EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::YesNoCancel, FText::FromString(DialogMessage));
+			if (AppReturnType == EAppReturnType::Cancel)
 			{
-				return bResult;
+				return EImportResult::Cancelled;
 			}
+
+			bRejectAffected = AppReturnType == EAppReturnType::Yes;
 		}
-		else
+	}
+
+	// Elu objects that are imported anyway would otherwise have the same errors journaled, counted and asked about again, once per material slot
+	MissingTexturesReported = MissingTextures;
+	MissingParentMatsReported = MissingParentMats;
+
+	TArray<FString> Paths_Affected;
+	TArray<FString> Paths_Valid;
+	for (int32 Index = 0; Index < InOutPaths_EluXml.Num(); Index++)
+	{
+		if (ObjectsAffected[Index] && bRejectAffected)
 		{
-			LogMessage = FString("Required texture parameter `Diffuse` (Body_mat) is missing. Cancelling parameter fill");
-			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-			return false;
+			OutPaths_Rejected.Add(InOutPaths_EluXml[Index]);
+			continue;
 		}
 
-		if (!MatInfo.Texture_SpecularMap.IsEmpty())
+		// Errors of affected elu objects can still need the user, which is better done once the rest of the batch is in
+		TArray<FString>& Paths_Kept = ObjectsAffected[Index] ? Paths_Affected : Paths_Valid;
+		Paths_Kept.Add(InOutPaths_EluXml[Index]);
+
+		TArray<FName>& OutTextureNames = OutObjectTextureNames.Add(InOutPaths_EluXml[Index]);
+		for (const TPair<FString, TArray<FName>>& TextureNamesPair : ObjectTextureNames[Index])
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("Specular"), FName(*MatInfo.Texture_SpecularMap));
-			if (!bResult)
+			for (FName TextureName : TextureNamesPair.Value)
 			{
-				return bResult;
+				OutTextureNames.AddUnique(TextureName);
 			}
 		}
-		else
+	}
+
+	if (OutPaths_Rejected.Num() > 0)
+	{
+		LogMessage = FString::Printf(TEXT("Skipping %d elu objects with missing textures or parent materials"), OutPaths_Rejected.Num());
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+	}
+
+	InOutPaths_EluXml = MoveTemp(Paths_Valid);
+	InOutPaths_EluXml.Append(Paths_Affected);
+
+	return EImportResult::Success;
+}
+
+void UEluProcessor::PreloadBatchTextures(const TArray<FString>& Paths_EluXml, const TMap<FString, TArray<FName>>& ObjectTextureNames)
+{
+	FString LogMessage;
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::TexturePreload);
+
+	ReleaseBatchTextures();
+
+	TSet<FName> TextureNames;
+	ObjectTexturePaths.SetNum(Paths_EluXml.Num());
+	TexturePreloadHandles.SetNum(Paths_EluXml.Num());
+	for (int32 ObjectIndex = 0; ObjectIndex < Paths_EluXml.Num(); ObjectIndex++)
+	{
+		const TArray<FName>* TextureNamesOfObject = ObjectTextureNames.Find(Paths_EluXml[ObjectIndex]);
+		if (!TextureNamesOfObject)
 		{
-			LogMessage = FString("Required texture parameter `Specular` (Body_mat) is missing. Cancelling parameter fill");
-			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-			return false;
+			continue;
 		}
 
-		if (!MatInfo.Texture_NormalMap.IsEmpty())
+		for (FName TextureName : *TextureNamesOfObject)
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("Normal"), FName(*MatInfo.Texture_NormalMap));
-			if (!bResult)
+			const FAssetData* AssetData = FEluAssetRegistrySnapshot::Get().FindTexture(TextureName);
+			if (AssetData)
 			{
-				return bResult;
+				ObjectTexturePaths[ObjectIndex].Add(AssetData->ToSoftObjectPath());
+				TextureNames.Add(TextureName);
 			}
 		}
+	}
+
+	// Under a memory budget, textures of the whole batch would stay pinned while the packages of finished elu objects are unloaded
+	int32 NumObjectsPreloaded = MemoryBudgetMB > 0 ? FMath::Min(UEluProcessor::NumObjectsTexturePreloaded, Paths_EluXml.Num()) : Paths_EluXml.Num();
+	LogMessage = FString::Printf(TEXT("Batch uses %d textures. They are loaded asynchronously, %d elu objects ahead of the import"), TextureNames.Num(), NumObjectsPreloaded);
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+	PreloadUpcomingTextures(0);
+}
+
+void UEluProcessor::PreloadUpcomingTextures(int32 ObjectIndex)
+{
+	// Textures of finished elu objects are kept loaded by their material instances until those are unloaded
+	for (int32 FinishedIndex = 0; FinishedIndex < ObjectIndex && FinishedIndex < TexturePreloadHandles.Num(); FinishedIndex++)
+	{
+		if (TexturePreloadHandles[FinishedIndex].IsValid())
+		{
+			TexturePreloadHandles[FinishedIndex]->ReleaseHandle();
+			TexturePreloadHandles[FinishedIndex].Reset();
+		}
+	}
+
+	int32 EndIndex = ObjectTexturePaths.Num();
+	if (MemoryBudgetMB > 0)
+	{
+		EndIndex = FMath::Min(ObjectIndex + UEluProcessor::NumObjectsTexturePreloaded, EndIndex);
+	}
+
+	for (int32 UpcomingIndex = FMath::Max(ObjectIndex, NumObjectsTexturesRequested); UpcomingIndex < EndIndex; UpcomingIndex++)
+	{
+		if (ObjectTexturePaths[UpcomingIndex].Num() > 0)
+		{
+			TexturePreloadHandles[UpcomingIndex] = StreamableManager.RequestAsyncLoad(ObjectTexturePaths[UpcomingIndex], FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority, true);
+		}
+		NumObjectsTexturesRequested = UpcomingIndex + 1;
+	}
+}
+
+void UEluProcessor::TickTexturePreload(float TimeLimit)
+{
+	// Imports run on the game thread without the engine ticking in between, so async loading has to be pumped explicitly
+	for (const TSharedPtr<FStreamableHandle>& TexturePreloadHandle : TexturePreloadHandles)
+	{
+		if (TexturePreloadHandle.IsValid() && TexturePreloadHandle->IsLoadingInProgress())
+		{
+			ProcessAsyncLoading(true, false, TimeLimit);
+			return;
+		}
+	}
+}
+
+void UEluProcessor::ReleaseBatchTextures()
+{
+	for (TSharedPtr<FStreamableHandle>& TexturePreloadHandle : TexturePreloadHandles)
+	{
+		if (TexturePreloadHandle.IsValid())
+		{
+			TexturePreloadHandle->ReleaseHandle();
+		}
+	}
+
+	TexturePreloadHandles.Empty();
+	ObjectTexturePaths.Empty();
+	NumObjectsTexturesRequested = 0;
+}
+
+bool UEluProcessor::FillMaterialInstanceTextureParameter(UMaterialInstanceConstant * MIConstant, FName ParamName, FName TextureName)
+{
+	FString LogMessage;
+
+	const FAssetData* TextureAssetData = FEluAssetRegistrySnapshot::Get().FindTexture(TextureName);
+	if (TextureAssetData)
+	{
+		// Textures of the batch are normally resident by now. One that is still loading gets its load flushed here.
+		FTextureParameterValue TexParam;
+		TexParam.ParameterInfo.Name = ParamName;
+		if (TextureAssetData->IsAssetLoaded())
+		{
+			TexParam.ParameterValue = Cast<UTexture>(TextureAssetData->GetAsset());
+		}
 		else
 		{
-			LogMessage = FString("Required texture parameter `Normal` (Body_mat) is missing. Cancelling parameter fill");
-			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-			return false;
+			FEluImportPhaseScope PhaseScope(EEluImportPhase::TextureLoad);
+			TexParam.ParameterValue = Cast<UTexture>(TextureAssetData->GetAsset());
+			FEluImportReport::Get().AddCount(EEluImportCounter::TexturesLoaded);
 		}
+		MIConstant->TextureParameterValues.Add(TexParam);
+		return true;
 	}
 	else
 	{
-		if (MatInfo.bMaterialType_TwoSided)
+		LogMessage = FString("Couldn't find the texture: ") + TextureName.ToString() +
+			FString(", required by parameter: ") + ParamName.ToString() + FString(", on material instance: ") +
+			MIConstant->GetName();
+		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+		return false;
+	}
+}
+
+bool UEluProcessor::FillMaterialInstanceParameters(UMaterialInstanceConstant * MIConstant, const FEluMatInfo & MatInfo, FName* OutFailedTextureName)
+{
+	FString LogMessage;
+
+	if (!IsValid(MIConstant))
+	{
+		return false;
+	}
+
+	LogMessage = FString("Filling material instance parameters for material instance: ") + MIConstant->GetName();
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+	// Human skin materials have fixed parameters and are always one sided
+	if (MatInfo.bMaterialType_TwoSided && !FEluMatPermutation::IsHumanPermutation(MatInfo.Permutation))
+	{
+		MIConstant->BasePropertyOverrides.bOverride_TwoSided = true;
+		MIConstant->BasePropertyOverrides.TwoSided = true;
+	}
+
+	uint32 RequiredParameters = FEluMatPermutation::GetRequiredParameters(MatInfo.Permutation);
+
+	for (const FEluMatParameterDesc& ParameterDesc : FEluMatPermutation::GetTextureParameters())
+	{
+		if (!(RequiredParameters & ParameterDesc.Parameter))
 		{
-			MIConstant->BasePropertyOverrides.bOverride_TwoSided = true;
-			MIConstant->BasePropertyOverrides.TwoSided = true;
+			continue;
 		}
 
-		if (EditorMatName.Contains(TEXT("D")))
+		FName TextureName = MatInfo.*ParameterDesc.Texture;
+		if (TextureName.IsNone())
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("Diffuse"), FName(*MatInfo.Texture_DiffuseMap));
-			if (!bResult)
-			{
-				return bResult;
-			}
+			LogMessage = FString("Required texture parameter `") + ParameterDesc.ParameterName + FString("` (") +
+				FEluMatPermutation::GetParentMaterialName(MatInfo.Permutation).ToString() + FString(") is missing. Cancelling parameter fill");
+			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+			return false;
 		}
 
-		if (EditorMatName.Contains(TEXT("S")))
+		bool bResult = FillMaterialInstanceTextureParameter(MIConstant, ParameterDesc.ParameterName, TextureName);
+		if (!bResult)
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("Specular"), FName(*MatInfo.Texture_SpecularMap));
-			if (!bResult)
+			if (OutFailedTextureName)
 			{
-				return bResult;
+				*OutFailedTextureName = TextureName;
 			}
+			return bResult;
 		}
+	}
+
+	if (RequiredParameters & EEluMatParameter::GlowIntensity)
+	{
+		FScalarParameterValue GlowIntensityParamValue;
+		GlowIntensityParamValue.ParameterInfo.Name = FName("GlowIntensity");
+		GlowIntensityParamValue.ParameterValue = MatInfo.Scalar_SelfIllusionScale;
+		MIConstant->ScalarParameterValues.Add(GlowIntensityParamValue);
+	}
+
+	return true;
+}
+
+UMaterial* UEluProcessor::FindParentMaterial(FName ParentMatName) const
+{
+	const FAssetData* AssetData = FEluAssetRegistrySnapshot::Get().FindParentMaterial(ParentMatName);
+	return AssetData ? Cast<UMaterial>(AssetData->GetAsset()) : nullptr;
+}
+
+int32 UEluProcessor::ValidateParentMaterialPermutations(const TMap<uint32, int32>& PermutationUseCounts) const
+{
+	FString LogMessage;
+
+	// Several permutations (e.g. two sided or not) share a parent material
+	TMap<FName, int32> ParentMaterialUseCounts;
+	for (const TPair<uint32, int32>& PermutationPair : PermutationUseCounts)
+	{
+		ParentMaterialUseCounts.FindOrAdd(FEluMatPermutation::GetParentMaterialName(PermutationPair.Key)) += PermutationPair.Value;
+	}
 
-		if (EditorMatName.Contains(TEXT("N")))
+	int32 NumMissing = 0;
+	for (const TPair<FName, int32>& ParentMaterialPair : ParentMaterialUseCounts)
+	{
+		if (!FEluAssetRegistrySnapshot::Get().FindParentMaterial(ParentMaterialPair.Key))
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("Normal"), FName(*MatInfo.Texture_NormalMap));
-			if (!bResult)
-			{
-				return bResult;
-			}
+			LogMessage = FString::Printf(TEXT("Parent material `%s` doesn't exist. It is needed by %d materials"), *ParentMaterialPair.Key.ToString(), ParentMaterialPair.Value);
+			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+			NumMissing++;
 		}
+	}
+
+	// The other way around, every registered parent material must belong to the permutation table and have the parameters its permutation fills
+	TMap<FName, uint32> PermutationsByParentMaterial;
+	TArray<uint32> AllPermutations;
+	FEluMatPermutation::GetAllPermutations(AllPermutations);
+	for (uint32 Permutation : AllPermutations)
+	{
+		PermutationsByParentMaterial.Add(FEluMatPermutation::GetParentMaterialName(Permutation), Permutation);
+	}
 
-		if (EditorMatName.Contains(TEXT("G")))
+	const FEluAssetRegistrySnapshot& AssetRegistrySnapshot = FEluAssetRegistrySnapshot::Get();
+	int32 NumRegistered = AssetRegistrySnapshot.GetSimpleMaterials().Num() + AssetRegistrySnapshot.GetHumanSkinMaterials().Num();
+	int32 NumInvalid = 0;
+	for (const TMap<FName, FAssetData>* ParentMaterials : { &AssetRegistrySnapshot.GetSimpleMaterials(), &AssetRegistrySnapshot.GetHumanSkinMaterials() })
+	{
+		for (const TPair<FName, FAssetData>& ParentMaterialPair : *ParentMaterials)
 		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("Glow"), FName(*MatInfo.Texture_SelfIlluminationMap));
-			if (!bResult)
+			const uint32* Permutation = PermutationsByParentMaterial.Find(ParentMaterialPair.Key);
+			if (!Permutation)
 			{
-				return bResult;
+				LogMessage = FString::Printf(TEXT("Parent material `%s` doesn't match any material permutation. No material instance will use it"), *ParentMaterialPair.Key.ToString());
+				UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+				NumInvalid++;
+				continue;
 			}
 
-			FScalarParameterValue GlowIntensityParamValue;
-			GlowIntensityParamValue.ParameterInfo.Name = FName("GlowIntensity");
-			GlowIntensityParamValue.ParameterValue = MatInfo.Scalar_SelfIllusionScale;
-			MIConstant->ScalarParameterValues.Add(GlowIntensityParamValue);
-		}
+			UMaterial* ParentMaterial = Cast<UMaterial>(ParentMaterialPair.Value.GetAsset());
+			if (!ParentMaterial)
+			{
+				continue;
+			}
 
-		// Intentionally case sensetive as "T" conflicts with "t" in "_mat"
-		if (EditorMatName.Contains(TEXT("TA"), ESearchCase::CaseSensitive) ||
-			EditorMatName.Contains(TEXT("T"), ESearchCase::CaseSensitive) ||
-			EditorMatName.Contains(TEXT("LA"), ESearchCase::CaseSensitive) ||
-			EditorMatName.Contains(TEXT("L"), ESearchCase::CaseSensitive))
-		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("OpacityMask"), FName(*MatInfo.Texture_OpacityMap));
-			if (!bResult)
+			TArray<FMaterialParameterInfo> ParameterInfos;
+			TArray<FGuid> ParameterIds;
+			ParentMaterial->GetAllTextureParameterInfo(ParameterInfos, ParameterIds);
+			TArray<FName> ParameterNames;
+			for (const FMaterialParameterInfo& ParameterInfo : ParameterInfos)
 			{
-				return bResult;
+				ParameterNames.Add(ParameterInfo.Name);
 			}
-		}
 
-		if (EditorMatName.Contains(TEXT("RA")))
-		{
-			bool bResult = FillMaterialInstanceTextureParameter(MIConstant, FName("ReflectMap"), FName(*MatInfo.Texture_ReflectMap));
-			if (!bResult)
+			uint32 RequiredParameters = FEluMatPermutation::GetRequiredParameters(*Permutation);
+			for (const FEluMatParameterDesc& ParameterDesc : FEluMatPermutation::GetTextureParameters())
 			{
-				return bResult;
+				if ((RequiredParameters & ParameterDesc.Parameter) && !ParameterNames.Contains(FName(ParameterDesc.ParameterName)))
+				{
+					LogMessage = FString::Printf(TEXT("Parent material `%s` has no texture parameter `%s`, which its material instances fill"), *ParentMaterialPair.Key.ToString(), ParameterDesc.ParameterName);
+					UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+					NumInvalid++;
+				}
+			}
+
+			if (RequiredParameters & EEluMatParameter::GlowIntensity)
+			{
+				ParentMaterial->GetAllScalarParameterInfo(ParameterInfos, ParameterIds);
+				bool bHasGlowIntensity = ParameterInfos.ContainsByPredicate([](const FMaterialParameterInfo& ParameterInfo) { return ParameterInfo.Name == FName("GlowIntensity"); });
+				if (!bHasGlowIntensity)
+				{
+					LogMessage = FString::Printf(TEXT("Parent material `%s` has no scalar parameter `GlowIntensity`, which its material instances fill"), *ParentMaterialPair.Key.ToString());
+					UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+					NumInvalid++;
+				}
 			}
 		}
 	}
 
-	return true;
+	LogMessage = FString::Printf(TEXT("Validated %d parent materials used so far, %d missing. Validated %d registered parent materials against %d permutations, %d problems"),
+		ParentMaterialUseCounts.Num(), NumMissing, NumRegistered, PermutationsByParentMaterial.Num(), NumInvalid);
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+	return NumMissing + NumInvalid;
+}
+
+UMaterialInstanceConstant* UEluProcessor::FindSharedMaterialInstance(uint64 MaterialHash, const FString& MIConstantName, const FEluMatInfo& MatInfo)
+{
+	UMaterialInstanceConstant* MIConstant = MIStore.FindMaterialInstance(MaterialHash);
+	if (MIConstant || EditorDir_MIs == UEluProcessor::EditorDir_MaterialInstances)
+	{
+		return MIConstant;
+	}
+
+	// Import workers create their material instances in a directory of their own, but those of earlier runs and other workers are reused all the same
+	const FAssetData* AssetData = FEluAssetRegistrySnapshot::Get().FindMaterialInstance(FName(*MIConstantName));
+	if (!AssetData)
+	{
+		return nullptr;
+	}
+
+	MIConstant = Cast<UMaterialInstanceConstant>(AssetData->GetAsset());
+	if (!MIConstant || !UEluProcessor::AreMaterialInstanceParametersSame(MIConstant, MatInfo))
+	{
+		return nullptr;
+	}
+
+	MIStore.AddMaterialInstance(MaterialHash, MIConstant);
+	return MIConstant;
 }
 
-EImportResult UEluProcessor::CreateAndApplyStaticMeshMaterials(UStaticMesh * StaticMesh, TMap<FString, FEluMatInfo> Map_EluMatsInfo)
+EImportResult UEluProcessor::CreateAndApplyStaticMeshMaterials(UStaticMesh * StaticMesh, const FEluMatSlotResolver & SlotResolver, const FString & FilePath_EluXml)
 {
 	FString LogMessage;
-	FString DialogMessage;
-	FText DialogText;
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::Materials);
 
 	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
 
@@ -1156,76 +2053,62 @@ EImportResult UEluProcessor::CreateAndApplyStaticMeshMaterials(UStaticMesh * Sta
 		return EImportResult::Failure;
 	}
 
+	FEluImportReport::Get().AddCount(EEluImportCounter::MaterialSlots, StaticMesh->StaticMaterials.Num());
+
 	for (FStaticMaterial& Mat : StaticMesh->StaticMaterials)
 	{
-		FString MatName = Mat.MaterialSlotName.ToString();
-		
-		if (!Map_EluMatsInfo.Contains(MatName))
+		FString SlotName = Mat.MaterialSlotName.ToString();
+		FString MatName;
+		EEluMatSlotMatch SlotMatch;
+		TArray<FString> AmbiguousMatNames;
+		const FEluMatInfo* ResolvedMatInfo = SlotResolver.Resolve(SlotName, MatName, SlotMatch, AmbiguousMatNames);
+
+		if (ResolvedMatInfo && SlotMatch != EEluMatSlotMatch::Exact)
 		{
-			LogMessage = FString("Couldn't find a material named `") + MatName +
-				FString("` on static mesh: `") + StaticMesh->GetName() + FString("`");
+			LogMessage = FString("Material slot `") + SlotName + FString("` on static mesh `") + StaticMesh->GetName() + FString("` resolved to material: ") + MatName;
 			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		}
 
-			LogMessage = FString("Attempting to fix material name. Material name changed from ") + MatName;
+		if (AmbiguousMatNames.Num() > 0)
+		{
+			LogMessage = FString("Material slot `") + SlotName + FString("` on static mesh `") + StaticMesh->GetName() + FString("` matches several materials: ") +
+				FString::Join(AmbiguousMatNames, TEXT(", ")) + FString(". Using: ") + AmbiguousMatNames[0];
+			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
 
-			for (TPair<FString, FEluMatInfo> EluMatInfoPair : Map_EluMatsInfo)
-			{
-				if (EluMatInfoPair.Key.Len() >= 64)
-				{
-					FString NewKey = UKismetStringLibrary::GetSubstring(EluMatInfoPair.Key, 0, 63);
-					if (NewKey == MatName)
-					{
-						Map_EluMatsInfo.Remove(EluMatInfoPair.Key);
-						Map_EluMatsInfo.Add(NewKey, EluMatInfoPair.Value);
-						UE_LOG(LogTemp, Warning, TEXT("Newkey is same as matname"));
-					}
-				}
-				/*
-				 The following code sometimes causes a bug and returns false for Map.Contains()
-				// for (TPair<FString, FEluMatInfo>& EluMatInfoPair : Map_EluMatsInfo)
-				if (EluMatInfoPair.Key.Len() >= 64)
-				{
-					EluMatInfoPair.Key = UKismetStringLibrary::GetSubstring(EluMatInfoPair.Key, 0, 63);
-					UE_LOG(LogTemp, Warning, TEXT("Changed EluMatInfoPair.Key"), *EluMatInfoPair.Key);
+			UEluProcessor::AddError(EEluErrorKind::MaterialSlotAmbiguous, FilePath_EluXml, StaticMesh->GetName(), SlotName, LogMessage);
+		}
 
-					UE_LOG(LogTemp, Warning, TEXT("%s"), *EluMatInfoPair.Key);
-					UE_LOG(LogTemp, Warning, TEXT("%s"), *MatName);
-				}
-				*/
+		if (ResolvedMatInfo)
+		{
+			const FEluMatInfo& MatInfo = *ResolvedMatInfo;
 
-				if (MatName.Contains(EluMatInfoPair.Key))
-				{
-					FString TrailingNumbers = MatName.Replace(*EluMatInfoPair.Key, TEXT(""));
-					if (TrailingNumbers.StartsWith(FString("_")))
-					{
-						MatName = EluMatInfoPair.Key;
-						break;
-					}
-				}
+			// An identical material may already have a material instance, under another name or from another elu object
+			uint64 MaterialHash = FEluMaterialInstanceStore::ComputeMaterialHash(MatInfo);
+			UMaterialInstanceConstant* SharedMIConstant = FindSharedMaterialInstance(MaterialHash, FString("MI_") + MatName, MatInfo);
+			if (SharedMIConstant)
+			{
+				LogMessage = FString("Using shared material instance `") + SharedMIConstant->GetName() + FString("` for material: ") + MatName;
+				UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+				Mat.MaterialInterface = SharedMIConstant;
+				FEluImportReport::Get().AddCount(EEluImportCounter::MaterialInstancesReused);
+				continue;
 			}
-			
-			LogMessage += FString(" to ") + MatName;
-			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
-		}
 
-		// Cannot use contains here. It gives false result sometimes. [https://answers.unrealengine.com/questions/459188/tmapcontains-returns-false-for-an-existing-key.html]
-		if (Map_EluMatsInfo.Contains(MatName))
-		{
-			FEluMatInfo MatInfo = Map_EluMatsInfo[MatName];
 			FString MIConstantName = FString("MI_") + MatName;
-			FString MIPackageName = UEluProcessor::EditorDir_MaterialInstances + FString("/") + MIConstantName;
+			FString MIPackageName = EditorDir_MIs + FString("/") + MIConstantName;
 
 			UPackage* MIPackage = nullptr;
 			UMaterialInstanceConstant* MIConstant = nullptr;
 
 			bool bCreateNewMatConstant = true;
 
-			if (FPackageName::DoesPackageExist(MIPackageName))
+			if (MISaveQueue.DoesPackageExist(MIPackageName))
 			{
 				LogMessage = FString("Material Instance package already exists: ") + MIPackageName;
 				UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
 
-				MIPackage = LoadPackage(nullptr, *MIPackageName, LOAD_None);
+				MIPackage = MISaveQueue.FindOrLoadPackage(MIPackageName);
 				if (MIPackage)
 				{
 					LogMessage = FString("Attempting to load material instance from existing package...");
@@ -1252,19 +2135,14 @@ EImportResult UEluProcessor::CreateAndApplyStaticMeshMaterials(UStaticMesh * Sta
 							UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
 							MIConstant = nullptr;
 							MIConstantName = FString("MI_") + MatName + FString("_") + StaticMesh->GetName();
-							MIPackageName = UEluProcessor::EditorDir_MaterialInstances + FString("/") + MIConstantName;
+							MIPackageName = EditorDir_MIs + FString("/") + MIConstantName;
 						}
 					}
 					else
 					{
 						LogMessage = FString("Couldn't find material instance in existing package: ") + MIPackageName + FString(". This shouldn't happen.");
-						DialogMessage = LogMessage + FString("\nDo you want to cancel further import?");
-						DialogText = FText::FromString(DialogMessage);
-						EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::YesNo, DialogText);
-
-						UEluProcessor::AddError(LogMessage);
-
-						if (AppReturnType == EAppReturnType::Yes)
+						EEluErrorPolicy ErrorAction = HandleError(EEluErrorKind::MaterialInstanceMissing, FilePath_EluXml, StaticMesh->GetName(), MatName, LogMessage, false);
+						if (ErrorAction == EEluErrorPolicy::Abort)
 						{
 							return EImportResult::Cancelled;
 						}
@@ -1279,87 +2157,111 @@ EImportResult UEluProcessor::CreateAndApplyStaticMeshMaterials(UStaticMesh * Sta
 
 			if (bCreateNewMatConstant)
 			{
-				MIPackage = CreatePackage(nullptr, *MIPackageName);
-				MIPackage->FullyLoad();
+				FEluImportPhaseScope MIPhaseScope(EEluImportPhase::MaterialInstances);
 
-				FString EditorMatName = UEluProcessor::GetEditorMatName(MatInfo);
-				UMaterial* BaseMaterial = nullptr;
+				FName EditorMatName = FEluMatPermutation::GetParentMaterialName(MatInfo.Permutation);
+				UMaterial* BaseMaterial = FindParentMaterial(EditorMatName);
 
-				if (AssetDataMap_SimpleMaterials.Contains(FName(*EditorMatName)))
+				for (int32 Attempt = 0; !BaseMaterial; Attempt++)
 				{
-					BaseMaterial = Cast<UMaterial>(AssetDataMap_SimpleMaterials[FName(*EditorMatName)].GetAsset());
-				}
-				else if (AssetDataMap_HumanSkinMaterials.Contains(FName(*EditorMatName)))
-				{
-					BaseMaterial = Cast<UMaterial>(AssetDataMap_HumanSkinMaterials[FName(*EditorMatName)].GetAsset());
+					// Reported once for the whole batch already
+					if (MissingParentMatsReported.Contains(EditorMatName))
+					{
+						break;
+					}
+
+					LogMessage = FString("Couldn't find the base material named `") + EditorMatName.ToString() + FString("` needed for material instance `") +
+						MIConstantName + FString("` on static mesh: ") + StaticMesh->GetName();
+					EEluErrorPolicy ErrorAction = HandleError(EEluErrorKind::ParentMaterialMissing, FilePath_EluXml, StaticMesh->GetName(), MatName, LogMessage, Attempt == 0);
+					if (ErrorAction == EEluErrorPolicy::Abort)
+					{
+						return EImportResult::Cancelled;
+					}
+					else if (ErrorAction != EEluErrorPolicy::Retry)
+					{
+						break;
+					}
+
+					// The parent material may have been added since the asset registry last scanned it
+					UEluProcessor::RescanEditorDir(FEluAssetRegistrySnapshot::Get().EditorDir_SimpleMaterials);
+					UEluProcessor::RescanEditorDir(FEluAssetRegistrySnapshot::Get().EditorDir_HumanSkinMaterials);
+					BaseMaterial = FindParentMaterial(EditorMatName);
 				}
 
+				// No package is left behind for material instances that can't be created
 				if (BaseMaterial)
 				{
+					MIPackage = CreatePackage(nullptr, *MIPackageName);
+					MIPackage->FullyLoad();
+
 					MIConstantFactoryNew->InitialParent = BaseMaterial;
 					MIConstant = Cast<UMaterialInstanceConstant>(MIConstantFactoryNew->FactoryCreateNew(UMaterialInstanceConstant::StaticClass(), MIPackage, FName(*MIConstantName), EObjectFlags::RF_Public | EObjectFlags::RF_Standalone, nullptr, GWarn));
 					AssetRegistryModule.AssetCreated(MIConstant);
-				}
-				else
-				{
-					LogMessage = FString("Couldn't find the base material named `") + EditorMatName + FString("` needed for material instance `") +
-						MIConstantName + FString("` on static mesh: ") + StaticMesh->GetName();
-					DialogMessage = LogMessage + FString("\nDo you want to cancel further import?");
-					DialogText = FText::FromString(DialogMessage);
-					EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::YesNo, DialogText);
-
-					UEluProcessor::AddError(LogMessage);
-
-					if (AppReturnType == EAppReturnType::Yes)
-					{
-						return EImportResult::Cancelled;
-					}
+					FEluImportReport::Get().AddCount(EEluImportCounter::MaterialInstancesCreated);
 				}
 			}
 
-			if (MIConstant)
+			if (MIConstant && !bCreateNewMatConstant)
+			{
+				// Parameters of the existing material instance are already the same, filling them again would only duplicate them
+				Mat.MaterialInterface = MIConstant;
+				FEluImportReport::Get().AddCount(EEluImportCounter::MaterialInstancesReused);
+				MIStore.AddMaterialInstance(MaterialHash, MIConstant);
+			}
+			else if (MIConstant)
 			{
-				FString ParentMatName = MIConstant->Parent->GetName();
-				bool bResult = UEluProcessor::FillMaterialInstanceParameters(MIConstant, ParentMatName, MatInfo);
+				FName FailedTextureName;
+				bool bResult = UEluProcessor::FillMaterialInstanceParameters(MIConstant, MatInfo, &FailedTextureName);
 
-				if (!bResult)
+				for (int32 Attempt = 0; !bResult; Attempt++)
 				{
-					LogMessage = FString("Some error occured while filling materials for static mesh : ") + StaticMesh->GetName();
-					DialogMessage = LogMessage + FString("\nDo you want to cancel further import?");
-					DialogText = FText::FromString(DialogMessage);
-					EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::YesNo, DialogText);
+					// Reported once for the whole batch already. Failures for any other reason are still journaled
+					if (!FailedTextureName.IsNone() && MissingTexturesReported.Contains(FailedTextureName))
+					{
+						break;
+					}
 
-					if (AppReturnType == EAppReturnType::Yes)
+					LogMessage = FString("Some error occured while filling materials for static mesh : ") + StaticMesh->GetName();
+					EEluErrorPolicy ErrorAction = HandleError(EEluErrorKind::MaterialParametersFailed, FilePath_EluXml, StaticMesh->GetName(), MatName, LogMessage, Attempt == 0);
+					if (ErrorAction == EEluErrorPolicy::Abort)
 					{
 						return EImportResult::Cancelled;
 					}
+					else if (ErrorAction != EEluErrorPolicy::Retry)
+					{
+						break;
+					}
+
+					// Missing textures may have been added since the asset registry last scanned them
+					UEluProcessor::RescanEditorDir(FEluAssetRegistrySnapshot::Get().EditorDir_Textures);
+					MIConstant->ClearParameterValuesEditorOnly();
+					FailedTextureName = NAME_None;
+					bResult = UEluProcessor::FillMaterialInstanceParameters(MIConstant, MatInfo, &FailedTextureName);
 				}
 
 				Mat.MaterialInterface = MIConstant;
 				MIConstant->PostEditChange();
 
 				MIConstant->MarkPackageDirty();
-				
+
 				/*
-					@NOTE  It's very very important to save material instance package on disk, 
+					@NOTE  It's very very important to save material instance package on disk,
 					otherwise FPackageName::DoesPackageExist(MIPackageName) won't be able to detect package.
+					The save is deferred to MISaveQueue, which reports the package as existing until it's flushed.
 				*/
-				FString FullPackagePath = FPaths::ProjectContentDir() + MIPackageName.Replace(TEXT("/Game/"), TEXT(""));
+				MISaveQueue.Enqueue(MIPackage);
 
-				UPackage::SavePackage(MIPackage, nullptr, EObjectFlags::RF_Public | EObjectFlags::RF_Standalone,
-									  *(FullPackagePath + FPackageName::GetAssetPackageExtension()));
+				if (bResult)
+				{
+					MIStore.AddMaterialInstance(MaterialHash, MIConstant);
+				}
 			}
 		}
 		else
 		{
-			LogMessage = FString("Couldn't find a material named `") + MatName + FString("` on static mesh: `") + StaticMesh->GetName();
-			DialogMessage = LogMessage + FString("\nDo you want to cancel further import?");
-			DialogText = FText::FromString(DialogMessage);
-			EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::YesNo, DialogText);
-			
-			UEluProcessor::AddError(LogMessage);
-
-			if (AppReturnType == EAppReturnType::Yes)
+			LogMessage = FString("Couldn't find a material named `") + SlotName + FString("` on static mesh: `") + StaticMesh->GetName();
+			EEluErrorPolicy ErrorAction = HandleError(EEluErrorKind::MaterialSlotUnresolved, FilePath_EluXml, StaticMesh->GetName(), SlotName, LogMessage, false);
+			if (ErrorAction == EEluErrorPolicy::Abort)
 			{
 				return EImportResult::Cancelled;
 			}
@@ -1369,11 +2271,10 @@ EImportResult UEluProcessor::CreateAndApplyStaticMeshMaterials(UStaticMesh * Sta
 	return EImportResult::Success;
 }
 
-EImportResult UEluProcessor::CreateAndApplySkeletalMeshMaterials(USkeletalMesh * SkeletalMesh, TMap<FString, FEluMatInfo> Map_EluMatsInfo)
+EImportResult UEluProcessor::CreateAndApplySkeletalMeshMaterials(USkeletalMesh * SkeletalMesh, const FEluMatSlotResolver & SlotResolver, const FString & FilePath_EluXml)
 {
 	FString LogMessage;
-	FString DialogMessage;
-	FText DialogText;
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::Materials);
 
 	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
 
@@ -1382,235 +2283,780 @@ EImportResult UEluProcessor::CreateAndApplySkeletalMeshMaterials(USkeletalMesh *
 		return EImportResult::Failure;
 	}
 
+	FEluImportReport::Get().AddCount(EEluImportCounter::MaterialSlots, SkeletalMesh->Materials.Num());
+
 	for (FSkeletalMaterial& Mat : SkeletalMesh->Materials)
 	{
-		FString MatName = Mat.MaterialSlotName.ToString();
+		FString SlotName = Mat.MaterialSlotName.ToString();
+		FString MatName;
+		EEluMatSlotMatch SlotMatch;
+		TArray<FString> AmbiguousMatNames;
+		const FEluMatInfo* ResolvedMatInfo = SlotResolver.Resolve(SlotName, MatName, SlotMatch, AmbiguousMatNames);
+
+		if (ResolvedMatInfo && SlotMatch != EEluMatSlotMatch::Exact)
+		{
+			LogMessage = FString("Material slot `") + SlotName + FString("` on skeletal mesh `") + SkeletalMesh->GetName() + FString("` resolved to material: ") + MatName;
+			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		}
 
-		if (!Map_EluMatsInfo.Contains(MatName))
+		if (AmbiguousMatNames.Num() > 0)
 		{
-			LogMessage = FString("Couldn't find a material named `") + MatName +
-				FString("` on skeletal mesh: `") + SkeletalMesh->GetName() + FString("`");
+			LogMessage = FString("Material slot `") + SlotName + FString("` on skeletal mesh `") + SkeletalMesh->GetName() + FString("` matches several materials: ") +
+				FString::Join(AmbiguousMatNames, TEXT(", ")) + FString(". Using: ") + AmbiguousMatNames[0];
 			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
 
-			LogMessage = FString("Attempting to fix material name. Material name changed from ") + MatName;
+			UEluProcessor::AddError(EEluErrorKind::MaterialSlotAmbiguous, FilePath_EluXml, SkeletalMesh->GetName(), SlotName, LogMessage);
+		}
+
+		if (ResolvedMatInfo)
+		{
+			const FEluMatInfo& MatInfo = *ResolvedMatInfo;
+
+			// An identical material may already have a material instance, under another name or from another elu object
+			uint64 MaterialHash = FEluMaterialInstanceStore::ComputeMaterialHash(MatInfo);
+			UMaterialInstanceConstant* SharedMIConstant = FindSharedMaterialInstance(MaterialHash, FString("MI_") + MatName, MatInfo);
+			if (SharedMIConstant)
+			{
+				LogMessage = FString("Using shared material instance `") + SharedMIConstant->GetName() + FString("` for material: ") + MatName;
+				UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+				Mat.MaterialInterface = SharedMIConstant;
+				FEluImportReport::Get().AddCount(EEluImportCounter::MaterialInstancesReused);
+				continue;
+			}
+
+			FString MIConstantName = FString("MI_") + MatName;
+			FString MIPackageName = EditorDir_MIs + FString("/") + MIConstantName;
+
+			UPackage* MIPackage = nullptr;
+			UMaterialInstanceConstant* MIConstant = nullptr;
+
+			bool bCreateNewMatConstant = true;
 
-			for (TPair<FString, FEluMatInfo> EluMatInfoPair : Map_EluMatsInfo)
+			if (MISaveQueue.DoesPackageExist(MIPackageName))
 			{
-				if (EluMatInfoPair.Key.Len() >= 64)
+				LogMessage = FString("Material Instance package already exists: ") + MIPackageName;
+				UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+
+				MIPackage = MISaveQueue.FindOrLoadPackage(MIPackageName);
+				if (MIPackage)
 				{
-					FString NewKey = UKismetStringLibrary::GetSubstring(EluMatInfoPair.Key, 0, 63);
-					if (NewKey == MatName)
+					LogMessage = FString("Attempting to load material instance from existing package...");
+					UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+					MIPackage->FullyLoad();
+					MIConstant = Cast<UMaterialInstanceConstant>(StaticFindObject(UMaterialInstanceConstant::StaticClass(), MIPackage, *MIConstantName));
+					if (MIConstant)
 					{
-						Map_EluMatsInfo.Remove(EluMatInfoPair.Key);
-						Map_EluMatsInfo.Add(NewKey, EluMatInfoPair.Value);
+						LogMessage = FString("Existing material instance found and loaded. Checking if the existing material instance contains different parameters...");
+						UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+
+						bool bResult = UEluProcessor::AreMaterialInstanceParametersSame(MIConstant, MatInfo);
+						if (bResult)
+						{
+							LogMessage = FString("Existing material instance parameters are same. Using the same material instance on current mesh.");
+							UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+							bCreateNewMatConstant = false;
+						}
+						else
+						{
+							LogMessage = FString("Existing material instance parameters are different. Creating a new material instance now.");
+							UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+							MIConstant = nullptr;
+							MIConstantName = FString("MI_") + MatName + FString("_") + SkeletalMesh->GetName();
+							MIPackageName = EditorDir_MIs + FString("/") + MIConstantName;
+						}
+					}
+					else
+					{
+						LogMessage = FString("Couldn't find material instance in existing package: ") + MIPackageName + FString(". This shouldn't happen.");
+						EEluErrorPolicy ErrorAction = HandleError(EEluErrorKind::MaterialInstanceMissing, FilePath_EluXml, SkeletalMesh->GetName(), MatName, LogMessage, false);
+						if (ErrorAction == EEluErrorPolicy::Abort)
+						{
+							return EImportResult::Cancelled;
+						}
 					}
 				}
-				/*
-				The following code sometimes causes a bug and returns false for Map.Contains()
-				// for (TPair<FString, FEluMatInfo>& EluMatInfoPair : Map_EluMatsInfo)
-				if (EluMatInfoPair.Key.Len() >= 64)
+				else
+				{
+					LogMessage = FString("Couldn't load the existing material package. Attempting to create a new material package now.");
+					UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+				}
+			}
+
+			if (bCreateNewMatConstant)
+			{
+				FEluImportPhaseScope MIPhaseScope(EEluImportPhase::MaterialInstances);
+
+				FName EditorMatName = FEluMatPermutation::GetParentMaterialName(MatInfo.Permutation);
+				UMaterial* BaseMaterial = FindParentMaterial(EditorMatName);
+
+				for (int32 Attempt = 0; !BaseMaterial; Attempt++)
 				{
-				EluMatInfoPair.Key = UKismetStringLibrary::GetSubstring(EluMatInfoPair.Key, 0, 63);
-				UE_LOG(LogTemp, Warning, TEXT("Changed EluMatInfoPair.Key"), *EluMatInfoPair.Key);
+					// Reported once for the whole batch already
+					if (MissingParentMatsReported.Contains(EditorMatName))
+					{
+						break;
+					}
+
+					LogMessage = FString("Couldn't find the base material named `") + EditorMatName.ToString() + FString("` needed for material instance `") +
+						MIConstantName + FString("` on skeletal mesh: ") + SkeletalMesh->GetName();
+					EEluErrorPolicy ErrorAction = HandleError(EEluErrorKind::ParentMaterialMissing, FilePath_EluXml, SkeletalMesh->GetName(), MatName, LogMessage, Attempt == 0);
+					if (ErrorAction == EEluErrorPolicy::Abort)
+					{
+						return EImportResult::Cancelled;
+					}
+					else if (ErrorAction != EEluErrorPolicy::Retry)
+					{
+						break;
+					}
 
-				UE_LOG(LogTemp, Warning, TEXT("%s"), *EluMatInfoPair.Key);
-				UE_LOG(LogTemp, Warning, TEXT("%s"), *MatName);
+					// The parent material may have been added since the asset registry last scanned it
+					UEluProcessor::RescanEditorDir(FEluAssetRegistrySnapshot::Get().EditorDir_SimpleMaterials);
+					UEluProcessor::RescanEditorDir(FEluAssetRegistrySnapshot::Get().EditorDir_HumanSkinMaterials);
+					BaseMaterial = FindParentMaterial(EditorMatName);
 				}
-				*/
 
-				if (MatName.Contains(EluMatInfoPair.Key))
+				// No package is left behind for material instances that can't be created
+				if (BaseMaterial)
+				{
+					MIPackage = CreatePackage(nullptr, *MIPackageName);
+					MIPackage->FullyLoad();
+
+					MIConstantFactoryNew->InitialParent = BaseMaterial;
+					MIConstant = Cast<UMaterialInstanceConstant>(MIConstantFactoryNew->FactoryCreateNew(UMaterialInstanceConstant::StaticClass(), MIPackage, FName(*MIConstantName), EObjectFlags::RF_Public | EObjectFlags::RF_Standalone, nullptr, GWarn));
+					AssetRegistryModule.AssetCreated(MIConstant);
+					FEluImportReport::Get().AddCount(EEluImportCounter::MaterialInstancesCreated);
+				}
+			}
+
+			if (MIConstant && !bCreateNewMatConstant)
+			{
+				// Parameters of the existing material instance are already the same, filling them again would only duplicate them
+				Mat.MaterialInterface = MIConstant;
+				FEluImportReport::Get().AddCount(EEluImportCounter::MaterialInstancesReused);
+				MIStore.AddMaterialInstance(MaterialHash, MIConstant);
+			}
+			else if (MIConstant)
+			{
+				FName FailedTextureName;
+				bool bResult = UEluProcessor::FillMaterialInstanceParameters(MIConstant, MatInfo, &FailedTextureName);
+
+				for (int32 Attempt = 0; !bResult; Attempt++)
 				{
-					FString TrailingNumbers = MatName.Replace(*EluMatInfoPair.Key, TEXT(""));
-					if (TrailingNumbers.StartsWith(FString("_")))
+					// Reported once for the whole batch already. Failures for any other reason are still journaled
+					if (!FailedTextureName.IsNone() && MissingTexturesReported.Contains(FailedTextureName))
+					{
+						break;
+					}
+
+					LogMessage = FString("Some error occured while filling materials for skeletal mesh : ") + SkeletalMesh->GetName();
+					EEluErrorPolicy ErrorAction = HandleError(EEluErrorKind::MaterialParametersFailed, FilePath_EluXml, SkeletalMesh->GetName(), MatName, LogMessage, Attempt == 0);
+					if (ErrorAction == EEluErrorPolicy::Abort)
+					{
+						return EImportResult::Cancelled;
+					}
+					else if (ErrorAction != EEluErrorPolicy::Retry)
 					{
-						MatName = EluMatInfoPair.Key;
 						break;
 					}
+
+					// Missing textures may have been added since the asset registry last scanned them
+					UEluProcessor::RescanEditorDir(FEluAssetRegistrySnapshot::Get().EditorDir_Textures);
+					MIConstant->ClearParameterValuesEditorOnly();
+					FailedTextureName = NAME_None;
+					bResult = UEluProcessor::FillMaterialInstanceParameters(MIConstant, MatInfo, &FailedTextureName);
+				}
+
+				Mat.MaterialInterface = MIConstant;
+				MIConstant->PostEditChange();
+
+				MIConstant->MarkPackageDirty();
+
+				/*
+					@NOTE  It's very very important to save material instance package on disk,
+					otherwise FPackageName::DoesPackageExist(MIPackageName) won't be able to detect package.
+					The save is deferred to MISaveQueue, which reports the package as existing until it's flushed.
+				*/
+				MISaveQueue.Enqueue(MIPackage);
+
+				if (bResult)
+				{
+					MIStore.AddMaterialInstance(MaterialHash, MIConstant);
 				}
 			}
-			LogMessage += FString(" to ") + MatName;
-			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
 		}
+		else
+		{
+			LogMessage = FString("Couldn't find a material named `") + SlotName + FString("` on skeletal mesh: `") + SkeletalMesh->GetName();
+			EEluErrorPolicy ErrorAction = HandleError(EEluErrorKind::MaterialSlotUnresolved, FilePath_EluXml, SkeletalMesh->GetName(), SlotName, LogMessage, false);
+			if (ErrorAction == EEluErrorPolicy::Abort)
+			{
+				return EImportResult::Cancelled;
+			}
+		}
+	}
+
+	return EImportResult::Success;
+}
+
+void UEluProcessor::TrackObjectPackage(UObject* Object)
+{
+	if (Object)
+	{
+		CurrentObjectPackages.AddUnique(Object->GetOutermost());
+	}
+}
+
+void UEluProcessor::FinishObjectPackages()
+{
+	FinishedObjectPackages.Append(CurrentObjectPackages);
+	CurrentObjectPackages.Empty();
+
+	if (IsOverMemoryBudget())
+	{
+		SaveAndUnloadFinishedPackages();
+	}
+	else if (bSaveEachObject)
+	{
+		SaveFinishedPackages();
+	}
+}
+
+bool UEluProcessor::IsOverMemoryBudget() const
+{
+	if (MemoryBudgetMB <= 0)
+	{
+		return false;
+	}
+
+	FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	return MemoryStats.UsedPhysical > (uint64)MemoryBudgetMB * 1024 * 1024;
+}
+
+int32 UEluProcessor::SaveFinishedPackages()
+{
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::Save);
+
+	FEluPackageSaveQueue ObjectSaveQueue;
+	for (const TWeakObjectPtr<UPackage>& FinishedPackage : FinishedObjectPackages)
+	{
+		UPackage* Package = FinishedPackage.Get();
+		if (Package && Package->IsDirty())
+		{
+			ObjectSaveQueue.Enqueue(Package);
+		}
+	}
+	int32 NumPackagesSaved = ObjectSaveQueue.Num();
+	ObjectSaveQueue.Flush();
+
+	Checkpoint.FlushSaved();
+
+	return NumPackagesSaved;
+}
+
+int32 UEluProcessor::SaveAndUnloadFinishedPackages()
+{
+	FString LogMessage;
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::Save);
+
+	uint64 UsedPhysicalBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+	SaveFinishedPackages();
+
+	// A package that failed to save would lose its import if it was unloaded now
+	TArray<UPackage*> PackagesToUnload;
+	for (const TWeakObjectPtr<UPackage>& FinishedPackage : FinishedObjectPackages)
+	{
+		UPackage* Package = FinishedPackage.Get();
+		if (Package && !Package->IsDirty())
+		{
+			PackagesToUnload.AddUnique(Package);
+		}
+	}
+	FinishedObjectPackages.Empty();
+
+	// Also collects garbage, which frees whatever the fbx factories left behind
+	if (PackagesToUnload.Num() > 0)
+	{
+		PackageTools::UnloadPackages(PackagesToUnload);
+	}
+	else
+	{
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	uint64 UsedPhysicalAfter = FPlatformMemory::GetStats().UsedPhysical;
+
+	LogMessage = FString::Printf(TEXT("Memory budget of %d MB exceeded. Unloaded %d packages of finished elu objects: %llu MB -> %llu MB"),
+		MemoryBudgetMB, PackagesToUnload.Num(), UsedPhysicalBefore / (1024 * 1024), UsedPhysicalAfter / (1024 * 1024));
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+	if (UsedPhysicalAfter > (uint64)MemoryBudgetMB * 1024 * 1024)
+	{
+		LogMessage = FString::Printf(TEXT("Memory is still over budget after unloading finished elu objects. The budget of %d MB may be too low for this batch"), MemoryBudgetMB);
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+	}
+
+	return PackagesToUnload.Num();
+}
+
+void UEluProcessor::PrecomputeSourceFileHashes(const TArray<FString>& FilePaths_Source)
+{
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::SourceHash);
+
+	TArray<FString> FilePathsToHash;
+	for (const FString& FilePath_Source : FilePaths_Source)
+	{
+		if (!SourceFileHashes.Contains(FilePath_Source))
+		{
+			FilePathsToHash.AddUnique(FilePath_Source);
+		}
+	}
+
+	// Hashing only reads the files, so it can run on worker threads. The fbx importer itself isn't thread safe and stays on the game thread.
+	TArray<FMD5Hash> FileHashes;
+	FileHashes.SetNum(FilePathsToHash.Num());
+	ParallelFor(FilePathsToHash.Num(), [&FilePathsToHash, &FileHashes](int32 Index)
+	{
+		FileHashes[Index] = UEluProcessor::HashSourceFile(FilePathsToHash[Index]);
+	});
+
+	for (int32 Index = 0; Index < FilePathsToHash.Num(); Index++)
+	{
+		SourceFileHashes.Add(FilePathsToHash[Index], FileHashes[Index]);
+	}
+}
+
+void UEluProcessor::PrefilterObjectFbxFiles(const FEluImportFilesInfo& EluImportFilesInfo, bool bWithAnimations)
+{
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::FbxPrefilter);
+	FbxPrefilter.ClassifyFiles(EluImportFilesInfo.FilePaths_EluModels, SourceFileHashes);
+
+	// Stacks and bones of the animations decide which skeleton each of them is imported for
+	if (bWithAnimations && EluImportFilesInfo.FilePaths_EluAnimations.Num() > 0)
+	{
+		FbxPrefilter.ClassifyFiles(EluImportFilesInfo.FilePaths_EluAnimations.Array(), SourceFileHashes, true);
+	}
+}
+
+void UEluProcessor::GenerateSkeletalMeshLODs(const TArray<USkeletalMesh*>& SkeletalMeshes, EEluModelType ModelType)
+{
+	FString LogMessage;
+
+	const TArray<FEluSkeletalLODSettings>& LODSettings = GetFbxImportPreset(ModelType).SkeletalLODs;
+	if (!bGenerateSkeletalLODs || LODSettings.Num() == 0 || SkeletalMeshes.Num() == 0)
+	{
+		return;
+	}
+
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::SkeletalLODs);
+
+	// Sockets are read on the game thread. Whatever hangs from them keeps its bone at every LOD
+	TArray<TArray<FName>> SocketBoneNames;
+	SocketBoneNames.SetNum(SkeletalMeshes.Num());
+	for (int32 MeshIndex = 0; MeshIndex < SkeletalMeshes.Num(); MeshIndex++)
+	{
+		for (USkeletalMeshSocket* Socket : SkeletalMeshes[MeshIndex]->GetActiveSocketList())
+		{
+			if (Socket)
+			{
+				SocketBoneNames[MeshIndex].AddUnique(Socket->BoneName);
+			}
+		}
+	}
+
+	// Reference skeletons aren't touched until the reductions below
+	TArray<TArray<TArray<FName>>> BoneNamesToRemove;
+	BoneNamesToRemove.SetNum(SkeletalMeshes.Num());
+	ParallelFor(SkeletalMeshes.Num(), [&SkeletalMeshes, &SocketBoneNames, &LODSettings, &BoneNamesToRemove](int32 MeshIndex)
+	{
+		UEluProcessor::FindLeafBonesToRemove(SkeletalMeshes[MeshIndex]->RefSkeleton, SocketBoneNames[MeshIndex], LODSettings, BoneNamesToRemove[MeshIndex]);
+	});
+
+	IMeshBoneReduction* MeshBoneReduction = FModuleManager::Get().LoadModuleChecked<IMeshBoneReductionModule>("MeshBoneReduction").GetMeshBoneReductionInterface();
+
+	for (int32 MeshIndex = 0; MeshIndex < SkeletalMeshes.Num(); MeshIndex++)
+	{
+		USkeletalMesh* SkeletalMesh = SkeletalMeshes[MeshIndex];
+
+		FSkeletalMeshUpdateContext UpdateContext;
+		UpdateContext.SkeletalMesh = SkeletalMesh;
+
+		// Reimporting keeps the LODs of the previous import, which may have had a longer chain
+		while (SkeletalMesh->LODInfo.Num() > LODSettings.Num() + 1)
+		{
+			FLODUtilities::RemoveLOD(UpdateContext, SkeletalMesh->LODInfo.Num() - 1);
+		}
+
+		// Every LOD is reduced from LOD 0 with the settings stored on the mesh, so a later reimport or up to date check sees the same chain
+		for (int32 LODIndex = 1; LODIndex <= LODSettings.Num(); LODIndex++)
+		{
+			if (SkeletalMesh->LODInfo.Num() <= LODIndex)
+			{
+				SkeletalMesh->AddLODInfo();
+			}
+
+			FSkeletalMeshLODInfo& LODInfo = SkeletalMesh->LODInfo[LODIndex];
+			LODInfo.ReductionSettings.ReductionMethod = SMOT_NumOfTriangles;
+			LODInfo.ReductionSettings.NumOfTrianglesPercentage = LODSettings[LODIndex - 1].TrianglePercentage;
+			LODInfo.ReductionSettings.BaseLOD = 0;
+			LODInfo.ScreenSize = LODSettings[LODIndex - 1].ScreenSize;
+
+			FLODUtilities::SimplifySkeletalMeshLOD(UpdateContext, LODIndex);
+		}
+
+		if (SkeletalMesh->GetImportedModel()->LODModels.Num() != LODSettings.Num() + 1)
+		{
+			LogMessage = FString::Printf(TEXT("Generated %d of %d LODs of skeletal mesh: "), SkeletalMesh->GetImportedModel()->LODModels.Num() - 1, LODSettings.Num()) + SkeletalMesh->GetName();
+			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		}
+
+		// The bone reduction rebuilds the render data of the LOD itself
+		for (int32 LODIndex = 1; LODIndex < SkeletalMesh->GetImportedModel()->LODModels.Num(); LODIndex++)
+		{
+			FSkeletalMeshLODInfo& LODInfo = SkeletalMesh->LODInfo[LODIndex];
+
+			LODInfo.BonesToRemove.Empty();
+			for (const FName& BoneName : BoneNamesToRemove[MeshIndex][LODIndex - 1])
+			{
+				LODInfo.BonesToRemove.Add(FBoneReference(BoneName));
+			}
+
+			if (LODInfo.BonesToRemove.Num() > 0 && MeshBoneReduction)
+			{
+				MeshBoneReduction->ReduceBoneCounts(SkeletalMesh, LODIndex);
+			}
+		}
+
+		SkeletalMesh->MarkPackageDirty();
+
+		FEluSkeletalLODRecord SkeletalLODRecord;
+		SkeletalLODRecord.MeshName = SkeletalMesh->GetName();
+		for (const FSkeletalMeshLODModel& LODModel : SkeletalMesh->GetImportedModel()->LODModels)
+		{
+			SkeletalLODRecord.NumTriangles.Add(LODModel.GetTotalFaces());
+			SkeletalLODRecord.NumBones.Add(LODModel.RequiredBones.Num());
+		}
+		FEluImportReport::Get().AddSkeletalLODRecord(SkeletalLODRecord);
+
+		LogMessage = FString::Printf(TEXT("Generated %d LODs of skeletal mesh %s: "), SkeletalLODRecord.NumTriangles.Num() - 1, *SkeletalLODRecord.MeshName);
+		for (int32 LODIndex = 0; LODIndex < SkeletalLODRecord.NumTriangles.Num(); LODIndex++)
+		{
+			LogMessage += FString::Printf(TEXT("%s%d triangles/%d bones"), LODIndex > 0 ? TEXT(", ") : TEXT(""), SkeletalLODRecord.NumTriangles[LODIndex], SkeletalLODRecord.NumBones[LODIndex]);
+		}
+		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+	}
+}
+
+bool UEluProcessor::HasSkeletalMeshLODs(const USkeletalMesh* SkeletalMesh, EEluModelType ModelType) const
+{
+	const TArray<FEluSkeletalLODSettings>& LODSettings = GetFbxImportPreset(ModelType).SkeletalLODs;
+	if (!bGenerateSkeletalLODs || LODSettings.Num() == 0)
+	{
+		return true;
+	}
+
+	if (SkeletalMesh->LODInfo.Num() != LODSettings.Num() + 1 || SkeletalMesh->GetImportedModel()->LODModels.Num() != LODSettings.Num() + 1)
+	{
+		return false;
+	}
+
+	for (int32 LODIndex = 1; LODIndex <= LODSettings.Num(); LODIndex++)
+	{
+		const FSkeletalMeshOptimizationSettings& ReductionSettings = SkeletalMesh->LODInfo[LODIndex].ReductionSettings;
+		if (ReductionSettings.BaseLOD != 0 || !FMath::IsNearlyEqual(ReductionSettings.NumOfTrianglesPercentage, LODSettings[LODIndex - 1].TrianglePercentage))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UEluProcessor::FindLeafBonesToRemove(const FReferenceSkeleton& RefSkeleton, const TArray<FName>& KeptBoneNames, const TArray<FEluSkeletalLODSettings>& LODSettings,
+										  TArray<TArray<FName>>& OutBoneNamesToRemove)
+{
+	int32 NumBones = RefSkeleton.GetRawBoneNum();
+
+	TArray<bool> bKeepBones;
+	bKeepBones.SetNumZeroed(NumBones);
+	for (const FName& KeptBoneName : KeptBoneNames)
+	{
+		for (int32 BoneIndex = RefSkeleton.FindRawBoneIndex(KeptBoneName); BoneIndex != INDEX_NONE; BoneIndex = RefSkeleton.GetRawParentIndex(BoneIndex))
+		{
+			bKeepBones[BoneIndex] = true;
+		}
+	}
+
+	// Levels between each bone and the deepest leaf below it. Parents always come before their children
+	TArray<int32> BoneHeights;
+	BoneHeights.SetNumZeroed(NumBones);
+	for (int32 BoneIndex = NumBones - 1; BoneIndex > 0; BoneIndex--)
+	{
+		int32 ParentIndex = RefSkeleton.GetRawParentIndex(BoneIndex);
+		BoneHeights[ParentIndex] = FMath::Max(BoneHeights[ParentIndex], BoneHeights[BoneIndex] + 1);
+	}
+
+	OutBoneNamesToRemove.SetNum(LODSettings.Num());
+	for (int32 LODIndex = 0; LODIndex < LODSettings.Num(); LODIndex++)
+	{
+		for (int32 BoneIndex = 1; BoneIndex < NumBones; BoneIndex++)
+		{
+			if (!bKeepBones[BoneIndex] && BoneHeights[BoneIndex] < LODSettings[LODIndex].NumLeafBoneLevelsToRemove)
+			{
+				OutBoneNamesToRemove[LODIndex].Add(RefSkeleton.GetBoneName(BoneIndex));
+			}
+		}
+	}
+}
 
-		if (Map_EluMatsInfo.Contains(MatName))
-		{
-			FEluMatInfo MatInfo = Map_EluMatsInfo[MatName];
-			FString MIConstantName = FString("MI_") + MatName;
-			FString MIPackageName = UEluProcessor::EditorDir_MaterialInstances + FString("/") + MIConstantName;
+void UEluProcessor::ImportEluAnimations(const FEluImportFilesInfo & EluImportFilesInfo, const FString & EditorDir_ModelPackage, TArray<FEluAnimationTarget>& AnimationTargets)
+{
+	FString LogMessage;
+	FEluImportPhaseScope PhaseScope(EEluImportPhase::Animations);
 
-			UPackage* MIPackage = nullptr;
-			UMaterialInstanceConstant* MIConstant = nullptr;
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
 
-			bool bCreateNewMatConstant = true;
+	TArray<FString> FilePaths_AnimationsToImport;
+	for (const FString& FilePath_Animation : EluImportFilesInfo.FilePaths_EluAnimations)
+	{
+		FString FileName_Animation = FPaths::GetBaseFilename(FilePath_Animation);
+		FString AniPackageName = PackageTools::SanitizePackageName(EditorDir_ModelPackage + FString("/") + FString("ani") + FString("/") + FileName_Animation);
+		FString AniObjectPath = AniPackageName + FString(".") + FileName_Animation;
+		if (!IsImportedAssetUpToDate(AniObjectPath, FilePath_Animation, FString()))
+		{
+			FilePaths_AnimationsToImport.Add(FilePath_Animation);
+		}
+	}
+
+	if (FilePaths_AnimationsToImport.Num() == 0)
+	{
+		return;
+	}
 
-			if (FPackageName::DoesPackageExist(MIPackageName))
+	// Unchanged skeletal meshes are only loaded once one of the animations actually needs to be imported
+	TArray<USkeleton*> Skeletons;
+	for (FEluAnimationTarget& AnimationTarget : AnimationTargets)
+	{
+		if (!AnimationTarget.SkeletalMesh)
+		{
+			AnimationTarget.SkeletalMesh = Cast<USkeletalMesh>(AssetRegistryModule.Get().GetAssetByObjectPath(FName(*AnimationTarget.SkeletalMeshObjectPath)).GetAsset());
+			if (!AnimationTarget.SkeletalMesh)
 			{
-				LogMessage = FString("Material Instance package already exists: ") + MIPackageName;
+				LogMessage = FString("Couldn't load existing skeletal mesh for animation import: ") + AnimationTarget.SkeletalMeshObjectPath;
 				UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+				continue;
+			}
 
-				MIPackage = LoadPackage(nullptr, *MIPackageName, LOAD_None);
-				if (MIPackage)
-				{
-					LogMessage = FString("Attempting to load material instance from existing package...");
-					UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-
-					MIPackage->FullyLoad();
-					MIConstant = Cast<UMaterialInstanceConstant>(StaticFindObject(UMaterialInstanceConstant::StaticClass(), MIPackage, *MIConstantName));
-					if (MIConstant)
-					{
-						LogMessage = FString("Existing material instance found and loaded. Checking if the existing material instance contains different parameters...");
-						UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+			TrackObjectPackage(AnimationTarget.SkeletalMesh);
+			TrackObjectPackage(AnimationTarget.SkeletalMesh->Skeleton);
+		}
 
+		// Skeletal meshes that reuse a skeleton share its animations
+		if (AnimationTarget.SkeletalMesh->Skeleton)
+		{
+			Skeletons.AddUnique(AnimationTarget.SkeletalMesh->Skeleton);
+		}
+	}
 
-						bool bResult = UEluProcessor::AreMaterialInstanceParametersSame(MIConstant, MatInfo);
-						if (bResult)
-						{
-							LogMessage = FString("Existing material instance parameters are same. Using the same material instance on current mesh.");
-							UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-							bCreateNewMatConstant = false;
-						}
-						else
-						{
-							LogMessage = FString("Existing material instance parameters are different. Creating a new material instance now.");
-							UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
-							MIConstant = nullptr;
-							MIConstantName = FString("MI_") + MatName + FString("_") + SkeletalMesh->GetName();
-							MIPackageName = UEluProcessor::EditorDir_MaterialInstances + FString("/") + MIConstantName;
-						}
-					}
-					else
-					{
-						LogMessage = FString("Couldn't find material instance in existing package: ") + MIPackageName + FString(". This shouldn't happen.");
-						DialogMessage = LogMessage + FString("\nDo you want to cancel further import?");
-						DialogText = FText::FromString(DialogMessage);
-						EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::YesNo, DialogText);
+	if (Skeletons.Num() == 0)
+	{
+		return;
+	}
 
-						UEluProcessor::AddError(LogMessage);
+	// Each animation is imported exactly once, grouped by the skeleton its bones belong to
+	TMap<USkeleton*, TArray<FString>> AnimationsBySkeleton;
+	for (const FString& FilePath_Animation : FilePaths_AnimationsToImport)
+	{
+		AnimationsBySkeleton.FindOrAdd(FindAnimationSkeleton(FilePath_Animation, Skeletons)).Add(FilePath_Animation);
+	}
 
-						if (AppReturnType == EAppReturnType::Yes)
-						{
-							return EImportResult::Cancelled;
-						}
-					}
-				}
-				else
-				{
-					LogMessage = FString("Couldn't load the existing material package. Attempting to create a new material package now.");
-					UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
-				}
-			}
+	for (const TPair<USkeleton*, TArray<FString>>& SkeletonAnimationsPair : AnimationsBySkeleton)
+	{
+		USkeleton* Skeleton = SkeletonAnimationsPair.Key;
 
-			if (bCreateNewMatConstant)
-			{
-				MIPackage = CreatePackage(nullptr, *MIPackageName);
-				MIPackage->FullyLoad();
+		LogMessage = FString::Printf(TEXT("Importing %d animations for skeleton: %s"), SkeletonAnimationsPair.Value.Num(), *Skeleton->GetName());
+		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
 
-				FString EditorMatName = UEluProcessor::GetEditorMatName(MatInfo);
-				UMaterial* BaseMaterial = nullptr;
+		for (const FString& FilePath_Animation : SkeletonAnimationsPair.Value)
+		{
+			FString FileName_Animation = FPaths::GetBaseFilename(FilePath_Animation);
+			FString AniPackageName = PackageTools::SanitizePackageName(EditorDir_ModelPackage + FString("/") + FString("ani") + FString("/") + FileName_Animation);
 
-				if (AssetDataMap_SimpleMaterials.Contains(FName(*EditorMatName)))
-				{
-					BaseMaterial = Cast<UMaterial>(AssetDataMap_SimpleMaterials[FName(*EditorMatName)].GetAsset());
-				}
-				else if (AssetDataMap_HumanSkinMaterials.Contains(FName(*EditorMatName)))
-				{
-					BaseMaterial = Cast<UMaterial>(AssetDataMap_HumanSkinMaterials[FName(*EditorMatName)].GetAsset());
-				}
+			LogMessage = FString("Importing animation file: ") + FileName_Animation;
+			UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
 
-				if (BaseMaterial)
-				{
-					MIConstantFactoryNew->InitialParent = BaseMaterial;
-					MIConstant = Cast<UMaterialInstanceConstant>(MIConstantFactoryNew->FactoryCreateNew(UMaterialInstanceConstant::StaticClass(), MIPackage, FName(*MIConstantName), EObjectFlags::RF_Public | EObjectFlags::RF_Standalone, nullptr, GWarn));
-					AssetRegistryModule.AssetCreated(MIConstant);
-				}
-				else
+			UPackage* AniPackage = nullptr;
+			if (FPackageName::DoesPackageExist(AniPackageName))
+			{
+				FString LogMessage = FString("Animation package for ") + FileName_Animation + FString(" already exists");
+				UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+				AniPackage = LoadPackage(nullptr, *AniPackageName, LOAD_None);
+				if (AniPackage)
 				{
-					LogMessage = FString("Couldn't find the base material named `") + EditorMatName + FString("` needed for material instance `") +
-						MIConstantName + FString("` on skeletal mesh: ") + SkeletalMesh->GetName();
-					DialogMessage = LogMessage + FString("\nDo you want to cancel further import?");
-					DialogText = FText::FromString(DialogMessage);
-					EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::YesNo, DialogText);
-
-					UEluProcessor::AddError(LogMessage);
-
-					if (AppReturnType == EAppReturnType::Yes)
-					{
-						return EImportResult::Cancelled;
-					}
+					AniPackage->FullyLoad();
 				}
 			}
-
-			if (MIConstant)
+			else
 			{
-				FString ParentMatName = MIConstant->Parent->GetName();
-				bool bResult = UEluProcessor::FillMaterialInstanceParameters(MIConstant, ParentMatName, MatInfo);
-
-				if (!bResult)
-				{
-					LogMessage = FString("Some error occured while filling materials for skeletal mesh : ") + SkeletalMesh->GetName();
-					DialogMessage = LogMessage + FString("\nDo you want to cancel further import?");
-					DialogText = FText::FromString(DialogMessage);
-					EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::YesNo, DialogText);
-
-					if (AppReturnType == EAppReturnType::Yes)
-					{
-						return EImportResult::Cancelled;
-					}
-				}
-
-				Mat.MaterialInterface = MIConstant;
-				MIConstant->PostEditChange();
+				AniPackage = CreatePackage(nullptr, *AniPackageName);
+				AniPackage->FullyLoad();
+			}
 
-				MIConstant->MarkPackageDirty();
+			UFbxAnimSequenceImportData* Data = NewObject<UFbxAnimSequenceImportData>();
+			// The importer may name the sequence after the animation stack, so it is only found through the return value
+			UAnimSequence* ImportedAnimSequence = UEditorEngine::ImportFbxAnimation(Skeleton, AniPackage, Data, *FilePath_Animation, *FileName_Animation, false);
 
-				/*
-				@NOTE  It's very very important to save material instance package on disk,
-				otherwise FPackageName::DoesPackageExist(MIPackageName) won't be able to detect package.
-				*/
-				FString FullPackagePath = FPaths::ProjectContentDir() + MIPackageName.Replace(TEXT("/Game/"), TEXT(""));
+			TrackObjectPackage(AniPackage);
 
-				UPackage::SavePackage(MIPackage, nullptr, EObjectFlags::RF_Public | EObjectFlags::RF_Standalone,
-									  *(FullPackagePath + FPackageName::GetAssetPackageExtension()));
+			if (ImportedAnimSequence)
+			{
+				RecordSourceFileHashes(ImportedAnimSequence->AssetImportData, FilePath_Animation, FString());
+				NumAnimationsImported++;
+				FEluImportReport::Get().AddCount(EEluImportCounter::Animations);
+			}
+			else
+			{
+				LogMessage = FString("Failed to import animation: ") + FilePath_Animation;
+				UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
 			}
 		}
-		else
+	}
+}
+
+USkeleton* UEluProcessor::FindAnimationSkeleton(const FString& FilePath_Animation, const TArray<USkeleton*>& Skeletons)
+{
+	const FEluFbxSceneInfo* SceneInfo = FbxPrefilter.FindSceneInfo(GetSourceFileHash(FilePath_Animation));
+	if (Skeletons.Num() == 1 || !SceneInfo || !SceneInfo->bAnimationsRead)
+	{
+		return Skeletons[0];
+	}
+
+	USkeleton* BestSkeleton = Skeletons[0];
+	int32 BestNumBonesFound = -1;
+	for (USkeleton* Skeleton : Skeletons)
+	{
+		const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+		if (!SceneInfo->RootBoneName.IsNone() && RefSkeleton.FindBoneIndex(SceneInfo->RootBoneName) == INDEX_NONE)
 		{
-			LogMessage = FString("Couldn't find a material named `") + MatName + FString("` on skeletal mesh: `") + SkeletalMesh->GetName();
-			DialogMessage = LogMessage + FString("\nDo you want to cancel further import?");
-			DialogText = FText::FromString(DialogMessage);
-			EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::YesNo, DialogText);
+			continue;
+		}
 
-			UEluProcessor::AddError(LogMessage);
+		int32 NumBonesFound = 0;
+		for (FName BoneName : SceneInfo->BoneNames)
+		{
+			NumBonesFound += RefSkeleton.FindBoneIndex(BoneName) != INDEX_NONE ? 1 : 0;
+		}
 
-			if (AppReturnType == EAppReturnType::Yes)
-			{
-				return EImportResult::Cancelled;
-			}
+		if (NumBonesFound > BestNumBonesFound)
+		{
+			BestSkeleton = Skeleton;
+			BestNumBonesFound = NumBonesFound;
 		}
 	}
 
-	return EImportResult::Success;
+	return BestSkeleton;
 }
 
 EImportResult UEluProcessor::ImportEluModels(const TArray<FString>& InPaths_EluXmlFilesToLoad, TArray<FString>& OutPaths_EluXmlFilesLoaded)
 {
-	FString DialogMessage;
-	FText DialogText;
 	FString LogMessage;
 
 	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
 	StaticFbxFactory->ResetState();
 	SkeletalFbxFactory->ResetState();
 
+	// Written on every way out, cancelled batches are the ones that most need explaining
+	FEluImportReport& ImportReport = FEluImportReport::Get();
+	ImportReport.BeginBatch();
+	ON_SCOPE_EXIT
+	{
+		ImportReport.EndBatch();
+		ImportReport.WriteJson(FilePath_ImportReport);
+		ImportReport.AppendCsv(FPaths::ChangeExtension(FilePath_ImportReport, TEXT("csv")));
+	};
+
+	// Source files may have changed since the last batch
+	SourceFileHashes.Empty();
+	ErrorCounts.Empty();
+	NumMeshesImported = 0;
+	NumAnimationsImported = 0;
+
+	// Elu objects a previous run already finished are dropped before any of their packages, textures or fbx files are touched
+	Checkpoint.Open(FilePath_Checkpoint, bResume);
+
+	RestatEluObjectFiles(InPaths_EluXmlFilesToLoad);
+
+	TMap<FString, FString> Fingerprints;
+	TArray<FString> Paths_EluXmlFilesToImport;
 	for (const FString& FilePath_EluXml : InPaths_EluXmlFilesToLoad)
 	{
-		FEluImportFilesInfo EluImportFilesInfo(FilePath_EluXml);
+		FString Fingerprint = FEluImportCheckpoint::ComputeFingerprint(FileIndex, FilePath_EluXml);
+		if (bResume && Checkpoint.IsCompleted(FilePath_EluXml, Fingerprint))
+		{
+			OutPaths_EluXmlFilesLoaded.Add(FilePath_EluXml);
+			continue;
+		}
+
+		Fingerprints.Add(FilePath_EluXml, Fingerprint);
+		Paths_EluXmlFilesToImport.Add(FilePath_EluXml);
+	}
+
+	if (bResume)
+	{
+		LogMessage = FString::Printf(TEXT("Resumed import passes over %d finished elu objects, %d left to import"), InPaths_EluXmlFilesToLoad.Num() - Paths_EluXmlFilesToImport.Num(), Paths_EluXmlFilesToImport.Num());
+		UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+	}
+
+	// Missing textures and parent materials are found here, before anything is imported, instead of one material slot at a time
+	TArray<FString> Paths_EluXmlFilesRejected;
+	TMap<FString, TArray<FName>> ObjectTextureNames;
+	if (ValidateBatchMaterials(Paths_EluXmlFilesToImport, Paths_EluXmlFilesRejected, ObjectTextureNames) == EImportResult::Cancelled)
+	{
+		return EImportResult::Cancelled;
+	}
+
+	// Textures load in the background while models are imported
+	PreloadBatchTextures(Paths_EluXmlFilesToImport, ObjectTextureNames);
+
+	for (int32 ObjectIndex = 0; ObjectIndex < Paths_EluXmlFilesToImport.Num(); ObjectIndex++)
+	{
+		const FString& FilePath_EluXml = Paths_EluXmlFilesToImport[ObjectIndex];
+		PreloadUpcomingTextures(ObjectIndex);
+
+		OnEluXmlImportStarted.ExecuteIfBound(FilePath_EluXml);
+		ImportReport.BeginObject(FilePath_EluXml);
+
+		FEluImportFilesInfo EluImportFilesInfo(FilePath_EluXml, &FileIndex, MatInfoCache.Get());
+		FEluMatSlotResolver SlotResolver(EluImportFilesInfo.Map_EluMatsInfo);
 		EEluModelType EluXmlModelType = UEluProcessor::GetEluModelType(FilePath_EluXml);
 
 		// FString DialogMessage_EluXmlInfo = FString("Current EluXmlFile : ") + FilePath_EluXml + FString("\n");
 
 		bool bMaterialImportError = false;
 
+		// Up-to-date checks need the hash of every source file of the object, which is computed in parallel up front
+		TArray<FString> FilePaths_Source = EluImportFilesInfo.FilePaths_EluModels;
+		FilePaths_Source.Append(EluImportFilesInfo.FilePaths_EluAnimations.Array());
+		FilePaths_Source.Add(FilePath_EluXml);
+		PrecomputeSourceFileHashes(FilePaths_Source);
+
+		// Fbx files are opened on worker threads before any of them is imported, the ones without a mesh are skipped below.
+		// The import coordinator reads the elu object from the progress file written above if the fbx sdk crashes here.
+		// Animations of human models are imported by hand
+		bool bHumanModel = EluXmlModelType == EEluModelType::Female || EluXmlModelType == EEluModelType::Male;
+		PrefilterObjectFbxFiles(EluImportFilesInfo, !bHumanModel);
+
+		for (const FString& FilePath_Source : FilePaths_Source)
+		{
+			const FEluIndexedFile* IndexedFile = FileIndex.FindFile(FilePath_Source);
+			ImportReport.AddBytesRead(IndexedFile ? IndexedFile->FileSize : 0);
+		}
+
+		TArray<USkeletalMesh*> ImportedSkeletalMeshes;
+
 		if (EluXmlModelType == EEluModelType::MapObject ||
 			EluXmlModelType == EEluModelType::Monster ||
 			EluXmlModelType == EEluModelType::NPC ||
@@ -1618,32 +3064,46 @@ EImportResult UEluProcessor::ImportEluModels(const TArray<FString>& InPaths_EluX
 			EluXmlModelType == EEluModelType::Sky ||
 			EluXmlModelType == EEluModelType::Weapon)
 		{
+			TArray<FEluAnimationTarget> AnimationTargets;
+
 			for (FString& FilePath_EluModel : EluImportFilesInfo.FilePaths_EluModels)
 			{
+				TickTexturePreload(0.01f);
+
 				FString FileName_EluModel = FPaths::GetBaseFilename(FilePath_EluModel);
-				FString EditorDir_ModelPackage = EluImportFilesInfo.DirPath_EluObject.Replace(*DirPath_AllModels, *EditorDir_AllModels);
+				FString EditorDir_ModelPackage = EluImportFilesInfo.DirPath_EluObject.Replace(*DirPath_ModelsRoot, *EditorDir_ModelsRoot);
 
 				// FString DialogMessage_ModelInfo = FString("Current Model : ") + FileName_EluModel + FString("\n");
 
 				if (FileName_EluModel.StartsWith(TEXT("S_")))
 				{
-					// Skip if LOD model number is not -1 or 0
+					// Skip if LOD model number is not -1 or 0. Further LODs are imported along with their LOD0 model
 					if (!(FileName_EluModel.Contains(TEXT("_LOD-1")) || FileName_EluModel.Contains(TEXT("_LOD0"))))
 					{
 						continue;
 					}
 
+					TArray<FString> FilePaths_LODs = EluImportFilesInfo.Map_StaticMeshLODs.FindRef(FilePath_EluModel);
+
 					EImportResult StaticMeshImportResult;
-					UStaticMesh* ImportedStaticMesh = ImportStaticMesh(FilePath_EluModel, EditorDir_ModelPackage, StaticMeshImportResult);
+					UStaticMesh* ImportedStaticMesh = ImportStaticMesh(FilePath_EluModel, FilePaths_LODs, EditorDir_ModelPackage, FilePath_EluXml, StaticMeshImportResult);
 					if (StaticMeshImportResult == EImportResult::Success)
 					{
 						check(ImportedStaticMesh);
 
 						AssetRegistryModule.AssetCreated(ImportedStaticMesh);
 						ImportedStaticMesh->MarkPackageDirty();
+						TrackObjectPackage(ImportedStaticMesh);
+						NumMeshesImported++;
+						FEluImportReport::Get().AddCount(EEluImportCounter::Meshes);
 						LogMessage = FString("Successfully imported static mesh: ") + FileName_EluModel;
 						UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
 					}
+					else if (StaticMeshImportResult == EImportResult::Skipped)
+					{
+						// Neither the fbx nor the elu.xml changed since the last import
+						continue;
+					}
 					else if (StaticMeshImportResult == EImportResult::Cancelled)
 					{
 						return EImportResult::Cancelled;
@@ -1673,7 +3133,7 @@ EImportResult UEluProcessor::ImportEluModels(const TArray<FString>& InPaths_EluX
 						*/
 					}
 
-					EImportResult Result = CreateAndApplyStaticMeshMaterials(ImportedStaticMesh, EluImportFilesInfo.Map_EluMatsInfo);
+					EImportResult Result = CreateAndApplyStaticMeshMaterials(ImportedStaticMesh, SlotResolver, FilePath_EluXml);
 					if (Result == EImportResult::Cancelled)
 					{
 						return Result;
@@ -1682,20 +3142,42 @@ EImportResult UEluProcessor::ImportEluModels(const TArray<FString>& InPaths_EluX
 					{
 						bMaterialImportError = true;
 					}
+					else
+					{
+						RecordSourceFileHashes(ImportedStaticMesh->AssetImportData, FilePath_EluModel, FilePath_EluXml, FilePaths_LODs);
+					}
 				}
 				else if (FileName_EluModel.StartsWith(TEXT("SK_")))
 				{
 					EImportResult SkeletalMeshImportResult;
-					USkeletalMesh* ImportedSkeletalMesh = ImportSkeletalMesh(FilePath_EluModel, EditorDir_ModelPackage, SkeletalMeshImportResult);
+					USkeletalMesh* ImportedSkeletalMesh = ImportSkeletalMesh(FilePath_EluModel, EditorDir_ModelPackage, FilePath_EluXml, SkeletalMeshImportResult);
 					if (SkeletalMeshImportResult == EImportResult::Success)
 					{
 						check(ImportedSkeletalMesh);
 
 						AssetRegistryModule.AssetCreated(ImportedSkeletalMesh);
 						ImportedSkeletalMesh->MarkPackageDirty();
+						TrackObjectPackage(ImportedSkeletalMesh);
+						TrackObjectPackage(ImportedSkeletalMesh->Skeleton);
+						TrackObjectPackage(ImportedSkeletalMesh->PhysicsAsset);
+						ImportedSkeletalMeshes.Add(ImportedSkeletalMesh);
+						NumMeshesImported++;
+						FEluImportReport::Get().AddCount(EEluImportCounter::Meshes);
 						LogMessage = FString("Successfully imported skeletal mesh: ") + FileName_EluModel;
 						UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
 					}
+					else if (SkeletalMeshImportResult == EImportResult::Skipped)
+					{
+						// The skeletal mesh itself is unchanged, but it still counts as the target of the object's animations
+						LogMessage = FString("Skeletal mesh is up to date: ") + FileName_EluModel;
+						UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+						if (ImportedSkeletalMesh && !HasSkeletalMeshLODs(ImportedSkeletalMesh, EluXmlModelType))
+						{
+							TrackObjectPackage(ImportedSkeletalMesh);
+							ImportedSkeletalMeshes.Add(ImportedSkeletalMesh);
+						}
+					}
 					else if (SkeletalMeshImportResult == EImportResult::Cancelled)
 					{
 						return EImportResult::Cancelled;
@@ -1725,38 +3207,17 @@ EImportResult UEluProcessor::ImportEluModels(const TArray<FString>& InPaths_EluX
 						*/
 					}
 
-					//~ Import animations
-					for (FString& FilePath_Animation : EluImportFilesInfo.FilePaths_EluAnimations)
-					{
-						FString FileName_Animation = FPaths::GetBaseFilename(FilePath_Animation);
-						FString AniPackageName = EditorDir_ModelPackage + FString("/") + FString("ani") + FString("/") + FileName_Animation;
-						AniPackageName = PackageTools::SanitizePackageName(AniPackageName);
-
-						LogMessage = FString("Importing animation file: ") + FileName_Animation;
-						UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
-
-						UPackage* AniPackage = nullptr;
-						if (FPackageName::DoesPackageExist(AniPackageName))
-						{
-							FString LogMessage = FString("Animation package for ") + FileName_Animation + FString(" already exists");
-							UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
-							AniPackage = LoadPackage(nullptr, *AniPackageName, LOAD_None);
-							if (AniPackage)
-							{
-								AniPackage->FullyLoad();
-							}
-						}
-						else
-						{
-							AniPackage = CreatePackage(nullptr, *AniPackageName);
-							AniPackage->FullyLoad();
-						}
+					// Animations are imported once per object, after all of its skeletal meshes, each for the skeleton that matches it
+					FString SkeletalMeshName = FileName_EluModel.Replace(TEXT("LOD"), TEXT(""));
+					FString SkeletalMeshObjectPath = PackageTools::SanitizePackageName(EditorDir_ModelPackage + FString("/") + SkeletalMeshName) + FString(".") + SkeletalMeshName;
+					AnimationTargets.Add(FEluAnimationTarget(SkeletalMeshObjectPath, ImportedSkeletalMesh));
 
-						UFbxAnimSequenceImportData* Data = NewObject<UFbxAnimSequenceImportData>();
-						UEditorEngine::ImportFbxAnimation(ImportedSkeletalMesh->Skeleton, AniPackage, Data, *FilePath_Animation, *FileName_Animation, false);
+					if (SkeletalMeshImportResult == EImportResult::Skipped)
+					{
+						continue;
 					}
 
-					EImportResult Result = CreateAndApplySkeletalMeshMaterials(ImportedSkeletalMesh, EluImportFilesInfo.Map_EluMatsInfo);
+					EImportResult Result = CreateAndApplySkeletalMeshMaterials(ImportedSkeletalMesh, SlotResolver, FilePath_EluXml);
 					if (Result == EImportResult::Cancelled)
 					{
 						return Result;
@@ -1765,32 +3226,59 @@ EImportResult UEluProcessor::ImportEluModels(const TArray<FString>& InPaths_EluX
 					{
 						bMaterialImportError = true;
 					}
+					else
+					{
+						RecordSourceFileHashes(ImportedSkeletalMesh->AssetImportData, FilePath_EluModel, FilePath_EluXml);
+					}
 				}
 			}
+
+			if (AnimationTargets.Num() > 0 && EluImportFilesInfo.FilePaths_EluAnimations.Num() > 0)
+			{
+				FString EditorDir_ModelPackage = EluImportFilesInfo.DirPath_EluObject.Replace(*DirPath_ModelsRoot, *EditorDir_ModelsRoot);
+				ImportEluAnimations(EluImportFilesInfo, EditorDir_ModelPackage, AnimationTargets);
+			}
 		}
 		else if (EluXmlModelType == EEluModelType::Female ||
 				EluXmlModelType == EEluModelType::Male)
 		{
 			for (FString& FilePath_EluModel : EluImportFilesInfo.FilePaths_EluModels)
 			{
+				TickTexturePreload(0.01f);
+
 				FString FileName_EluModel = FPaths::GetBaseFilename(FilePath_EluModel);
-				FString EditorDir_ModelPackage = EluImportFilesInfo.DirPath_EluObject.Replace(*DirPath_AllModels, *EditorDir_AllModels);
+				FString EditorDir_ModelPackage = EluImportFilesInfo.DirPath_EluObject.Replace(*DirPath_ModelsRoot, *EditorDir_ModelsRoot);
 
 				// FString DialogMessage_ModelInfo = FString("Current Model : ") + FileName_EluModel + FString("\n");
 
 				if (FileName_EluModel.StartsWith(TEXT("SK_")))
 				{
 					EImportResult SkeletalMeshImportResult;
-					USkeletalMesh* ImportedSkeletalMesh = ImportSkeletalMesh(FilePath_EluModel, EditorDir_ModelPackage, SkeletalMeshImportResult);
+					USkeletalMesh* ImportedSkeletalMesh = ImportSkeletalMesh(FilePath_EluModel, EditorDir_ModelPackage, FilePath_EluXml, SkeletalMeshImportResult);
 					if (SkeletalMeshImportResult == EImportResult::Success)
 					{
 						check(ImportedSkeletalMesh);
 
 						AssetRegistryModule.AssetCreated(ImportedSkeletalMesh);
 						ImportedSkeletalMesh->MarkPackageDirty();
+						TrackObjectPackage(ImportedSkeletalMesh);
+						TrackObjectPackage(ImportedSkeletalMesh->Skeleton);
+						TrackObjectPackage(ImportedSkeletalMesh->PhysicsAsset);
+						ImportedSkeletalMeshes.Add(ImportedSkeletalMesh);
+						NumMeshesImported++;
+						FEluImportReport::Get().AddCount(EEluImportCounter::Meshes);
 						LogMessage = FString("Successfully imported skeletal mesh: ") + FileName_EluModel;
 						UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
 					}
+					else if (SkeletalMeshImportResult == EImportResult::Skipped)
+					{
+						if (ImportedSkeletalMesh && !HasSkeletalMeshLODs(ImportedSkeletalMesh, EluXmlModelType))
+						{
+							TrackObjectPackage(ImportedSkeletalMesh);
+							ImportedSkeletalMeshes.Add(ImportedSkeletalMesh);
+						}
+						continue;
+					}
 					else if (SkeletalMeshImportResult == EImportResult::Cancelled)
 					{
 						return EImportResult::Cancelled;
@@ -1804,7 +3292,7 @@ EImportResult UEluProcessor::ImportEluModels(const TArray<FString>& InPaths_EluX
 						continue;
 					}
 
-					EImportResult Result = CreateAndApplySkeletalMeshMaterials(ImportedSkeletalMesh, EluImportFilesInfo.Map_EluMatsInfo);
+					EImportResult Result = CreateAndApplySkeletalMeshMaterials(ImportedSkeletalMesh, SlotResolver, FilePath_EluXml);
 					if (Result == EImportResult::Cancelled)
 					{
 						return Result;
@@ -1813,12 +3301,19 @@ EImportResult UEluProcessor::ImportEluModels(const TArray<FString>& InPaths_EluX
 					{
 						bMaterialImportError = true;
 					}
+					else
+					{
+						RecordSourceFileHashes(ImportedSkeletalMesh->AssetImportData, FilePath_EluModel, FilePath_EluXml);
+					}
 				}
 				else
 				{
-					DialogMessage = FString("Human model mesh is not a skeletal mesh!");
-					DialogText = FText::FromString(DialogMessage);
-					EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::Ok, DialogText);
+					LogMessage = FString("Human model mesh is not a skeletal mesh!");
+					EEluErrorPolicy ErrorAction = HandleError(EEluErrorKind::HumanMeshNotSkeletal, FilePath_EluXml, FileName_EluModel, FString(), LogMessage, false);
+					if (ErrorAction == EEluErrorPolicy::Abort)
+					{
+						return EImportResult::Cancelled;
+					}
 				}
 			}
 			UE_LOG(LogTemp, Warning, TEXT("Load human model animations manually"));
@@ -1831,21 +3326,111 @@ EImportResult UEluProcessor::ImportEluModels(const TArray<FString>& InPaths_EluX
 		}
 		else
 		{
-			DialogMessage = FilePath_EluXml + FString("\nElu model type is currently not supported. Cancelling import!");
-			DialogText = FText::FromString(DialogMessage);
-			EAppReturnType::Type AppReturnType = FMessageDialog::Open(EAppMsgType::Ok, DialogText);
-			// return EImportResult::Failure;
+			LogMessage = FString("Elu model type is currently not supported: ") + FilePath_EluXml;
+			EEluErrorPolicy ErrorAction = HandleError(EEluErrorKind::UnsupportedModelType, FilePath_EluXml, FString(), FString(), LogMessage, false);
+			if (ErrorAction == EEluErrorPolicy::Abort)
+			{
+				return EImportResult::Cancelled;
+			}
+			Checkpoint.Record(FilePath_EluXml, EEluCheckpointStatus::Skipped, Fingerprints[FilePath_EluXml]);
 			continue;
 		}
 
+		GenerateSkeletalMeshLODs(ImportedSkeletalMeshes, EluXmlModelType);
+
+		// Material instances shared by several meshes of this object are written only once
+		{
+			FEluImportPhaseScope PhaseScope(EEluImportPhase::Save);
+			MISaveQueue.Flush();
+		}
+
+		// Releases the textures of this elu object before its packages may be unloaded
+		PreloadUpcomingTextures(ObjectIndex + 1);
+
+		TArray<TWeakObjectPtr<UPackage>> ObjectPackages = CurrentObjectPackages;
+		FinishObjectPackages();
+
 		if (bMaterialImportError)
 		{
+			// Imported again by a resumed run anyway, so it doesn't have to wait for its packages to be saved
+			Checkpoint.Record(FilePath_EluXml, EEluCheckpointStatus::MaterialError, Fingerprints[FilePath_EluXml]);
+
 			// Do not add file to Outpaths_EluXmlFilesLoaded
 			continue;
 		}
 
+		Checkpoint.RecordWhenSaved(FilePath_EluXml, EEluCheckpointStatus::Loaded, Fingerprints[FilePath_EluXml], ObjectPackages);
 		OutPaths_EluXmlFilesLoaded.Add(FilePath_EluXml);
+		ImportReport.MarkObjectLoaded();
 	}
 
+	ImportReport.EndObject();
+
+	// Picks up elu objects whose packages were saved by hand during the batch
+	Checkpoint.FlushSaved();
+
+	if (bPersistentCaches && !bReadOnlyCaches)
+	{
+		if (MatInfoCache.IsValid())
+		{
+			MatInfoCache->SaveToFile(UEluProcessor::FilePath_MatInfoCache);
+		}
+
+		MIStore.SaveToFile(UEluProcessor::FilePath_MaterialInstanceStore);
+	}
+
+	ReleaseBatchTextures();
+
+	FEluErrorJournal::Get().Flush();
+
 	return EImportResult::Success;
 }
+
+void UEluProcessor::PlanEluModels(const TArray<FString>& InPaths_EluXmlFilesToLoad, FEluImportPlan& OutPlan)
+{
+	RestatEluObjectFiles(InPaths_EluXmlFilesToLoad);
+
+	OutPlan.Build(InPaths_EluXmlFilesToLoad, FileIndex, MIStore, FbxPrefilter, SourceFileHashes, DirPath_ModelsRoot, EditorDir_ModelsRoot);
+}
+
+void UEluProcessor::RestatEluObjectFiles(const TArray<FString>& Paths_EluXml)
+{
+	// Same layout as FEluImportFilesInfo: the elu object directory is the parent of the elu.xml directory
+	TArray<FString> DirPaths_EluObjectFiles;
+	DirPaths_EluObjectFiles.Reserve(Paths_EluXml.Num() * 3);
+	for (const FString& FilePath_EluXml : Paths_EluXml)
+	{
+		FString DirPath_EluObject = FPaths::GetPath(FPaths::GetPath(FilePath_EluXml));
+		DirPaths_EluObjectFiles.Add(FPaths::GetPath(FilePath_EluXml));
+		DirPaths_EluObjectFiles.Add(DirPath_EluObject + FString("/") + UEluProcessor::DirName_EluModels);
+		DirPaths_EluObjectFiles.Add(DirPath_EluObject + FString("/") + UEluProcessor::DirName_EluAnimations);
+	}
+
+	FileIndex.RestatDirectories(DirPaths_EluObjectFiles);
+}
+
+void UEluProcessor::BenchmarkEluXmlParsers(int32 NumFiles, int32 NumIterations)
+{
+	TArray<FString> FilePaths_EluXml;
+	FileIndex.FindFilesRecursively(FilePaths_EluXml, FString(".elu.xml"));
+
+	TMap<FString, int64> FileSizes;
+	for (const FString& FilePath_EluXml : FilePaths_EluXml)
+	{
+		const FEluIndexedFile* IndexedFile = FileIndex.FindFile(FilePath_EluXml);
+		FileSizes.Add(FilePath_EluXml, IndexedFile ? IndexedFile->FileSize : 0);
+	}
+
+	// Largest files first, since that's where the DOM parser hurts the most
+	FilePaths_EluXml.Sort([&FileSizes](const FString& A, const FString& B)
+	{
+		return FileSizes[A] > FileSizes[B];
+	});
+
+	if (FilePaths_EluXml.Num() > NumFiles)
+	{
+		FilePaths_EluXml.SetNum(NumFiles);
+	}
+
+	FEluXmlMaterialParser::RunBenchmark(FilePaths_EluXml, NumIterations);
+}
@@ -4,20 +4,29 @@
 
 #include "CoreMinimal.h"
 #include "AssetData.h"
+#include "Misc/SecureHash.h"
+#include "Engine/StreamableManager.h"
+#include "EluFileIndex.h"
+#include "EluPackageSaveQueue.h"
+#include "EluMaterialInstanceStore.h"
+#include "EluFbxPrefilter.h"
+#include "EluImportCheckpoint.h"
+#include "EluFbxImportPreset.h"
 #include "UObject/NoExportTypes.h"
 #include "EluProcessor.generated.h"
 
 
 struct RAIDERZASSETS_API FEluMatInfo
 {
-	FString Texture_DiffuseMap;
-	FString Texture_SpecularMap;
-	FString Texture_NormalMap;
-	FString Texture_SelfIlluminationMap;
-	FString Texture_OpacityMap;
-	FString Texture_ReflectMap;
-	FString Texture_GlossMap;
-	FString Texture_SSSMask;
+	/** Texture asset names. Interned, so that copies and comparisons don't touch the heap */
+	FName Texture_DiffuseMap;
+	FName Texture_SpecularMap;
+	FName Texture_NormalMap;
+	FName Texture_SelfIlluminationMap;
+	FName Texture_OpacityMap;
+	FName Texture_ReflectMap;
+	FName Texture_GlossMap;
+	FName Texture_SSSMask;
 
 	FVector Vector_Diffuse;
 	FVector Vector_Ambient;
@@ -27,24 +36,35 @@ struct RAIDERZASSETS_API FEluMatInfo
 	float Scalar_Glossiness;
 	float Scalar_SelfIllusionScale;
 
-	bool bMaterialType_TwoSided;
-	bool bMaterialType_HumanBody;
-	bool bMaterialType_HumanFace;
-	bool bOpacityMaskChannel_Alpha;
-	bool bOpacityBlendModel_Translucent;
+	/** EEluMatPermutation bits, computed once the material is parsed */
+	uint32 Permutation;
 
-	bool bAnimatedTexture_AllTextures;
-	bool bAnimatedTexture_Diffuse;
-	bool bAnimatedTexture_Specular;
-	bool bAnimatedTexture_Normal;
-	bool bAnimatedTexture_Glow;
-	bool bAnimatedTexture_Opacity;
+	uint8 bMaterialType_TwoSided : 1;
+	uint8 bMaterialType_HumanBody : 1;
+	uint8 bMaterialType_HumanFace : 1;
+	uint8 bOpacityMaskChannel_Alpha : 1;
+	uint8 bOpacityBlendModel_Translucent : 1;
+
+	uint8 bAnimatedTexture_AllTextures : 1;
+	uint8 bAnimatedTexture_Diffuse : 1;
+	uint8 bAnimatedTexture_Specular : 1;
+	uint8 bAnimatedTexture_Normal : 1;
+	uint8 bAnimatedTexture_Glow : 1;
+	uint8 bAnimatedTexture_Opacity : 1;
 
 	FEluMatInfo();
 
+	uint16 GetPackedFlags() const;
+
+	void SetPackedFlags(uint16 PackedFlags);
+
+	friend FArchive& operator<<(FArchive& Ar, FEluMatInfo& MatInfo);
+
 };
 
 
+class FEluMatInfoCache;
+
 struct RAIDERZASSETS_API FEluImportFilesInfo
 {
 	FString DirPath_EluObject;
@@ -62,7 +82,24 @@ struct RAIDERZASSETS_API FEluImportFilesInfo
 
 	TMap<FString, FEluMatInfo> Map_EluMatsInfo;
 
-	FEluImportFilesInfo(const FString& FilePath_EluXml);
+	/** Further LOD files of each static mesh, in LOD order, by the path of its _LOD0 file. Chains stop at the first missing LOD */
+	TMap<FString, TArray<FString>> Map_StaticMeshLODs;
+
+	FEluImportFilesInfo(const FString& FilePath_EluXml, const FEluFileIndex* FileIndex = nullptr, FEluMatInfoCache* MatInfoCache = nullptr);
+};
+
+
+/** Skeletal mesh of an elu object that its animations may be imported for */
+struct FEluAnimationTarget
+{
+	FString SkeletalMeshObjectPath;
+
+	/** Null until loaded, if the skeletal mesh was up to date */
+	class USkeletalMesh* SkeletalMesh;
+
+	FEluAnimationTarget(const FString& InSkeletalMeshObjectPath, class USkeletalMesh* InSkeletalMesh) : SkeletalMeshObjectPath(InSkeletalMeshObjectPath), SkeletalMesh(InSkeletalMesh)
+	{
+	}
 };
 
 
@@ -87,7 +124,39 @@ enum class EImportResult : uint8
 {
 	Failure,
 	Success,
-	Cancelled
+	Cancelled,
+	Skipped
+};
+
+UENUM(BlueprintType)
+enum class EEluErrorKind : uint8
+{
+	Unknown,
+	MeshCastFailed,
+	MaterialSlotUnresolved,
+	MaterialSlotAmbiguous,
+	MaterialInstanceMissing,
+	ParentMaterialMissing,
+	MaterialParametersFailed,
+	HumanMeshNotSkeletal,
+	UnsupportedModelType,
+	TextureMissing,
+};
+
+DECLARE_DELEGATE_OneParam(FOnEluXmlImportStarted, const FString& /* FilePath_EluXml */);
+
+/** What the import does when an error of some kind occurs */
+UENUM(BlueprintType)
+enum class EEluErrorPolicy : uint8
+{
+	/** Asks the user whether to cancel the import. Treated as Skip when running unattended */
+	Ask,
+	/** Records the error and carries on */
+	Skip,
+	/** Tries the failed step once more, then carries on. Treated as Skip for steps that can't be retried */
+	Retry,
+	/** Records the error and cancels the import */
+	Abort,
 };
 
 /**
@@ -118,11 +187,149 @@ public:
 
 	static const FString FilePath_ErrorFile;
 
-	TMap<FName, FAssetData> AssetDataMap_SimpleMaterials;
+	static const FString FilePath_FileIndex;
+
+	static const FString FilePath_MatInfoCache;
+
+	static const FString FilePath_MaterialInstanceStore;
+
+	static const FString FilePath_FbxPrefilterCache;
+
+	static const FString FilePath_ImportSummary;
+
+	static const FString FilePath_ImportReportFile;
+
+	static const FString FilePath_CheckpointFile;
+
+	static const FString FilePath_ImportPlan;
+
+	static const FString DirPath_ImportShards;
+
+	/** Directory under the project's Saved directory that holds the synthetic benchmark corpus and its reports, unless -CorpusDir is given */
+	static const FString DirName_SyntheticCorpus;
+
+	static const FString EditorDir_SyntheticModels;
+
+	/** Placeholder textures, parent materials and material instances of the synthetic benchmark corpus, kept apart from the real ones */
+	static const FString EditorDir_SyntheticTextures;
+
+	static const FString EditorDir_SyntheticSimpleMaterials;
+
+	static const FString EditorDir_SyntheticHumanSkinMaterials;
+
+	static const FString EditorDir_SyntheticMaterialInstances;
+
+	/** Error journal of this processor. Defaults to FilePath_ErrorFile, import workers each get their own. Must be set before Initialize */
+	FString FilePath_ErrorJournal;
+
+	/** Elu model tree imported by this processor, and the editor directory it is imported into. Default to DirPath_AllModels and EditorDir_AllModels. Must be set before Initialize */
+	FString DirPath_ModelsRoot;
+
+	FString EditorDir_ModelsRoot;
+
+	/** Editor directory new material instances are created in. Defaults to EditorDir_MaterialInstances, import workers each get their own. Must be set before Initialize */
+	FString EditorDir_MIs;
+
+	/** Material instances added to the store by this processor are written here by Uninitialize, so that the import coordinator can merge those of its workers */
+	FString FilePath_ExportedMIStore;
+
+	/** Json report of the phase times of the last batch. Defaults to FilePath_ImportReportFile. The same data is appended to a csv file next to it, with one line per elu object */
+	FString FilePath_ImportReport;
+
+	/** Journal of the elu objects finished by the current batch. Defaults to FilePath_CheckpointFile, import workers each get their own */
+	FString FilePath_Checkpoint;
+
+	/** Passes over the elu objects the checkpoint lists as finished instead of starting it over. Used to pick up a batch that crashed or was cancelled */
+	bool bResume;
+
+	/**
+	 * Used physical memory, in megabytes, above which the model and animation packages of the elu objects imported so far are saved and unloaded
+	 * between two elu objects. 0 keeps them loaded until they are saved by hand, which is what the editor UI wants
+	 */
+	int32 MemoryBudgetMB;
+
+	/** Saves the packages of every elu object as soon as it is imported, so that a crash only loses the elu object being imported. Off in the editor, where they're saved by hand */
+	bool bSaveEachObject;
+
+	/** Loads and saves the caches in data_files. Turned off for throwaway model trees, e.g., the synthetic benchmark corpus, so that they don't replace the caches of the real one */
+	bool bPersistentCaches;
+
+	/** Loads the caches in data_files but never writes them. Import workers run side by side, so only the coordinator may write the shared caches */
+	bool bReadOnlyCaches;
+
+	/** Called right before the import of each elu object starts */
+	FOnEluXmlImportStarted OnEluXmlImportStarted;
+
+	/** Never opens dialogs, neither for errors nor for fbx import options. Must be set before Initialize */
+	bool bUnattended;
+
+	/** Applies FbxImportPresets to the fbx factories before each mesh import. Off leaves the factories at their own defaults, e.g., to measure what the presets save */
+	bool bApplyFbxImportPresets;
+
+	/** Runs GenerateSkeletalMeshLODs on the skeletal meshes of every elu object once they're imported. Needs a skeletal mesh reduction, e.g., Simplygon */
+	bool bGenerateSkeletalLODs;
+
+	/** Fbx import options by model type. Model types without an entry get the defaults of FEluFbxImportPreset */
+	TMap<EEluModelType, FEluFbxImportPreset> FbxImportPresets;
+
+	/** Policy for error kinds that have no entry in ErrorPolicies */
+	EEluErrorPolicy DefaultErrorPolicy;
+
+	TMap<EEluErrorKind, EEluErrorPolicy> ErrorPolicies;
 
-	TMap<FName, FAssetData> AssetDataMap_HumanSkinMaterials;
+	/** Errors handled during the current batch, by kind */
+	TMap<EEluErrorKind, int32> ErrorCounts;
 
-	TMap<FName, FAssetData> AssetDataMap_Textures;
+	/** Textures ValidateBatchMaterials already reported missing. The import doesn't report them again for the elu objects imported anyway */
+	TSet<FName> MissingTexturesReported;
+
+	/** Parent materials ValidateBatchMaterials already reported missing */
+	TSet<FName> MissingParentMatsReported;
+
+	/** Meshes and animations imported during the current batch. Up-to-date assets that were skipped aren't counted */
+	int32 NumMeshesImported;
+
+	int32 NumAnimationsImported;
+
+	FEluFileIndex FileIndex;
+
+	TSharedPtr<FEluMatInfoCache> MatInfoCache;
+
+	/** Material instance packages waiting to be saved. Flushed after every elu object, or every MISaveQueue.FlushInterval packages */
+	FEluPackageSaveQueue MISaveQueue;
+
+	/** Material instances by content hash, so that identical materials share one material instance across all elu objects */
+	FEluMaterialInstanceStore MIStore;
+
+	/** Verdicts of the fbx pre-pass, so that files without a mesh are never handed to the fbx factories */
+	FEluFbxPrefilter FbxPrefilter;
+
+	FEluImportCheckpoint Checkpoint;
+
+	/** Skeleton shared by the skeletal meshes of each elu object, by editor directory. See FEluFbxImportPreset::bReuseSkeleton */
+	TMap<FString, TWeakObjectPtr<class USkeleton>> ObjectSkeletons;
+
+	/** Model and animation packages of the elu object being imported, and of the finished elu objects that are still loaded */
+	TArray<TWeakObjectPtr<UPackage>> CurrentObjectPackages;
+
+	TArray<TWeakObjectPtr<UPackage>> FinishedObjectPackages;
+
+	/** Source file hashes computed during the current batch, so that each source file is hashed at most once */
+	TMap<FString, FMD5Hash> SourceFileHashes;
+
+	FStreamableManager StreamableManager;
+
+	/** Textures of each elu object of the current batch, in import order */
+	TArray<TArray<FSoftObjectPath>> ObjectTexturePaths;
+
+	/** Keep the textures of the elu objects being imported and of the upcoming ones loaded. Released once their elu object is done */
+	TArray<TSharedPtr<FStreamableHandle>> TexturePreloadHandles;
+
+	/** Elu objects of the current batch whose textures were requested so far */
+	int32 NumObjectsTexturesRequested;
+
+	/** Elu objects ahead of the import whose textures are loaded, if MemoryBudgetMB is set. The whole batch is loaded otherwise */
+	static const int32 NumObjectsTexturePreloaded;
 
 	UPROPERTY()
 	class UFbxFactory* SkeletalFbxFactory;
@@ -139,32 +346,164 @@ public:
 
 	void Uninitialize();
 
-	class UStaticMesh* ImportStaticMesh(const FString& FilePath_EluModel, const FString& EditorDir_ModelPackage, EImportResult& Result);
+	/** FilePaths_EluModelLODs are imported as LOD 1 and up of the static mesh, see FEluImportFilesInfo::Map_StaticMeshLODs */
+	class UStaticMesh* ImportStaticMesh(const FString& FilePath_EluModel, const TArray<FString>& FilePaths_EluModelLODs, const FString& EditorDir_ModelPackage, const FString& FilePath_EluXml, EImportResult& Result);
 
-	class USkeletalMesh* ImportSkeletalMesh(const FString& FilePath_EluModel, const FString& EditorDir_ModelPackage, EImportResult& Result);
+	/** Replaces the LODs after LOD0 of StaticMesh with the given LOD files. Stops at the first file that can't be imported. Returns the number of LODs imported */
+	int32 ImportStaticMeshLODs(class UStaticMesh* StaticMesh, const TArray<FString>& FilePaths_EluModelLODs, const FString& FilePath_EluXml);
+
+	class USkeletalMesh* ImportSkeletalMesh(const FString& FilePath_EluModel, const FString& EditorDir_ModelPackage, const FString& FilePath_EluXml, EImportResult& Result);
 	
 	// class USkeletalMesh* ImportSkeletalMesh();
 
+	const FEluFbxImportPreset& GetFbxImportPreset(EEluModelType ModelType) const;
+
+	/** Skeleton for a skeletal mesh of the elu object in EditorDir_ModelPackage: the one of an earlier mesh of this batch, else an imported one, preferably the mesh's own */
+	class USkeleton* FindObjectSkeleton(const FString& EditorDir_ModelPackage, const FString& SkeletalMeshName);
+
+	/** Whether the bone hierarchy the fbx prefilter read from a skinned mesh fits Skeleton, i.e., whether the fbx factory can import the mesh for it */
+	static bool IsSkeletonCompatible(const struct FEluFbxSceneInfo& SceneInfo, const class USkeleton* Skeleton);
+
 	static FString GetTextureNameFromXmlNode(class FXmlNode* XmlNode);
 
-	static FString GetEditorMatName(FEluMatInfo MatInfo);
+	static FString GetEditorMatName(const FEluMatInfo& MatInfo);
 
 	static EEluModelType GetEluModelType(const FString& FilePath_EluXml);
 
+	/** Splits the name of an S_ model file, e.g., S_name_LOD2, into S_name and 2. False for files that aren't static mesh LODs */
+	static bool ParseStaticMeshLODFileName(const FString& FileName_EluModel, FString& OutBaseName, int32& OutLODIndex);
+
 	static void AddError(const FString& ErrorMessage);
 
-	static bool AreMaterialInstanceParametersSame(class UMaterialInstanceConstant* MIConstant, FEluMatInfo MatInfo);
+	static void AddError(EEluErrorKind ErrorKind, const FString& FilePath_EluXml, const FString& MeshName, const FString& MaterialName, const FString& ErrorMessage);
+
+	EEluErrorPolicy GetErrorPolicy(EEluErrorKind ErrorKind) const;
+
+	/**
+	 * Records the error and returns how the import should carry on: Skip, Retry or Abort.
+	 * Retry is only returned if bCanRetry is true. The user is only asked if the policy is Ask and the import isn't unattended.
+	 */
+	EEluErrorPolicy HandleError(EEluErrorKind ErrorKind, const FString& FilePath_EluXml, const FString& MeshName, const FString& MaterialName, const FString& ErrorMessage, bool bCanRetry);
+
+	/** Forces the asset registry to rescan EditorDir. The asset registry snapshot picks up new assets through the registry events */
+	static void RescanEditorDir(const FString& EditorDir);
+
+	static FMD5Hash HashSourceFile(const FString& FilePath_Source);
+
+	const FMD5Hash& GetSourceFileHash(const FString& FilePath_Source);
+
+	/** Checks, using asset registry data only, whether the asset at ObjectPath was imported from the current content of its source files, LOD files included */
+	bool IsImportedAssetUpToDate(const FString& ObjectPath, const FString& FilePath_Source, const FString& FilePath_EluXml, const TArray<FString>& FilePaths_LODs = TArray<FString>());
+
+	/** Records the source file, and the elu.xml whose materials were applied, along with their hashes in the asset import data. LOD files come last */
+	void RecordSourceFileHashes(class UAssetImportData* AssetImportData, const FString& FilePath_Source, const FString& FilePath_EluXml, const TArray<FString>& FilePaths_LODs = TArray<FString>());
+
+	static bool AreMaterialInstanceParametersSame(class UMaterialInstanceConstant* MIConstant, const FEluMatInfo& MatInfo);
+
+	/**
+	 * Material instance to share for MatInfo: the one of the store, else, if EditorDir_MIs isn't EditorDir_MaterialInstances, an existing one named MIConstantName
+	 * anywhere under EditorDir_MaterialInstances with the same parameters. The latter is added to the store
+	 */
+	class UMaterialInstanceConstant* FindSharedMaterialInstance(uint64 MaterialHash, const FString& MIConstantName, const FEluMatInfo& MatInfo);
 
 	static void ParseEluXmlForMaterials(const FString& FilePath_EluXml, TMap<FString, FEluMatInfo>& OutMap_EluMatsInfo);
 
+	/** Original FXmlFile based parser. Kept as a fallback for wide encoded files, and as a reference for benchmarking. */
+	static void ParseEluXmlForMaterialsWithDom(const FString& FilePath_EluXml, TMap<FString, FEluMatInfo>& OutMap_EluMatsInfo);
+
+	/**
+	 * Checks, in one pass over the material tables of the batch, that every parent material and required texture exists, before anything is imported.
+	 * Elu objects that miss any are moved to the end of the batch or rejected, depending on the error policies of ParentMaterialMissing and TextureMissing.
+	 * Collects the textures of the remaining elu objects for PreloadBatchTextures. Returns Cancelled if the batch shouldn't be imported at all
+	 */
+	EImportResult ValidateBatchMaterials(TArray<FString>& InOutPaths_EluXml, TArray<FString>& OutPaths_Rejected, TMap<FString, TArray<FName>>& OutObjectTextureNames);
+
+	/** Collects the textures each elu object of the batch will fill its materials with, and requests those of the first ones, see PreloadUpcomingTextures */
+	void PreloadBatchTextures(const TArray<FString>& Paths_EluXml, const TMap<FString, TArray<FName>>& ObjectTextureNames);
+
+	/**
+	 * Called before the elu object at ObjectIndex is imported. Releases the textures of the elu objects before it, and requests those of the next
+	 * NumObjectsTexturePreloaded elu objects, so that SaveAndUnloadFinishedPackages can actually free them
+	 */
+	void PreloadUpcomingTextures(int32 ObjectIndex);
+
+	/** Lets the pending texture loads progress for up to TimeLimit seconds. Called between fbx imports */
+	void TickTexturePreload(float TimeLimit);
+
+	void ReleaseBatchTextures();
+
+	/** Remembers the package of Object as part of the elu object being imported, so that it can be unloaded once memory runs short */
+	void TrackObjectPackage(UObject* Object);
+
+	/** Moves the packages of the elu object that was just imported to FinishedObjectPackages, and unloads them all if memory is over budget */
+	void FinishObjectPackages();
+
+	bool IsOverMemoryBudget() const;
+
+	/** Saves the dirty packages of finished elu objects, and records them in the checkpoint. Returns the number of packages saved */
+	int32 SaveFinishedPackages();
+
+	/** Saves the dirty packages of finished elu objects, unloads them and collects garbage. Returns the number of packages unloaded */
+	int32 SaveAndUnloadFinishedPackages();
+
 	bool FillMaterialInstanceTextureParameter(class UMaterialInstanceConstant* MIConstant, FName ParamName, FName TextureName);
 
-	bool FillMaterialInstanceParameters(class UMaterialInstanceConstant* MIConstant, const FString& EditorMatName, const FEluMatInfo& MatInfo);
+	/** Fills the parameters the permutation of MatInfo requires. On failure, OutFailedTextureName is the texture that couldn't be set, if any */
+	bool FillMaterialInstanceParameters(class UMaterialInstanceConstant* MIConstant, const FEluMatInfo& MatInfo, FName* OutFailedTextureName = nullptr);
+
+	/** Looks up the parent material in the simple materials, then in the human skin materials */
+	class UMaterial* FindParentMaterial(FName ParentMatName) const;
+
+	/**
+	 * Logs every material permutation seen so far whose parent material doesn't exist, every registered parent material that matches no permutation
+	 * of FEluMatPermutation::GetAllPermutations, and every texture parameter a registered parent material lacks. Returns the number of problems found.
+	 */
+	int32 ValidateParentMaterialPermutations(const TMap<uint32, int32>& PermutationUseCounts) const;
+
+	EImportResult CreateAndApplyStaticMeshMaterials(class UStaticMesh* StaticMesh, const class FEluMatSlotResolver& SlotResolver, const FString& FilePath_EluXml);
+
+	EImportResult CreateAndApplySkeletalMeshMaterials(class USkeletalMesh* SkeletalMesh, const class FEluMatSlotResolver& SlotResolver, const FString& FilePath_EluXml);
+
+	/** Hashes the source files that aren't hashed yet on worker threads, and adds them to SourceFileHashes */
+	void PrecomputeSourceFileHashes(const TArray<FString>& FilePaths_Source);
+
+	/**
+	 * Classifies, on worker threads, the model files of one elu object, and reads the animation stacks and bones of its animation files if bWithAnimations.
+	 * Source file hashes must be computed already. Runs once the import of the elu object has started, so that a crash inside the fbx sdk is attributed to it
+	 */
+	void PrefilterObjectFbxFiles(const FEluImportFilesInfo& EluImportFilesInfo, bool bWithAnimations);
 
-	EImportResult CreateAndApplyStaticMeshMaterials(class UStaticMesh* StaticMesh, TMap<FString, FEluMatInfo> Map_EluMatsInfo);
+	/**
+	 * Replaces the LODs after LOD0 of the given skeletal meshes with the SkeletalLODs chain of the model type's preset, and records their triangle
+	 * and bone counts in the import report. Bones to remove are picked on worker threads, the reductions themselves modify the meshes and run one after another
+	 */
+	void GenerateSkeletalMeshLODs(const TArray<class USkeletalMesh*>& SkeletalMeshes, EEluModelType ModelType);
 
-	EImportResult CreateAndApplySkeletalMeshMaterials(class USkeletalMesh* SkeletalMesh, TMap<FString, FEluMatInfo> Map_EluMatsInfo);
+	/** Whether the LOD chain of the skeletal mesh is the one GenerateSkeletalMeshLODs would generate for the preset of the model type */
+	bool HasSkeletalMeshLODs(const class USkeletalMesh* SkeletalMesh, EEluModelType ModelType) const;
+
+	/** Bones to remove for each LOD of LODSettings: bones close enough to the tips of the hierarchy, except the root and the bones KeptBoneNames hang from */
+	static void FindLeafBonesToRemove(const struct FReferenceSkeleton& RefSkeleton, const TArray<FName>& KeptBoneNames, const TArray<FEluSkeletalLODSettings>& LODSettings,
+									  TArray<TArray<FName>>& OutBoneNamesToRemove);
+
+	/**
+	 * Imports each out of date animation of an elu object once, for the skeleton of the skeletal meshes that matches its bones best, see FindAnimationSkeleton.
+	 * Skeletal meshes of AnimationTargets that weren't imported by this batch are loaded once an animation actually needs to be imported
+	 */
+	void ImportEluAnimations(const FEluImportFilesInfo& EluImportFilesInfo, const FString& EditorDir_ModelPackage, TArray<FEluAnimationTarget>& AnimationTargets);
+
+	/** The skeleton with the root bone of the animation file and most of its bones, according to the fbx prefilter. The first skeleton if the file wasn't read */
+	class USkeleton* FindAnimationSkeleton(const FString& FilePath_Animation, const TArray<class USkeleton*>& Skeletons);
 
 	EImportResult ImportEluModels(const TArray<FString>& InPaths_EluXmlFilesToLoad, TArray<FString>& OutPaths_EluXmlFilesLoaded);
+
+	/** Dry run of ImportEluModels, see FEluImportPlan. Must be called after Initialize. Creates no package or object */
+	void PlanEluModels(const TArray<FString>& InPaths_EluXmlFilesToLoad, class FEluImportPlan& OutPlan);
+
+	/** Re-stats the indexed files of the given elu objects, see FEluFileIndex::RestatDirectories */
+	void RestatEluObjectFiles(const TArray<FString>& Paths_EluXml);
+
+	/** Compares the streaming and DOM elu xml parsers on the NumFiles largest elu.xml files of the indexed model tree. */
+	void BenchmarkEluXmlParsers(int32 NumFiles, int32 NumIterations);
 	
 };
@@ -0,0 +1,549 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluSyntheticCorpus.h"
+#include "EluProcessor.h"
+#include "EluMaterialPermutation.h"
+#include "EluAssetRegistrySnapshot.h"
+#include "EluPackageSaveQueue.h"
+
+#include "FbxImporter.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "AssetRegistryModule.h"
+#include "Engine/Texture2D.h"
+#include "Materials/Material.h"
+#include "Factories/MaterialFactoryNew.h"
+
+
+namespace
+{
+	struct FEluSyntheticLayer
+	{
+		const TCHAR* Tag;
+		const TCHAR* Suffix;
+	};
+
+	//~ Texture layers in the order they are added to a material
+	const FEluSyntheticLayer SyntheticLayers[] =
+	{
+		{ TEXT("DIFFUSEMAP"),			TEXT("d") },
+		{ TEXT("SPECULARMAP"),			TEXT("s") },
+		{ TEXT("NORMALMAP"),			TEXT("n") },
+		{ TEXT("SELFILLUMINATIONMAP"),	TEXT("g") },
+		{ TEXT("OPACITYMAP"),			TEXT("o") },
+	};
+
+	const int32 NumSyntheticLayers = ARRAY_COUNT(SyntheticLayers);
+
+	/** Size of a grid cell of the synthetic meshes, in fbx units */
+	const double SyntheticMeshSize = 100.0;
+
+	const char* SyntheticBoneNames[] = { "Bip01", "Bip01 Spine" };
+
+	/** Builds the two bone skeleton that both the skinned meshes and the animations of an object are made for */
+	void CreateSyntheticSkeleton(FbxScene* Scene, TArray<FbxNode*>& OutBoneNodes)
+	{
+		FbxNode* ParentNode = Scene->GetRootNode();
+		for (int32 BoneIndex = 0; BoneIndex < ARRAY_COUNT(SyntheticBoneNames); BoneIndex++)
+		{
+			FbxSkeleton* Skeleton = FbxSkeleton::Create(Scene, SyntheticBoneNames[BoneIndex]);
+			Skeleton->SetSkeletonType(BoneIndex == 0 ? FbxSkeleton::eRoot : FbxSkeleton::eLimbNode);
+
+			FbxNode* BoneNode = FbxNode::Create(Scene, SyntheticBoneNames[BoneIndex]);
+			BoneNode->SetNodeAttribute(Skeleton);
+			BoneNode->LclTranslation.Set(FbxDouble3(0.0, 0.0, BoneIndex == 0 ? 0.0 : SyntheticMeshSize * 0.5));
+			ParentNode->AddChild(BoneNode);
+
+			OutBoneNodes.Add(BoneNode);
+			ParentNode = BoneNode;
+		}
+	}
+
+	bool ExportSyntheticScene(FbxManager* SdkManager, FbxScene* Scene, const FString& FilePath_Fbx)
+	{
+		IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath_Fbx), true);
+
+		FbxExporter* Exporter = FbxExporter::Create(SdkManager, "");
+		bool bResult = Exporter->Initialize(TCHAR_TO_UTF8(*FilePath_Fbx), -1, SdkManager->GetIOSettings()) && Exporter->Export(Scene);
+		Exporter->Destroy();
+
+		return bResult;
+	}
+}
+
+
+const FString FEluSyntheticCorpus::FileName_Stamp = FString("synthetic_corpus.txt");
+
+
+FEluSyntheticCorpusSettings::FEluSyntheticCorpusSettings()
+{
+	Seed = 1;
+	NumObjects = 20;
+	NumMeshesPerObject = 2;
+	NumMaterialsPerObject = 4;
+	NumTextureLayers = 3;
+	NumTexturesPerLayer = 16;
+	NumLODs = 3;
+	NumAnimationsPerObject = 3;
+	MeshResolution = 16;
+}
+
+FString FEluSyntheticCorpusSettings::ToString() const
+{
+	return FString::Printf(TEXT("Seed=%d Objects=%d Meshes=%d Materials=%d Layers=%d Textures=%d LODs=%d Animations=%d Resolution=%d"),
+		Seed, NumObjects, NumMeshesPerObject, NumMaterialsPerObject, NumTextureLayers, NumTexturesPerLayer, NumLODs, NumAnimationsPerObject, MeshResolution);
+}
+
+FEluSyntheticCorpus::FEluSyntheticCorpus(const FEluSyntheticCorpusSettings& InSettings) : Settings(InSettings)
+{
+	Settings.NumObjects = FMath::Max(Settings.NumObjects, 1);
+	Settings.NumMeshesPerObject = FMath::Max(Settings.NumMeshesPerObject, 1);
+	Settings.NumMaterialsPerObject = FMath::Max(Settings.NumMaterialsPerObject, 1);
+	Settings.NumTextureLayers = FMath::Clamp(Settings.NumTextureLayers, 1, NumSyntheticLayers);
+	Settings.NumTexturesPerLayer = FMath::Max(Settings.NumTexturesPerLayer, 1);
+	Settings.NumLODs = FMath::Max(Settings.NumLODs, 1);
+	Settings.NumAnimationsPerObject = FMath::Max(Settings.NumAnimationsPerObject, 0);
+	Settings.MeshResolution = FMath::Max(Settings.MeshResolution, 1);
+
+	NumMeshFiles = 0;
+	NumAnimationFiles = 0;
+}
+
+bool FEluSyntheticCorpus::Generate(const FString& DirPath_ModelsRoot, TArray<FString>& OutPaths_EluXml)
+{
+	FString LogMessage;
+
+	RandomStream.Initialize(Settings.Seed);
+	NumMeshFiles = 0;
+	NumAnimationFiles = 0;
+
+	FString FilePath_Stamp = FPaths::GetPath(DirPath_ModelsRoot) + FString("/") + FEluSyntheticCorpus::FileName_Stamp;
+	FString Stamp;
+	bool bKeepExistingCorpus = FFileHelper::LoadFileToString(Stamp, *FilePath_Stamp) && Stamp == Settings.ToString();
+
+	if (!bKeepExistingCorpus)
+	{
+		LogMessage = FString("Generating synthetic elu corpus (") + Settings.ToString() + FString(") in: ") + DirPath_ModelsRoot;
+		UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+		// Leftovers of a corpus with other settings would end up in the import as well
+		IFileManager::Get().DeleteDirectory(*DirPath_ModelsRoot, false, true);
+		IFileManager::Get().Delete(*FilePath_Stamp, false, true, true);
+	}
+
+	for (int32 ObjectIndex = 0; ObjectIndex < Settings.NumObjects; ObjectIndex++)
+	{
+		bool bSkinned = (ObjectIndex % 2) == 1;
+		FString ObjectName = FString::Printf(TEXT("EluSynth_%04d"), ObjectIndex);
+		FString DirPath_EluObject = DirPath_ModelsRoot + (bSkinned ? FString("/Monster/") : FString("/MapObject/")) + ObjectName;
+
+		if (bKeepExistingCorpus)
+		{
+			OutPaths_EluXml.Add(DirPath_EluObject + FString("/elu_xml/") + ObjectName + FString(".elu.xml"));
+			continue;
+		}
+
+		if (!GenerateObject(DirPath_EluObject, ObjectName, bSkinned, OutPaths_EluXml))
+		{
+			LogMessage = FString("Failed to generate synthetic elu object: ") + DirPath_EluObject;
+			UE_LOG(LogTemp, Error, TEXT("%s"), *LogMessage);
+			return false;
+		}
+	}
+
+	if (bKeepExistingCorpus)
+	{
+		LogMessage = FString("Keeping synthetic elu corpus generated with the same settings: ") + DirPath_ModelsRoot;
+		UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+		return true;
+	}
+
+	return FFileHelper::SaveStringToFile(Settings.ToString(), *FilePath_Stamp);
+}
+
+bool FEluSyntheticCorpus::GenerateObject(const FString& DirPath_EluObject, const FString& ObjectName, bool bSkinned, TArray<FString>& OutPaths_EluXml)
+{
+	TArray<FString> MatNames;
+	for (int32 MatIndex = 0; MatIndex < Settings.NumMaterialsPerObject; MatIndex++)
+	{
+		MatNames.Add(FString::Printf(TEXT("%s_mat_%02d"), *ObjectName, MatIndex));
+	}
+
+	FString FilePath_EluXml = DirPath_EluObject + FString("/elu_xml/") + ObjectName + FString(".elu.xml");
+	if (!FFileHelper::SaveStringToFile(BuildEluXml(MatNames), *FilePath_EluXml))
+	{
+		return false;
+	}
+	OutPaths_EluXml.Add(FilePath_EluXml);
+
+	FString DirPath_EluModels = DirPath_EluObject + FString("/") + UEluProcessor::DirName_EluModels;
+	for (int32 MeshIndex = 0; MeshIndex < Settings.NumMeshesPerObject; MeshIndex++)
+	{
+		if (bSkinned)
+		{
+			FString MeshName = FString::Printf(TEXT("SK_%s_%02d"), *ObjectName, MeshIndex);
+			if (!FEluSyntheticCorpus::WriteMeshFbx(DirPath_EluModels + FString("/") + MeshName + FString(".fbx"), MeshName, MatNames, Settings.MeshResolution, true))
+			{
+				return false;
+			}
+			NumMeshFiles++;
+			continue;
+		}
+
+		// Every LOD still has to reference every material, so the grid can't get coarser than the material count allows
+		int32 MinResolution = FMath::CeilToInt(FMath::Sqrt((float)MatNames.Num()));
+		for (int32 LODIndex = 0; LODIndex < Settings.NumLODs; LODIndex++)
+		{
+			int32 Resolution = FMath::Max(Settings.MeshResolution >> LODIndex, MinResolution);
+			FString MeshName = FString::Printf(TEXT("S_%s_%02d_LOD%d"), *ObjectName, MeshIndex, LODIndex);
+			if (!FEluSyntheticCorpus::WriteMeshFbx(DirPath_EluModels + FString("/") + MeshName + FString(".fbx"), MeshName, MatNames, Resolution, false))
+			{
+				return false;
+			}
+			NumMeshFiles++;
+		}
+	}
+
+	if (bSkinned)
+	{
+		FString DirPath_EluAnimations = DirPath_EluObject + FString("/") + UEluProcessor::DirName_EluAnimations;
+		for (int32 AnimationIndex = 0; AnimationIndex < Settings.NumAnimationsPerObject; AnimationIndex++)
+		{
+			FString AnimationName = FString::Printf(TEXT("%s_anim_%02d"), *ObjectName, AnimationIndex);
+			int32 NumKeys = RandomStream.RandRange(10, 60);
+			if (!FEluSyntheticCorpus::WriteAnimationFbx(DirPath_EluAnimations + FString("/") + AnimationName + FString(".fbx"), NumKeys))
+			{
+				return false;
+			}
+			NumAnimationFiles++;
+		}
+	}
+
+	return true;
+}
+
+FString FEluSyntheticCorpus::BuildEluXml(const TArray<FString>& MatNames)
+{
+	FString EluXml = FString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<ROOT>\n\t<MATERIALLIST>\n");
+
+	for (const FString& MatName : MatNames)
+	{
+		EluXml += FString("\t\t<MATERIAL name=\"") + MatName + FString("\">\n");
+		EluXml += FString::Printf(TEXT("\t\t\t<AMBIENT>%d %d %d</AMBIENT>\n"), RandomStream.RandRange(0, 255), RandomStream.RandRange(0, 255), RandomStream.RandRange(0, 255));
+		EluXml += FString::Printf(TEXT("\t\t\t<DIFFUSE>%d %d %d</DIFFUSE>\n"), RandomStream.RandRange(0, 255), RandomStream.RandRange(0, 255), RandomStream.RandRange(0, 255));
+		EluXml += FString::Printf(TEXT("\t\t\t<SPECULAR>%d %d %d</SPECULAR>\n"), RandomStream.RandRange(0, 255), RandomStream.RandRange(0, 255), RandomStream.RandRange(0, 255));
+
+		// Layers are always taken in the same order, so that the number of layers alone decides the parent material
+		int32 NumLayers = RandomStream.RandRange(1, Settings.NumTextureLayers);
+		if (NumLayers > 3)
+		{
+			EluXml += FString::Printf(TEXT("\t\t\t<SELFILLUSIONSCALE>%.2f</SELFILLUSIONSCALE>\n"), RandomStream.FRandRange(0.5f, 2.f));
+		}
+
+		EluXml += FString("\t\t\t<TEXTURELIST>\n");
+		for (int32 LayerIndex = 0; LayerIndex < NumLayers; LayerIndex++)
+		{
+			const FEluSyntheticLayer& Layer = SyntheticLayers[LayerIndex];
+			int32 TextureIndex = RandomStream.RandRange(0, Settings.NumTexturesPerLayer - 1);
+			EluXml += FString::Printf(TEXT("\t\t\t\t<TEXTURELAYER>\n\t\t\t\t\t<%s>elusynth_%s_%03d.dds</%s>\n\t\t\t\t</TEXTURELAYER>\n"),
+				Layer.Tag, Layer.Suffix, TextureIndex, Layer.Tag);
+		}
+		EluXml += FString("\t\t\t</TEXTURELIST>\n");
+
+		EluXml += FString("\t\t</MATERIAL>\n");
+	}
+
+	EluXml += FString("\t</MATERIALLIST>\n</ROOT>\n");
+	return EluXml;
+}
+
+bool FEluSyntheticCorpus::WriteMeshFbx(const FString& FilePath_Fbx, const FString& MeshName, const TArray<FString>& MatNames, int32 Resolution, bool bSkinned)
+{
+	FbxManager* SdkManager = FbxManager::Create();
+	if (!SdkManager)
+	{
+		return false;
+	}
+
+	FbxIOSettings* IOSettings = FbxIOSettings::Create(SdkManager, IOSROOT);
+	SdkManager->SetIOSettings(IOSettings);
+
+	FbxScene* Scene = FbxScene::Create(SdkManager, "");
+
+	FbxNode* MeshNode = FbxNode::Create(Scene, TCHAR_TO_UTF8(*MeshName));
+	FbxMesh* Mesh = FbxMesh::Create(Scene, TCHAR_TO_UTF8(*MeshName));
+	MeshNode->SetNodeAttribute(Mesh);
+	Scene->GetRootNode()->AddChild(MeshNode);
+
+	for (const FString& MatName : MatNames)
+	{
+		// Material slots are matched against the elu.xml materials by name
+		MeshNode->AddMaterial(FbxSurfaceLambert::Create(Scene, TCHAR_TO_UTF8(*MatName)));
+	}
+
+	// A vertical grid, so that the upper half can be skinned to the second bone
+	int32 NumSideVertices = Resolution + 1;
+	double CellSize = SyntheticMeshSize / Resolution;
+
+	Mesh->InitControlPoints(NumSideVertices * NumSideVertices);
+	FbxVector4* ControlPoints = Mesh->GetControlPoints();
+
+	FbxGeometryElementUV* UVElement = Mesh->CreateElementUV("UVChannel_1");
+	UVElement->SetMappingMode(FbxGeometryElement::eByControlPoint);
+	UVElement->SetReferenceMode(FbxGeometryElement::eDirect);
+
+	for (int32 Row = 0; Row < NumSideVertices; Row++)
+	{
+		for (int32 Column = 0; Column < NumSideVertices; Column++)
+		{
+			ControlPoints[Row * NumSideVertices + Column] = FbxVector4(Column * CellSize, 0.0, Row * CellSize);
+			UVElement->GetDirectArray().Add(FbxVector2((double)Column / Resolution, (double)Row / Resolution));
+		}
+	}
+
+	FbxGeometryElementMaterial* MaterialElement = Mesh->CreateElementMaterial();
+	MaterialElement->SetMappingMode(FbxGeometryElement::eByPolygon);
+	MaterialElement->SetReferenceMode(FbxGeometryElement::eIndexToDirect);
+
+	for (int32 Row = 0; Row < Resolution; Row++)
+	{
+		for (int32 Column = 0; Column < Resolution; Column++)
+		{
+			int32 QuadIndex = Row * Resolution + Column;
+			int32 BaseIndex = Row * NumSideVertices + Column;
+
+			Mesh->BeginPolygon(QuadIndex % MatNames.Num());
+			Mesh->AddPolygon(BaseIndex);
+			Mesh->AddPolygon(BaseIndex + 1);
+			Mesh->AddPolygon(BaseIndex + NumSideVertices + 1);
+			Mesh->AddPolygon(BaseIndex + NumSideVertices);
+			Mesh->EndPolygon();
+		}
+	}
+
+	if (bSkinned)
+	{
+		TArray<FbxNode*> BoneNodes;
+		CreateSyntheticSkeleton(Scene, BoneNodes);
+
+		FbxAMatrix MeshTransform = MeshNode->EvaluateGlobalTransform();
+
+		FbxPose* BindPose = FbxPose::Create(Scene, "BindPose");
+		BindPose->SetIsBindPose(true);
+		BindPose->Add(MeshNode, FbxMatrix(MeshTransform));
+
+		FbxSkin* Skin = FbxSkin::Create(Scene, "");
+		for (int32 BoneIndex = 0; BoneIndex < BoneNodes.Num(); BoneIndex++)
+		{
+			FbxNode* BoneNode = BoneNodes[BoneIndex];
+
+			FbxCluster* Cluster = FbxCluster::Create(Scene, "");
+			Cluster->SetLink(BoneNode);
+			Cluster->SetLinkMode(FbxCluster::eNormalize);
+			Cluster->SetTransformMatrix(MeshTransform);
+			Cluster->SetTransformLinkMatrix(BoneNode->EvaluateGlobalTransform());
+
+			for (int32 Row = 0; Row < NumSideVertices; Row++)
+			{
+				int32 RowBoneIndex = (Row * 2 < NumSideVertices) ? 0 : 1;
+				if (RowBoneIndex != BoneIndex)
+				{
+					continue;
+				}
+
+				for (int32 Column = 0; Column < NumSideVertices; Column++)
+				{
+					Cluster->AddControlPointIndex(Row * NumSideVertices + Column, 1.0);
+				}
+			}
+
+			Skin->AddCluster(Cluster);
+			BindPose->Add(BoneNode, FbxMatrix(BoneNode->EvaluateGlobalTransform()));
+		}
+
+		Mesh->AddDeformer(Skin);
+		Scene->AddPose(BindPose);
+	}
+
+	bool bResult = ExportSyntheticScene(SdkManager, Scene, FilePath_Fbx);
+	SdkManager->Destroy();
+
+	return bResult;
+}
+
+bool FEluSyntheticCorpus::WriteAnimationFbx(const FString& FilePath_Fbx, int32 NumKeys)
+{
+	FbxManager* SdkManager = FbxManager::Create();
+	if (!SdkManager)
+	{
+		return false;
+	}
+
+	FbxIOSettings* IOSettings = FbxIOSettings::Create(SdkManager, IOSROOT);
+	SdkManager->SetIOSettings(IOSettings);
+
+	FbxScene* Scene = FbxScene::Create(SdkManager, "");
+	Scene->GetGlobalSettings().SetTimeMode(FbxTime::eFrames30);
+
+	TArray<FbxNode*> BoneNodes;
+	CreateSyntheticSkeleton(Scene, BoneNodes);
+
+	FString AnimationName = FPaths::GetBaseFilename(FilePath_Fbx);
+	FbxAnimStack* AnimStack = FbxAnimStack::Create(Scene, TCHAR_TO_UTF8(*AnimationName));
+	FbxAnimLayer* AnimLayer = FbxAnimLayer::Create(Scene, "Base Layer");
+	AnimStack->AddMember(AnimLayer);
+
+	// The second bone swings back and forth, one key per frame
+	FbxAnimCurve* Curve = BoneNodes.Last()->LclRotation.GetCurve(AnimLayer, FBXSDK_CURVENODE_COMPONENT_Z, true);
+	Curve->KeyModifyBegin();
+	for (int32 KeyIndex = 0; KeyIndex < NumKeys; KeyIndex++)
+	{
+		FbxTime KeyTime;
+		KeyTime.SetFrame(KeyIndex, FbxTime::eFrames30);
+
+		int32 CurveKeyIndex = Curve->KeyAdd(KeyTime);
+		Curve->KeySetValue(CurveKeyIndex, 45.f * FMath::Sin(KeyIndex * 2.f * PI / NumKeys));
+		Curve->KeySetInterpolation(CurveKeyIndex, FbxAnimCurveDef::eInterpolationLinear);
+	}
+	Curve->KeyModifyEnd();
+
+	FbxTime StopTime;
+	StopTime.SetFrame(NumKeys - 1, FbxTime::eFrames30);
+	AnimStack->SetLocalTimeSpan(FbxTimeSpan(FBXSDK_TIME_ZERO, StopTime));
+
+	bool bResult = ExportSyntheticScene(SdkManager, Scene, FilePath_Fbx);
+	SdkManager->Destroy();
+
+	return bResult;
+}
+
+int32 FEluSyntheticCorpus::CreatePlaceholderAssets(const TArray<FString>& Paths_EluXml)
+{
+	FString LogMessage;
+
+	// Commandlets start with an empty asset registry, the snapshot has to see the assets that exist already
+	UEluProcessor::RescanEditorDir(UEluProcessor::EditorDir_SyntheticTextures);
+	UEluProcessor::RescanEditorDir(UEluProcessor::EditorDir_SyntheticSimpleMaterials);
+	UEluProcessor::RescanEditorDir(UEluProcessor::EditorDir_SyntheticHumanSkinMaterials);
+
+	FEluAssetRegistrySnapshot& Snapshot = FEluAssetRegistrySnapshot::Get();
+	Snapshot.Build();
+
+	TSet<FName> TextureNames;
+	TSet<uint32> Permutations;
+	for (const FString& FilePath_EluXml : Paths_EluXml)
+	{
+		TMap<FString, FEluMatInfo> Map_EluMatsInfo;
+		UEluProcessor::ParseEluXmlForMaterials(FilePath_EluXml, Map_EluMatsInfo);
+
+		for (const TPair<FString, FEluMatInfo>& MatInfoPair : Map_EluMatsInfo)
+		{
+			const FEluMatInfo& MatInfo = MatInfoPair.Value;
+			Permutations.Add(MatInfo.Permutation);
+
+			for (const FEluMatParameterDesc& ParameterDesc : FEluMatPermutation::GetTextureParameters())
+			{
+				FName TextureName = MatInfo.*ParameterDesc.Texture;
+				if (!TextureName.IsNone())
+				{
+					TextureNames.Add(TextureName);
+				}
+			}
+		}
+	}
+
+	FEluPackageSaveQueue SaveQueue;
+	int32 NumCreated = 0;
+
+	for (FName TextureName : TextureNames)
+	{
+		if (Snapshot.FindTexture(TextureName))
+		{
+			continue;
+		}
+
+		// The color only has to tell textures apart in the editor, the name is enough to keep it stable
+		FRandomStream ColorStream(GetTypeHash(TextureName.ToString()));
+		FColor Color = FLinearColor::MakeFromHSV8((uint8)ColorStream.RandRange(0, 255), 160, 200).ToFColor(true);
+
+		bool bNormalMap = TextureName.ToString().StartsWith(TEXT("T_elusynth_n_"));
+		if (FEluSyntheticCorpus::CreatePlaceholderTexture(TextureName, Color, bNormalMap, SaveQueue))
+		{
+			NumCreated++;
+		}
+	}
+
+	for (uint32 Permutation : Permutations)
+	{
+		FName ParentMatName = FEluMatPermutation::GetParentMaterialName(Permutation);
+		if (Snapshot.FindParentMaterial(ParentMatName))
+		{
+			continue;
+		}
+
+		if (FEluSyntheticCorpus::CreatePlaceholderParentMaterial(ParentMatName, FEluMatPermutation::IsHumanPermutation(Permutation), SaveQueue))
+		{
+			NumCreated++;
+		}
+	}
+
+	SaveQueue.Flush();
+
+	LogMessage = FString::Printf(TEXT("Created %d placeholder assets for %d textures and %d parent materials of the synthetic corpus"), NumCreated, TextureNames.Num(), Permutations.Num());
+	UE_LOG(LogTemp, Display, TEXT("%s"), *LogMessage);
+
+	return NumCreated;
+}
+
+UTexture2D* FEluSyntheticCorpus::CreatePlaceholderTexture(FName TextureName, const FColor& Color, bool bNormalMap, FEluPackageSaveQueue& SaveQueue)
+{
+	const int32 TextureSize = 8;
+
+	FString PackageName = UEluProcessor::EditorDir_SyntheticTextures + FString("/") + TextureName.ToString();
+	UPackage* Package = CreatePackage(nullptr, *PackageName);
+	Package->FullyLoad();
+
+	UTexture2D* Texture = NewObject<UTexture2D>(Package, TextureName, RF_Public | RF_Standalone);
+
+	TArray<FColor> Pixels;
+	Pixels.Init(bNormalMap ? FColor(128, 128, 255) : Color, TextureSize * TextureSize);
+	Texture->Source.Init(TextureSize, TextureSize, 1, 1, TSF_BGRA8, (const uint8*)Pixels.GetData());
+
+	if (bNormalMap)
+	{
+		Texture->CompressionSettings = TC_Normalmap;
+		Texture->SRGB = false;
+		Texture->LODGroup = TEXTUREGROUP_WorldNormalMap;
+	}
+
+	Texture->PostEditChange();
+
+	FAssetRegistryModule::AssetCreated(Texture);
+	Package->MarkPackageDirty();
+	SaveQueue.Enqueue(Package);
+
+	return Texture;
+}
+
+UMaterial* FEluSyntheticCorpus::CreatePlaceholderParentMaterial(FName ParentMatName, bool bHumanSkin, FEluPackageSaveQueue& SaveQueue)
+{
+	FString EditorDir_ParentMaterials = bHumanSkin ? UEluProcessor::EditorDir_SyntheticHumanSkinMaterials : UEluProcessor::EditorDir_SyntheticSimpleMaterials;
+	FString PackageName = EditorDir_ParentMaterials + FString("/") + ParentMatName.ToString();
+	UPackage* Package = CreatePackage(nullptr, *PackageName);
+	Package->FullyLoad();
+
+	// Material instance parameters are filled by name, an empty parent material is enough for them to be set
+	UMaterialFactoryNew* MaterialFactory = NewObject<UMaterialFactoryNew>();
+	UMaterial* Material = Cast<UMaterial>(MaterialFactory->FactoryCreateNew(UMaterial::StaticClass(), Package, ParentMatName, RF_Public | RF_Standalone, nullptr, GWarn));
+	if (!Material)
+	{
+		return nullptr;
+	}
+
+	FAssetRegistryModule::AssetCreated(Material);
+	Package->MarkPackageDirty();
+	SaveQueue.Enqueue(Package);
+
+	return Material;
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+
+struct RAIDERZASSETS_API FEluSyntheticCorpusSettings
+{
+	/** Same seed and settings, same corpus */
+	int32 Seed;
+
+	/** Even objects are static map objects, odd objects are skinned monsters with animations */
+	int32 NumObjects;
+
+	int32 NumMeshesPerObject;
+
+	int32 NumMaterialsPerObject;
+
+	/** Most texture layers of a material, 1 to 5: diffuse, specular, normal, self illumination, opacity. Every material gets at least a diffuse map */
+	int32 NumTextureLayers;
+
+	/** Distinct textures per layer kind. Materials pick from this pool, so smaller pools mean more shared textures */
+	int32 NumTexturesPerLayer;
+
+	/** LODs of every static mesh. Skeletal meshes only have LOD0 */
+	int32 NumLODs;
+
+	int32 NumAnimationsPerObject;
+
+	/** Quads per side of the LOD0 grid of every mesh. Each further LOD halves it */
+	int32 MeshResolution;
+
+	FEluSyntheticCorpusSettings();
+
+	/** Printable form of the settings, also used to tell whether an existing corpus can be kept */
+	FString ToString() const;
+};
+
+
+/**
+ * Generates a deterministic elu model tree for benchmarks: elu.xml files with their materials, S_ meshes with _LODn files,
+ * SK_ meshes, animation fbx files, and placeholder textures and parent materials for everything the elu.xml files refer to.
+ */
+class RAIDERZASSETS_API FEluSyntheticCorpus
+{
+public:
+
+	/** Written next to the model tree, holds the settings the corpus was generated with */
+	static const FString FileName_Stamp;
+
+	FEluSyntheticCorpusSettings Settings;
+
+	int32 NumMeshFiles;
+
+	int32 NumAnimationFiles;
+
+	explicit FEluSyntheticCorpus(const FEluSyntheticCorpusSettings& InSettings);
+
+	/**
+	 * Writes the corpus under DirPath_ModelsRoot, which must end with /Model for the elu model types to be recognized.
+	 * A corpus generated earlier with the same settings is left untouched, so that its file hashes and imported assets stay valid.
+	 */
+	bool Generate(const FString& DirPath_ModelsRoot, TArray<FString>& OutPaths_EluXml);
+
+	/**
+	 * Creates the textures and parent materials used by the given elu.xml files that don't exist yet, under the EditorDir_Synthetic directories of UEluProcessor.
+	 * The asset registry snapshot must be built from those directories. Returns the number of assets created
+	 */
+	int32 CreatePlaceholderAssets(const TArray<FString>& Paths_EluXml);
+
+private:
+
+	FRandomStream RandomStream;
+
+	bool GenerateObject(const FString& DirPath_EluObject, const FString& ObjectName, bool bSkinned, TArray<FString>& OutPaths_EluXml);
+
+	FString BuildEluXml(const TArray<FString>& MatNames);
+
+	static bool WriteMeshFbx(const FString& FilePath_Fbx, const FString& MeshName, const TArray<FString>& MatNames, int32 Resolution, bool bSkinned);
+
+	static bool WriteAnimationFbx(const FString& FilePath_Fbx, int32 NumKeys);
+
+	static class UTexture2D* CreatePlaceholderTexture(FName TextureName, const FColor& Color, bool bNormalMap, class FEluPackageSaveQueue& SaveQueue);
+
+	static class UMaterial* CreatePlaceholderParentMaterial(FName ParentMatName, bool bHumanSkin, class FEluPackageSaveQueue& SaveQueue);
+
+};
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluProcessor.h"
+#include "EluSyntheticCorpus.h"
+#include "EluImportReport.h"
+#include "EluAssetRegistrySnapshot.h"
+
+#include "Misc/Paths.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/PackageName.h"
+#include "HAL/FileManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Imports a small seeded synthetic corpus into a fresh editor directory and checks what comes out of it.
+ * Throughput is measured by UEluBenchmarkCommandlet, this only checks that the import is complete and free of errors
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEluSyntheticImportTest, "RaiderzAssets.Import.SyntheticCorpus", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FEluSyntheticImportTest::RunTest(const FString& Parameters)
+{
+	FEluSyntheticCorpusSettings Settings;
+	Settings.Seed = 17;
+	Settings.NumObjects = 4;
+	Settings.NumMeshesPerObject = 2;
+	Settings.NumMaterialsPerObject = 3;
+	Settings.NumLODs = 2;
+	Settings.NumAnimationsPerObject = 2;
+	Settings.MeshResolution = 8;
+
+	FString DirPath_Corpus = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir()) + UEluProcessor::DirName_SyntheticCorpus;
+	FString DirPath_SyntheticModels = DirPath_Corpus + FString("/Model");
+
+	FEluSyntheticCorpus Corpus(Settings);
+	TArray<FString> Paths_EluXml;
+	if (!TestTrue(TEXT("Synthetic corpus is generated"), Corpus.Generate(DirPath_SyntheticModels, Paths_EluXml)))
+	{
+		return false;
+	}
+
+	// Same synthetic content as the benchmark, so that the real textures and parent materials are neither used nor written
+	FEluAssetRegistrySnapshot& AssetRegistrySnapshot = FEluAssetRegistrySnapshot::Get();
+	AssetRegistrySnapshot.Reset();
+	AssetRegistrySnapshot.EditorDir_Textures = UEluProcessor::EditorDir_SyntheticTextures;
+	AssetRegistrySnapshot.EditorDir_SimpleMaterials = UEluProcessor::EditorDir_SyntheticSimpleMaterials;
+	AssetRegistrySnapshot.EditorDir_HumanSkinMaterials = UEluProcessor::EditorDir_SyntheticHumanSkinMaterials;
+	AssetRegistrySnapshot.EditorDir_MaterialInstances = UEluProcessor::EditorDir_SyntheticMaterialInstances;
+
+	Corpus.CreatePlaceholderAssets(Paths_EluXml);
+
+	// Nothing may be up to date, or the counts below would depend on earlier runs
+	FString EditorDir_Models = UEluProcessor::EditorDir_SyntheticModels + FString("/AutomationTest");
+	IFileManager::Get().DeleteDirectory(*FPackageName::LongPackageNameToFilename(EditorDir_Models + FString("/")), false, true);
+
+	UEluProcessor* EluProcessor = NewObject<UEluProcessor>();
+	EluProcessor->AddToRoot();
+	EluProcessor->bUnattended = true;
+	EluProcessor->DefaultErrorPolicy = EEluErrorPolicy::Skip;
+	EluProcessor->bPersistentCaches = false;
+	EluProcessor->DirPath_ModelsRoot = DirPath_SyntheticModels;
+	EluProcessor->EditorDir_ModelsRoot = EditorDir_Models;
+	EluProcessor->EditorDir_MIs = UEluProcessor::EditorDir_SyntheticMaterialInstances;
+	EluProcessor->FilePath_ErrorJournal = DirPath_Corpus + FString("/test_errors.txt");
+	EluProcessor->FilePath_ImportReport = DirPath_Corpus + FString("/test_import_report.json");
+	EluProcessor->FilePath_Checkpoint = DirPath_Corpus + FString("/test_checkpoint.txt");
+
+	EluProcessor->Initialize();
+
+	TArray<FString> Paths_EluXmlFilesLoaded;
+	EImportResult Result = EluProcessor->ImportEluModels(Paths_EluXml, Paths_EluXmlFilesLoaded);
+	FEluObjectImportRecord Totals = FEluImportReport::Get().GetTotals();
+
+	int32 NumMeshesImported = EluProcessor->NumMeshesImported;
+	int32 NumAnimationsImported = EluProcessor->NumAnimationsImported;
+	int32 NumErrors = 0;
+	for (const TPair<EEluErrorKind, int32>& ErrorCountPair : EluProcessor->ErrorCounts)
+	{
+		NumErrors += ErrorCountPair.Value;
+	}
+
+	EluProcessor->Uninitialize();
+	EluProcessor->RemoveFromRoot();
+
+	// The snapshot outlives this test, the editor goes on with the real content
+	AssetRegistrySnapshot.Reset();
+	AssetRegistrySnapshot.EditorDir_Textures = UEluProcessor::EditorDir_Textures;
+	AssetRegistrySnapshot.EditorDir_SimpleMaterials = UEluProcessor::EditorDir_SimpleMaterials;
+	AssetRegistrySnapshot.EditorDir_HumanSkinMaterials = UEluProcessor::EditorDir_HumanSkinMaterials;
+	AssetRegistrySnapshot.EditorDir_MaterialInstances = UEluProcessor::EditorDir_MaterialInstances;
+
+	// Even objects are static map objects, odd ones skinned monsters with animations. Every mesh uses every material of its object
+	int32 NumSkinnedObjects = Settings.NumObjects / 2;
+	int32 NumMeshes = Settings.NumObjects * Settings.NumMeshesPerObject;
+	int32 NumMaterialSlots = NumMeshes * Settings.NumMaterialsPerObject;
+	int32 NumMaterialInstances = Totals.Counts[(int32)EEluImportCounter::MaterialInstancesCreated] + Totals.Counts[(int32)EEluImportCounter::MaterialInstancesReused];
+
+	TestTrue(TEXT("Import isn't cancelled"), Result != EImportResult::Cancelled);
+	TestEqual(TEXT("Elu objects loaded"), Paths_EluXmlFilesLoaded.Num(), Paths_EluXml.Num());
+	TestEqual(TEXT("Meshes imported"), NumMeshesImported, NumMeshes);
+	TestEqual(TEXT("Material slots"), Totals.Counts[(int32)EEluImportCounter::MaterialSlots], NumMaterialSlots);
+	TestEqual(TEXT("Material instances created or reused"), NumMaterialInstances, NumMaterialSlots);
+	TestEqual(TEXT("Animations imported"), NumAnimationsImported, NumSkinnedObjects * Settings.NumAnimationsPerObject);
+	TestEqual(TEXT("Errors"), NumErrors, 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,1000 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EluXmlMaterialParser.h"
+#include "EluProcessor.h"
+#include "EluMaterialPermutation.h"
+
+#include "ObjectTools.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMemory.h"
+#include "Serialization/MemoryWriter.h"
+
+
+enum class EEluXmlTag : uint8
+{
+	Unknown,
+	MATERIALLIST,
+	MATERIAL,
+	TEXTURELIST,
+	TEXTURELAYER,
+	TEX_ANIMATION,
+	MAPCHANNEL,
+	DIFFUSEMAP,
+	SPECULARMAP,
+	NORMALMAP,
+	SELFILLUMINATIONMAP,
+	OPACITYMAP,
+	REFLECTMAP,
+	GLOSSINESS,
+	FAKE_SSS_MASK,
+	AMBIENT,
+	DIFFUSE,
+	SPECULAR,
+	TWOSIDED,
+	USEOPACITY,
+	SPECULAR_LEVEL,
+	SELFILLUSIONSCALE,
+	FAKE_SSS,
+};
+
+template<int32 N>
+static FORCEINLINE bool IsTagNamed(const ANSICHAR* Name, const ANSICHAR(&Literal)[N])
+{
+	// Tag names are compared case insensitively, same as FXmlNode::FindChildNode()
+	return FCStringAnsi::Strnicmp(Name, Literal, N - 1) == 0;
+}
+
+/** Tag names are dispatched on their length first, so that at most a handful of comparisons are made per tag */
+static EEluXmlTag ClassifyTag(const ANSICHAR* Name, int32 NameLen)
+{
+	switch (NameLen)
+	{
+	case 7:
+		if (IsTagNamed(Name, "AMBIENT")) return EEluXmlTag::AMBIENT;
+		if (IsTagNamed(Name, "DIFFUSE")) return EEluXmlTag::DIFFUSE;
+		break;
+	case 8:
+		if (IsTagNamed(Name, "MATERIAL")) return EEluXmlTag::MATERIAL;
+		if (IsTagNamed(Name, "SPECULAR")) return EEluXmlTag::SPECULAR;
+		if (IsTagNamed(Name, "TWOSIDED")) return EEluXmlTag::TWOSIDED;
+		if (IsTagNamed(Name, "FAKE_SSS")) return EEluXmlTag::FAKE_SSS;
+		break;
+	case 9:
+		if (IsTagNamed(Name, "NORMALMAP")) return EEluXmlTag::NORMALMAP;
+		break;
+	case 10:
+		if (IsTagNamed(Name, "DIFFUSEMAP")) return EEluXmlTag::DIFFUSEMAP;
+		if (IsTagNamed(Name, "OPACITYMAP")) return EEluXmlTag::OPACITYMAP;
+		if (IsTagNamed(Name, "REFLECTMAP")) return EEluXmlTag::REFLECTMAP;
+		if (IsTagNamed(Name, "GLOSSINESS")) return EEluXmlTag::GLOSSINESS;
+		if (IsTagNamed(Name, "MAPCHANNEL")) return EEluXmlTag::MAPCHANNEL;
+		if (IsTagNamed(Name, "USEOPACITY")) return EEluXmlTag::USEOPACITY;
+		break;
+	case 11:
+		if (IsTagNamed(Name, "TEXTURELIST")) return EEluXmlTag::TEXTURELIST;
+		if (IsTagNamed(Name, "SPECULARMAP")) return EEluXmlTag::SPECULARMAP;
+		break;
+	case 12:
+		if (IsTagNamed(Name, "MATERIALLIST")) return EEluXmlTag::MATERIALLIST;
+		if (IsTagNamed(Name, "TEXTURELAYER")) return EEluXmlTag::TEXTURELAYER;
+		break;
+	case 13:
+		if (IsTagNamed(Name, "TEX_ANIMATION")) return EEluXmlTag::TEX_ANIMATION;
+		if (IsTagNamed(Name, "FAKE_SSS_MASK")) return EEluXmlTag::FAKE_SSS_MASK;
+		break;
+	case 14:
+		if (IsTagNamed(Name, "SPECULAR_LEVEL")) return EEluXmlTag::SPECULAR_LEVEL;
+		break;
+	case 17:
+		if (IsTagNamed(Name, "SELFILLUSIONSCALE")) return EEluXmlTag::SELFILLUSIONSCALE;
+		break;
+	case 19:
+		if (IsTagNamed(Name, "SELFILLUMINATIONMAP")) return EEluXmlTag::SELFILLUMINATIONMAP;
+		break;
+	default:
+		break;
+	}
+
+	return EEluXmlTag::Unknown;
+}
+
+static FORCEINLINE bool IsXmlWhitespace(ANSICHAR Char)
+{
+	return Char == ' ' || Char == '\t' || Char == '\r' || Char == '\n';
+}
+
+/** Advances Cursor to just past the first occurrence of Pattern, or to End if there is none */
+template<int32 N>
+static FORCEINLINE void SkipPast(const ANSICHAR*& Cursor, const ANSICHAR* End, const ANSICHAR(&Pattern)[N])
+{
+	const int32 PatternLen = N - 1;
+	while (Cursor + PatternLen <= End)
+	{
+		if (FMemory::Memcmp(Cursor, Pattern, PatternLen) == 0)
+		{
+			Cursor += PatternLen;
+			return;
+		}
+		Cursor++;
+	}
+	Cursor = End;
+}
+
+
+FEluXmlMaterialParser::FEluXmlMaterialParser() : ArenaMark(FMemStack::Get())
+{
+	FileData = nullptr;
+	FileSize = 0;
+	Cursor = nullptr;
+	End = nullptr;
+	bUtf16 = false;
+}
+
+bool FEluXmlMaterialParser::LoadFile(const FString& InFilePath_EluXml)
+{
+	FilePath_EluXml = InFilePath_EluXml;
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath_EluXml, FILEREAD_Silent));
+	if (!Reader)
+	{
+		return false;
+	}
+
+	FileSize = Reader->TotalSize();
+
+	// Allocated from the per-thread memory stack, released by ArenaMark when the parser is destroyed
+	uint8* Buffer = reinterpret_cast<uint8*>(FMemStack::Get().Alloc((int32)FileSize + 1, 16));
+	Reader->Serialize(Buffer, FileSize);
+	Buffer[FileSize] = 0;
+
+	if (!Reader->Close())
+	{
+		return false;
+	}
+
+	FileData = Buffer;
+
+	Cursor = reinterpret_cast<const ANSICHAR*>(FileData);
+	End = Cursor + FileSize;
+
+	if (FileSize >= 2 && ((FileData[0] == 0xFF && FileData[1] == 0xFE) || (FileData[0] == 0xFE && FileData[1] == 0xFF)))
+	{
+		bUtf16 = true;
+	}
+	else if (FileSize >= 3 && FileData[0] == 0xEF && FileData[1] == 0xBB && FileData[2] == 0xBF)
+	{
+		Cursor += 3;
+	}
+
+	return true;
+}
+
+const uint8* FEluXmlMaterialParser::GetFileData() const
+{
+	return FileData;
+}
+
+int64 FEluXmlMaterialParser::GetFileSize() const
+{
+	return FileSize;
+}
+
+bool FEluXmlMaterialParser::Parse(TMap<FString, FEluMatInfo>& OutMap_EluMatsInfo)
+{
+	FString LogMessage;
+
+	if (!FileData)
+	{
+		return false;
+	}
+
+	// Wide encoded files are rare enough that they are simply handed over to the DOM based parser
+	if (bUtf16)
+	{
+		UEluProcessor::ParseEluXmlForMaterialsWithDom(FilePath_EluXml, OutMap_EluMatsInfo);
+		return true;
+	}
+
+	FXmlTag Tag;
+
+	// Find the root node
+	do
+	{
+		if (!ReadNextTag(Tag))
+		{
+			return false;
+		}
+	} while (Tag.bClosing);
+
+	if (Tag.bSelfClosing)
+	{
+		return true;
+	}
+
+	while (ReadNextTag(Tag))
+	{
+		if (Tag.bClosing)
+		{
+			// End of root node
+			return true;
+		}
+
+		if (Tag.bSelfClosing)
+		{
+			continue;
+		}
+
+		bool bResult = ClassifyTag(Tag.Name, Tag.NameLen) == EEluXmlTag::MATERIALLIST ? ParseMaterialList(OutMap_EluMatsInfo) : SkipElement();
+		if (!bResult)
+		{
+			break;
+		}
+	}
+
+	LogMessage = FString("Unexpected end of file while parsing elu xml: ") + FilePath_EluXml;
+	UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+	return false;
+}
+
+bool FEluXmlMaterialParser::ReadNextTag(FXmlTag& OutTag, FXmlSpan* OutText)
+{
+	while (Cursor < End)
+	{
+		const ANSICHAR* TextBegin = Cursor;
+		while (Cursor < End && *Cursor != '<')
+		{
+			Cursor++;
+		}
+
+		if (OutText)
+		{
+			OutText->Begin = TextBegin;
+			OutText->Len = Cursor - TextBegin;
+		}
+
+		if (Cursor + 1 >= End)
+		{
+			Cursor = End;
+			return false;
+		}
+
+		Cursor++;
+
+		// Declarations, comments, CDATA sections and doctypes carry no material data
+		if (*Cursor == '?')
+		{
+			SkipPast(Cursor, End, "?>");
+			continue;
+		}
+		else if (*Cursor == '!')
+		{
+			if (Cursor + 3 <= End && Cursor[1] == '-' && Cursor[2] == '-')
+			{
+				SkipPast(Cursor, End, "-->");
+			}
+			else if (Cursor + 8 <= End && FMemory::Memcmp(Cursor, "![CDATA[", 8) == 0)
+			{
+				SkipPast(Cursor, End, "]]>");
+			}
+			else
+			{
+				SkipPast(Cursor, End, ">");
+			}
+			continue;
+		}
+
+		OutTag.bClosing = false;
+		OutTag.bSelfClosing = false;
+
+		if (*Cursor == '/')
+		{
+			OutTag.bClosing = true;
+			Cursor++;
+		}
+
+		OutTag.Name = Cursor;
+		while (Cursor < End && !IsXmlWhitespace(*Cursor) && *Cursor != '>' && *Cursor != '/')
+		{
+			Cursor++;
+		}
+		OutTag.NameLen = Cursor - OutTag.Name;
+
+		OutTag.Attributes = Cursor;
+		ANSICHAR Quote = 0;
+		while (Cursor < End)
+		{
+			if (Quote)
+			{
+				if (*Cursor == Quote)
+				{
+					Quote = 0;
+				}
+			}
+			else if (*Cursor == '"' || *Cursor == '\'')
+			{
+				Quote = *Cursor;
+			}
+			else if (*Cursor == '>')
+			{
+				break;
+			}
+			Cursor++;
+		}
+
+		if (Cursor >= End)
+		{
+			return false;
+		}
+
+		OutTag.AttributesLen = Cursor - OutTag.Attributes;
+		if (OutTag.AttributesLen > 0 && OutTag.Attributes[OutTag.AttributesLen - 1] == '/')
+		{
+			OutTag.bSelfClosing = true;
+			OutTag.AttributesLen--;
+		}
+
+		// Skip '>'
+		Cursor++;
+		return true;
+	}
+
+	return false;
+}
+
+bool FEluXmlMaterialParser::SkipElement()
+{
+	int32 Depth = 1;
+	FXmlTag Tag;
+
+	while (Depth > 0)
+	{
+		if (!ReadNextTag(Tag))
+		{
+			return false;
+		}
+
+		if (Tag.bClosing)
+		{
+			Depth--;
+		}
+		else if (!Tag.bSelfClosing)
+		{
+			Depth++;
+		}
+	}
+
+	return true;
+}
+
+bool FEluXmlMaterialParser::ReadElementContent(const FXmlTag& OpenTag, FXmlSpan& OutContent)
+{
+	OutContent.Begin = Cursor;
+	OutContent.Len = 0;
+
+	if (OpenTag.bSelfClosing)
+	{
+		return true;
+	}
+
+	FXmlTag Tag;
+	if (!ReadNextTag(Tag, &OutContent))
+	{
+		return false;
+	}
+
+	while (OutContent.Len > 0 && IsXmlWhitespace(OutContent.Begin[0]))
+	{
+		OutContent.Begin++;
+		OutContent.Len--;
+	}
+	while (OutContent.Len > 0 && IsXmlWhitespace(OutContent.Begin[OutContent.Len - 1]))
+	{
+		OutContent.Len--;
+	}
+
+	if (Tag.bClosing)
+	{
+		return true;
+	}
+
+	// Leaf nodes are not expected to contain child nodes, skip them along with the rest of the element
+	if (!Tag.bSelfClosing && !SkipElement())
+	{
+		return false;
+	}
+
+	return SkipElement();
+}
+
+bool FEluXmlMaterialParser::ParseMaterialList(TMap<FString, FEluMatInfo>& OutMap_EluMatsInfo)
+{
+	FXmlTag Tag;
+
+	while (ReadNextTag(Tag))
+	{
+		if (Tag.bClosing)
+		{
+			return true;
+		}
+
+		if (ClassifyTag(Tag.Name, Tag.NameLen) != EEluXmlTag::MATERIAL)
+		{
+			if (!Tag.bSelfClosing && !SkipElement())
+			{
+				return false;
+			}
+			continue;
+		}
+
+		FEluMatInfo MatInfo;
+
+		// Sanitizing mat name is very important, otherwise mat name won't match.
+		FString MatName = ObjectTools::SanitizeObjectName(FEluXmlMaterialParser::SpanToString(FEluXmlMaterialParser::FindAttribute(Tag, "name")));
+
+		if (!Tag.bSelfClosing && !ParseMaterial(MatInfo))
+		{
+			return false;
+		}
+
+		MatInfo.Permutation = FEluMatPermutation::Compute(MatInfo);
+		OutMap_EluMatsInfo.Add(MoveTemp(MatName), MatInfo);
+	}
+
+	return false;
+}
+
+bool FEluXmlMaterialParser::ParseMaterial(FEluMatInfo& MatInfo)
+{
+	FString LogMessage;
+
+	// Only the first node of each kind is used, same as FXmlNode::FindChildNode()
+	bool bFoundTextureList = false;
+	bool bFoundAmbient = false;
+	bool bFoundDiffuse = false;
+	bool bFoundSpecular = false;
+	bool bFoundSpecularLevel = false;
+	bool bFoundSelfIllusionScale = false;
+	bool bFoundGlossiness = false;
+
+	FXmlTag Tag;
+	FXmlSpan Content;
+
+	while (ReadNextTag(Tag))
+	{
+		if (Tag.bClosing)
+		{
+			return true;
+		}
+
+		bool bResult = true;
+		bool bConsumed = false;
+		EEluXmlTag TagType = ClassifyTag(Tag.Name, Tag.NameLen);
+
+		switch (TagType)
+		{
+		case EEluXmlTag::TEXTURELIST:
+			if (!bFoundTextureList)
+			{
+				bFoundTextureList = true;
+				bConsumed = true;
+				bResult = Tag.bSelfClosing || ParseTextureList(MatInfo);
+			}
+			break;
+		case EEluXmlTag::AMBIENT:
+		case EEluXmlTag::DIFFUSE:
+		case EEluXmlTag::SPECULAR:
+		{
+			bool& bFound = TagType == EEluXmlTag::AMBIENT ? bFoundAmbient : (TagType == EEluXmlTag::DIFFUSE ? bFoundDiffuse : bFoundSpecular);
+			if (!bFound)
+			{
+				bFound = true;
+				bConsumed = true;
+				bResult = ReadElementContent(Tag, Content);
+
+				FVector& Color = TagType == EEluXmlTag::AMBIENT ? MatInfo.Vector_Ambient : (TagType == EEluXmlTag::DIFFUSE ? MatInfo.Vector_Diffuse : MatInfo.Vector_Specular);
+				if (bResult && !FEluXmlMaterialParser::ParseColorTriplet(Content, Color))
+				{
+					LogMessage = FString("Expected 3 color values in `") + FEluXmlMaterialParser::SpanToString(Content) +
+						FString("`, keeping default color. Elu xml: ") + FilePath_EluXml;
+					UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+				}
+			}
+			break;
+		}
+		case EEluXmlTag::SPECULAR_LEVEL:
+		case EEluXmlTag::SELFILLUSIONSCALE:
+		case EEluXmlTag::GLOSSINESS:
+		{
+			bool& bFound = TagType == EEluXmlTag::SPECULAR_LEVEL ? bFoundSpecularLevel : (TagType == EEluXmlTag::SELFILLUSIONSCALE ? bFoundSelfIllusionScale : bFoundGlossiness);
+			if (!bFound)
+			{
+				bFound = true;
+				bConsumed = true;
+				bResult = ReadElementContent(Tag, Content);
+
+				float& Scalar = TagType == EEluXmlTag::SPECULAR_LEVEL ? MatInfo.Scalar_SpecularLevel : (TagType == EEluXmlTag::SELFILLUSIONSCALE ? MatInfo.Scalar_SelfIllusionScale : MatInfo.Scalar_Glossiness);
+				// Content is always followed by '<', so Atof can't read past it
+				Scalar = Content.Len > 0 ? FCStringAnsi::Atof(Content.Begin) : 0.f;
+			}
+			break;
+		}
+		case EEluXmlTag::TWOSIDED:
+			MatInfo.bMaterialType_TwoSided = true;
+			break;
+		case EEluXmlTag::USEOPACITY:
+			MatInfo.bOpacityBlendModel_Translucent = true;
+			break;
+		case EEluXmlTag::FAKE_SSS:
+			if (FilePath_EluXml.Contains("hf_face_"))
+			{
+				MatInfo.bMaterialType_HumanFace = true;
+			}
+			else
+			{
+				MatInfo.bMaterialType_HumanBody = true;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (!bConsumed && !Tag.bSelfClosing)
+		{
+			bResult = SkipElement();
+		}
+
+		if (!bResult)
+		{
+			return false;
+		}
+	}
+
+	return false;
+}
+
+bool FEluXmlMaterialParser::ParseTextureList(FEluMatInfo& MatInfo)
+{
+	FXmlTag Tag;
+
+	while (ReadNextTag(Tag))
+	{
+		if (Tag.bClosing)
+		{
+			return true;
+		}
+
+		EEluXmlTag TagType = ClassifyTag(Tag.Name, Tag.NameLen);
+
+		if (TagType == EEluXmlTag::TEXTURELAYER && !Tag.bSelfClosing)
+		{
+			if (!ParseTextureLayer(MatInfo))
+			{
+				return false;
+			}
+			continue;
+		}
+
+		if (TagType == EEluXmlTag::TEX_ANIMATION)
+		{
+			MatInfo.bAnimatedTexture_AllTextures = true;
+		}
+
+		if (!Tag.bSelfClosing && !SkipElement())
+		{
+			return false;
+		}
+	}
+
+	return false;
+}
+
+bool FEluXmlMaterialParser::ParseTextureLayer(FEluMatInfo& MatInfo)
+{
+	// Texture maps are collected first and applied once the layer ends, since a MAPCHANNEL node anywhere inside the layer discards it.
+	enum ELayerMap
+	{
+		LM_Diffuse,
+		LM_Specular,
+		LM_Normal,
+		LM_SelfIllumination,
+		LM_Opacity,
+		LM_Reflect,
+		LM_Gloss,
+		LM_SSSMask,
+		LM_Max
+	};
+
+	bool bFoundMaps[LM_Max] = {};
+	FXmlSpan MapContents[LM_Max];
+	bool bMapChannel = false;
+	bool bTexAnimation = false;
+	bool bLayerClosed = false;
+
+	FXmlTag Tag;
+
+	while (ReadNextTag(Tag))
+	{
+		if (Tag.bClosing)
+		{
+			bLayerClosed = true;
+			break;
+		}
+
+		int32 MapIndex = LM_Max;
+		switch (ClassifyTag(Tag.Name, Tag.NameLen))
+		{
+		case EEluXmlTag::MAPCHANNEL:
+			bMapChannel = true;
+			break;
+		case EEluXmlTag::TEX_ANIMATION:
+			bTexAnimation = true;
+			break;
+		case EEluXmlTag::DIFFUSEMAP:
+			MapIndex = LM_Diffuse;
+			break;
+		case EEluXmlTag::SPECULARMAP:
+			MapIndex = LM_Specular;
+			break;
+		case EEluXmlTag::NORMALMAP:
+			MapIndex = LM_Normal;
+			break;
+		case EEluXmlTag::SELFILLUMINATIONMAP:
+			MapIndex = LM_SelfIllumination;
+			break;
+		case EEluXmlTag::OPACITYMAP:
+			MapIndex = LM_Opacity;
+			break;
+		case EEluXmlTag::REFLECTMAP:
+			MapIndex = LM_Reflect;
+			break;
+		case EEluXmlTag::GLOSSINESS:
+			MapIndex = LM_Gloss;
+			break;
+		case EEluXmlTag::FAKE_SSS_MASK:
+			MapIndex = LM_SSSMask;
+			break;
+		default:
+			break;
+		}
+
+		bool bResult = true;
+		if (MapIndex != LM_Max && !bFoundMaps[MapIndex])
+		{
+			bFoundMaps[MapIndex] = true;
+			bResult = ReadElementContent(Tag, MapContents[MapIndex]);
+		}
+		else if (!Tag.bSelfClosing)
+		{
+			bResult = SkipElement();
+		}
+
+		if (!bResult)
+		{
+			return false;
+		}
+	}
+
+	if (!bLayerClosed)
+	{
+		return false;
+	}
+
+	if (bMapChannel)
+	{
+		// skip if MAPCHANNEL node is present
+		return true;
+	}
+
+	if (bFoundMaps[LM_Diffuse])
+	{
+		MatInfo.Texture_DiffuseMap = FName(*FEluXmlMaterialParser::GetTextureNameFromSpan(MapContents[LM_Diffuse]));
+		MatInfo.bAnimatedTexture_Diffuse |= bTexAnimation;
+	}
+
+	if (bFoundMaps[LM_Specular])
+	{
+		MatInfo.Texture_SpecularMap = FName(*FEluXmlMaterialParser::GetTextureNameFromSpan(MapContents[LM_Specular]));
+		MatInfo.bAnimatedTexture_Specular |= bTexAnimation;
+	}
+
+	if (bFoundMaps[LM_Normal])
+	{
+		MatInfo.Texture_NormalMap = FName(*FEluXmlMaterialParser::GetTextureNameFromSpan(MapContents[LM_Normal]));
+		MatInfo.bAnimatedTexture_Normal |= bTexAnimation;
+	}
+
+	if (bFoundMaps[LM_SelfIllumination])
+	{
+		MatInfo.Texture_SelfIlluminationMap = FName(*FEluXmlMaterialParser::GetTextureNameFromSpan(MapContents[LM_SelfIllumination]));
+		MatInfo.bAnimatedTexture_Glow |= bTexAnimation;
+	}
+
+	if (bFoundMaps[LM_Opacity])
+	{
+		FString OpacityMapName = FEluXmlMaterialParser::GetTextureNameFromSpan(MapContents[LM_Opacity]);
+		MatInfo.Texture_OpacityMap = FName(*OpacityMapName);
+
+		if (OpacityMapName.EndsWith(TEXT("_m")) || OpacityMapName.EndsWith(TEXT("_M")) ||
+			OpacityMapName.EndsWith(TEXT("_s")))
+		{
+			MatInfo.bOpacityMaskChannel_Alpha = false;
+		}
+
+		MatInfo.bAnimatedTexture_Opacity |= bTexAnimation;
+	}
+
+	if (bFoundMaps[LM_Reflect])
+	{
+		MatInfo.Texture_ReflectMap = FName(*FEluXmlMaterialParser::GetTextureNameFromSpan(MapContents[LM_Reflect]));
+	}
+
+	if (bFoundMaps[LM_Gloss])
+	{
+		MatInfo.Texture_GlossMap = FName(*FEluXmlMaterialParser::GetTextureNameFromSpan(MapContents[LM_Gloss]));
+	}
+
+	if (bFoundMaps[LM_SSSMask])
+	{
+		MatInfo.Texture_SSSMask = FName(*FEluXmlMaterialParser::GetTextureNameFromSpan(MapContents[LM_SSSMask]));
+	}
+
+	return true;
+}
+
+FEluXmlMaterialParser::FXmlSpan FEluXmlMaterialParser::FindAttribute(const FXmlTag& Tag, const ANSICHAR* AttributeName)
+{
+	FXmlSpan Value;
+	Value.Begin = Tag.Attributes;
+	Value.Len = 0;
+
+	const int32 AttributeNameLen = FCStringAnsi::Strlen(AttributeName);
+	const ANSICHAR* AttrCursor = Tag.Attributes;
+	const ANSICHAR* AttrEnd = Tag.Attributes + Tag.AttributesLen;
+
+	while (AttrCursor < AttrEnd)
+	{
+		while (AttrCursor < AttrEnd && IsXmlWhitespace(*AttrCursor))
+		{
+			AttrCursor++;
+		}
+
+		const ANSICHAR* NameBegin = AttrCursor;
+		while (AttrCursor < AttrEnd && *AttrCursor != '=' && !IsXmlWhitespace(*AttrCursor))
+		{
+			AttrCursor++;
+		}
+		const int32 NameLen = AttrCursor - NameBegin;
+
+		while (AttrCursor < AttrEnd && *AttrCursor != '"' && *AttrCursor != '\'')
+		{
+			AttrCursor++;
+		}
+		if (AttrCursor >= AttrEnd)
+		{
+			break;
+		}
+
+		const ANSICHAR Quote = *AttrCursor++;
+		const ANSICHAR* ValueBegin = AttrCursor;
+		while (AttrCursor < AttrEnd && *AttrCursor != Quote)
+		{
+			AttrCursor++;
+		}
+
+		if (NameLen == AttributeNameLen && FCStringAnsi::Strnicmp(NameBegin, AttributeName, NameLen) == 0)
+		{
+			Value.Begin = ValueBegin;
+			Value.Len = AttrCursor - ValueBegin;
+			return Value;
+		}
+
+		// Skip closing quote
+		AttrCursor++;
+	}
+
+	return Value;
+}
+
+FString FEluXmlMaterialParser::SpanToString(const FXmlSpan& Span)
+{
+	if (Span.Len <= 0)
+	{
+		return FString();
+	}
+
+	// Files without a byte order mark are treated as UTF-8, same as FFileHelper::LoadFileToString()
+	FUTF8ToTCHAR Converter(Span.Begin, Span.Len);
+	return FString(Converter.Length(), Converter.Get());
+}
+
+FString FEluXmlMaterialParser::GetTextureNameFromSpan(const FXmlSpan& Span)
+{
+	// Equivalent to UEluProcessor::GetTextureNameFromXmlNode(), i.e., "T_" + the first non empty '.' separated part of the content
+	const ANSICHAR* NameBegin = Span.Begin;
+	const ANSICHAR* SpanEnd = Span.Begin + Span.Len;
+
+	while (NameBegin < SpanEnd && *NameBegin == '.')
+	{
+		NameBegin++;
+	}
+
+	const ANSICHAR* NameEnd = NameBegin;
+	while (NameEnd < SpanEnd && *NameEnd != '.')
+	{
+		NameEnd++;
+	}
+
+	if (NameEnd == NameBegin)
+	{
+		return FString();
+	}
+
+	FXmlSpan NameSpan;
+	NameSpan.Begin = NameBegin;
+	NameSpan.Len = NameEnd - NameBegin;
+
+	return FString("T_") + ObjectTools::SanitizeObjectName(FEluXmlMaterialParser::SpanToString(NameSpan));
+}
+
+bool FEluXmlMaterialParser::ParseColorTriplet(const FXmlSpan& Span, FVector& OutColor)
+{
+	float Values[3];
+	int32 NumValues = 0;
+
+	const ANSICHAR* SpanCursor = Span.Begin;
+	const ANSICHAR* SpanEnd = Span.Begin + Span.Len;
+
+	while (SpanCursor < SpanEnd && NumValues < 3)
+	{
+		while (SpanCursor < SpanEnd && IsXmlWhitespace(*SpanCursor))
+		{
+			SpanCursor++;
+		}
+		if (SpanCursor >= SpanEnd)
+		{
+			break;
+		}
+
+		// Content is always followed by '<', so Atof can't read past the span
+		Values[NumValues++] = FCStringAnsi::Atof(SpanCursor);
+
+		while (SpanCursor < SpanEnd && !IsXmlWhitespace(*SpanCursor))
+		{
+			SpanCursor++;
+		}
+	}
+
+	if (NumValues < 3)
+	{
+		return false;
+	}
+
+	OutColor = FVector(Values[0] / 255.f, Values[1] / 255.f, Values[2] / 255.f);
+	return true;
+}
+
+SIZE_T FEluXmlMaterialParser::GetMaterialTableAllocatedSize(const TMap<FString, FEluMatInfo>& Map_EluMatsInfo)
+{
+	// FEluMatInfo holds nothing on the heap since its textures are FNames, so only the map and the material names count
+	SIZE_T AllocatedSize = Map_EluMatsInfo.GetAllocatedSize();
+	for (const TPair<FString, FEluMatInfo>& EluMatInfoPair : Map_EluMatsInfo)
+	{
+		AllocatedSize += EluMatInfoPair.Key.GetAllocatedSize();
+	}
+
+	return AllocatedSize;
+}
+
+void FEluXmlMaterialParser::RunBenchmark(const TArray<FString>& FilePaths_EluXml, int32 NumIterations)
+{
+	FString LogMessage;
+
+	int64 TotalBytes = 0;
+	double TotalSeconds_Dom = 0.0;
+	double TotalSeconds_Streaming = 0.0;
+	int32 NumMismatches = 0;
+	int32 NumMaterials = 0;
+	SIZE_T TotalTableBytes = 0;
+	int64 TotalUsedPhysicalDelta_Dom = 0;
+	int64 TotalUsedPhysicalDelta_Streaming = 0;
+
+	NumIterations = FMath::Max(NumIterations, 1);
+
+	for (const FString& FilePath_EluXml : FilePaths_EluXml)
+	{
+		TMap<FString, FEluMatInfo> Map_EluMatsInfo_Dom;
+		TMap<FString, FEluMatInfo> Map_EluMatsInfo_Streaming;
+
+		// Process memory is coarse and shared with the rest of the editor, so it only tells about large regressions. The material table size is exact
+		int64 UsedPhysical = (int64)FPlatformMemory::GetStats().UsedPhysical;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+		{
+			Map_EluMatsInfo_Dom.Reset();
+			UEluProcessor::ParseEluXmlForMaterialsWithDom(FilePath_EluXml, Map_EluMatsInfo_Dom);
+		}
+		double Seconds_Dom = FPlatformTime::Seconds() - StartTime;
+		TotalUsedPhysicalDelta_Dom += (int64)FPlatformMemory::GetStats().UsedPhysical - UsedPhysical;
+
+		int64 FileSize = 0;
+		UsedPhysical = (int64)FPlatformMemory::GetStats().UsedPhysical;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+		{
+			Map_EluMatsInfo_Streaming.Reset();
+			FEluXmlMaterialParser Parser;
+			if (Parser.LoadFile(FilePath_EluXml))
+			{
+				FileSize = Parser.GetFileSize();
+				Parser.Parse(Map_EluMatsInfo_Streaming);
+			}
+		}
+		double Seconds_Streaming = FPlatformTime::Seconds() - StartTime;
+		TotalUsedPhysicalDelta_Streaming += (int64)FPlatformMemory::GetStats().UsedPhysical - UsedPhysical;
+
+		SIZE_T TableBytes = FEluXmlMaterialParser::GetMaterialTableAllocatedSize(Map_EluMatsInfo_Streaming);
+
+		// Both parsers must produce the exact same material table
+		bool bSameResult = Map_EluMatsInfo_Dom.Num() == Map_EluMatsInfo_Streaming.Num();
+		for (TPair<FString, FEluMatInfo>& EluMatInfoPair : Map_EluMatsInfo_Dom)
+		{
+			FEluMatInfo* StreamingMatInfo = bSameResult ? Map_EluMatsInfo_Streaming.Find(EluMatInfoPair.Key) : nullptr;
+			if (!StreamingMatInfo)
+			{
+				bSameResult = false;
+				break;
+			}
+
+			TArray<uint8> Bytes_Dom;
+			TArray<uint8> Bytes_Streaming;
+			FMemoryWriter Writer_Dom(Bytes_Dom);
+			FMemoryWriter Writer_Streaming(Bytes_Streaming);
+			Writer_Dom << EluMatInfoPair.Value;
+			Writer_Streaming << *StreamingMatInfo;
+
+			if (Bytes_Dom != Bytes_Streaming)
+			{
+				bSameResult = false;
+				break;
+			}
+		}
+
+		if (!bSameResult)
+		{
+			NumMismatches++;
+			LogMessage = FString("Streaming and DOM parsers disagree on elu xml: ") + FilePath_EluXml;
+			UE_LOG(LogTemp, Warning, TEXT("%s"), *LogMessage);
+		}
+
+		LogMessage = FString::Printf(TEXT("%s (%lld bytes, %d materials, %llu bytes of material table): DOM %.3f ms, streaming %.3f ms"),
+									 *FilePath_EluXml, FileSize, Map_EluMatsInfo_Dom.Num(), (uint64)TableBytes,
+									 Seconds_Dom * 1000.0 / NumIterations, Seconds_Streaming * 1000.0 / NumIterations);
+		UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+		NumMaterials += Map_EluMatsInfo_Streaming.Num();
+		TotalTableBytes += TableBytes;
+		TotalBytes += FileSize;
+		TotalSeconds_Dom += Seconds_Dom;
+		TotalSeconds_Streaming += Seconds_Streaming;
+	}
+
+	const double TotalMegaBytes = (double)TotalBytes * NumIterations / (1024.0 * 1024.0);
+
+	LogMessage = FString::Printf(TEXT("Elu xml parser benchmark over %d files x %d iterations: DOM %.2f MB/s, streaming %.2f MB/s, speedup %.2fx, mismatches: %d"),
+								 FilePaths_EluXml.Num(), NumIterations,
+								 TotalSeconds_Dom > 0.0 ? TotalMegaBytes / TotalSeconds_Dom : 0.0,
+								 TotalSeconds_Streaming > 0.0 ? TotalMegaBytes / TotalSeconds_Streaming : 0.0,
+								 TotalSeconds_Streaming > 0.0 ? TotalSeconds_Dom / TotalSeconds_Streaming : 0.0,
+								 NumMismatches);
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+
+	// Every copy of a material table (per mesh, per cache hit) costs its allocated size, so this is what the FEluMatInfo layout is measured by
+	FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	LogMessage = FString::Printf(TEXT("Elu xml parser memory: sizeof(FEluMatInfo) %d bytes, %d materials in %llu bytes of material tables (%.1f bytes per material), used physical delta DOM %lld KB, streaming %lld KB, peak used physical %llu MB"),
+								 (int32)sizeof(FEluMatInfo), NumMaterials, (uint64)TotalTableBytes,
+								 NumMaterials > 0 ? (double)TotalTableBytes / NumMaterials : 0.0,
+								 TotalUsedPhysicalDelta_Dom / 1024, TotalUsedPhysicalDelta_Streaming / 1024,
+								 (uint64)MemoryStats.PeakUsedPhysical / (1024 * 1024));
+	UE_LOG(LogTemp, Log, TEXT("%s"), *LogMessage);
+}
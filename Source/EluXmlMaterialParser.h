@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/MemStack.h"
+
+struct FEluMatInfo;
+
+
+/**
+ * Forward-only elu.xml material parser. Only MATERIALLIST/MATERIAL/TEXTURELIST subtrees are inspected,
+ * everything else is skipped without being tokenized into nodes.
+ * The file is read into the calling thread's FMemStack, and released when the parser goes out of scope.
+ */
+class RAIDERZASSETS_API FEluXmlMaterialParser
+{
+public:
+
+	FEluXmlMaterialParser();
+
+	bool LoadFile(const FString& InFilePath_EluXml);
+
+	const uint8* GetFileData() const;
+
+	int64 GetFileSize() const;
+
+	bool Parse(TMap<FString, FEluMatInfo>& OutMap_EluMatsInfo);
+
+	/** Heap bytes held by a material table, i.e., what each copy of it costs */
+	static SIZE_T GetMaterialTableAllocatedSize(const TMap<FString, FEluMatInfo>& Map_EluMatsInfo);
+
+	static void RunBenchmark(const TArray<FString>& FilePaths_EluXml, int32 NumIterations);
+
+private:
+
+	struct FXmlTag
+	{
+		const ANSICHAR* Name;
+		int32 NameLen;
+		const ANSICHAR* Attributes;
+		int32 AttributesLen;
+		bool bClosing;
+		bool bSelfClosing;
+	};
+
+	struct FXmlSpan
+	{
+		const ANSICHAR* Begin;
+		int32 Len;
+	};
+
+	FMemMark ArenaMark;
+
+	FString FilePath_EluXml;
+
+	const uint8* FileData;
+
+	int64 FileSize;
+
+	const ANSICHAR* Cursor;
+
+	const ANSICHAR* End;
+
+	bool bUtf16;
+
+	bool ReadNextTag(FXmlTag& OutTag, FXmlSpan* OutText = nullptr);
+
+	bool SkipElement();
+
+	bool ReadElementContent(const FXmlTag& OpenTag, FXmlSpan& OutContent);
+
+	bool ParseMaterialList(TMap<FString, FEluMatInfo>& OutMap_EluMatsInfo);
+
+	bool ParseMaterial(FEluMatInfo& MatInfo);
+
+	bool ParseTextureList(FEluMatInfo& MatInfo);
+
+	bool ParseTextureLayer(FEluMatInfo& MatInfo);
+
+	static FXmlSpan FindAttribute(const FXmlTag& Tag, const ANSICHAR* AttributeName);
+
+	static FString SpanToString(const FXmlSpan& Span);
+
+	static FString GetTextureNameFromSpan(const FXmlSpan& Span);
+
+	static bool ParseColorTriplet(const FXmlSpan& Span, FVector& OutColor);
+
+};